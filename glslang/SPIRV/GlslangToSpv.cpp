@@ -53,6 +53,8 @@ namespace spv {
 #include "../glslang/MachineIndependent/SymbolTable.h"
 #include "../glslang/Include/Common.h"
 #include "../glslang/Include/revision.h"
+#include "../glslang/Include/InitializeGlobals.h"
+#include "../glslang/OSDependent/osinclude.h"
 
 #include <fstream>
 #include <iomanip>
@@ -111,8 +113,10 @@ public:
     bool visitBranch(glslang::TVisit visit, glslang::TIntermBranch*);
 
     void dumpSpv(std::vector<unsigned int>& out);
+    bool dumpSpv(const std::function<unsigned int*(size_t)>& allocate);
 
 protected:
+    void finishSpv();
     spv::Decoration TranslateAuxiliaryStorageDecoration(const glslang::TQualifier& qualifier);
     spv::BuiltIn TranslateBuiltInDecoration(glslang::TBuiltInVariable, bool memberDeclaration);
     spv::ImageFormat TranslateImageFormat(const glslang::TType& type);
@@ -830,17 +834,38 @@ TGlslangToSpvTraverser::TGlslangToSpvTraverser(const glslang::TIntermediate* gls
 
 }
 
-// Finish everything and dump
-void TGlslangToSpvTraverser::dumpSpv(std::vector<unsigned int>& out)
+// Finish everything before dumping
+void TGlslangToSpvTraverser::finishSpv()
 {
     // finish off the entry-point SPV instruction by adding the Input/Output <id>
     for (auto it = iOSet.cbegin(); it != iOSet.cend(); ++it)
         entryPoint->addIdOperand(*it);
 
     builder.eliminateDeadDecorations();
+}
+
+// Finish everything and dump
+void TGlslangToSpvTraverser::dumpSpv(std::vector<unsigned int>& out)
+{
+    finishSpv();
     builder.dump(out);
 }
 
+// Finish everything and dump into memory from 'allocate', sized to fit.
+// Returns false if 'allocate' returned nullptr.
+bool TGlslangToSpvTraverser::dumpSpv(const std::function<unsigned int*(size_t)>& allocate)
+{
+    finishSpv();
+
+    const size_t size = builder.getDumpSize();
+    unsigned int* out = allocate(size);
+    if (out == nullptr)
+        return false;
+
+    builder.dump(out, size);
+    return true;
+}
+
 TGlslangToSpvTraverser::~TGlslangToSpvTraverser()
 {
     if (! mainTerminated) {
@@ -4756,6 +4781,57 @@ spv::Id TGlslangToSpvTraverser::getExtBuiltins(const char* name)
     }
 }
 
+// Walks the tree only to find its depth; the traversal engine doesn't recurse, so this
+// is safe on a tree of any depth.
+class TDepthTraverser : public glslang::TIntermTraverser {
+};
+
+// The translation recurses through the visit functions, using up to about this much stack
+// per level of the tree (an optimized build uses about a quarter of it).  A tree deeper than
+// DeepTreeDepth is translated on a thread of its own, with a stack sized for it, as the
+// caller's stack might not be big enough.
+const size_t StackPerTreeLevel = 2 * 1024;
+const size_t StackBase = 1024 * 1024;
+const int DeepTreeDepth = 256;
+
+struct TDeepTranslation {
+    TIntermNode* root;
+    TGlslangToSpvTraverser* traverser;
+    glslang::TPoolAllocator* pool;
+};
+
+// Runs on the thread translating a deep tree.  It allocates from the caller's pool, which
+// the caller leaves alone until the translation is done.
+void TranslateDeepTree(void* data)
+{
+    TDeepTranslation& translation = *static_cast<TDeepTranslation*>(data);
+
+    glslang::InitializeMemoryPools();
+    glslang::TPoolAllocator& threadPool = glslang::GetThreadPoolAllocator();
+    glslang::SetThreadPoolAllocator(*translation.pool);
+
+    translation.root->traverse(translation.traverser);
+
+    glslang::SetThreadPoolAllocator(threadPool);
+    glslang::FreeGlobalPools();
+}
+
+// Translate the tree into the traverser's module.
+void Translate(TIntermNode* root, TGlslangToSpvTraverser& traverser)
+{
+    TDepthTraverser depthTraverser;
+    root->traverse(&depthTraverser);
+
+    const int depth = depthTraverser.getMaxDepth();
+    if (depth > DeepTreeDepth) {
+        TDeepTranslation translation = { root, &traverser, &glslang::GetThreadPoolAllocator() };
+        if (glslang::OS_RunWithStack(TranslateDeepTree, &translation, StackBase + depth * StackPerTreeLevel))
+            return;
+    }
+
+    root->traverse(&traverser);
+}
+
 };  // end anonymous namespace
 
 namespace glslang {
@@ -4821,11 +4897,37 @@ void GlslangToSpv(const glslang::TIntermediate& intermediate, std::vector<unsign
 
     TGlslangToSpvTraverser it(&intermediate, logger);
 
-    root->traverse(&it);
+    Translate(root, it);
 
     it.dumpSpv(spirv);
 
     glslang::GetThreadPoolAllocator().pop();
 }
 
+//
+// Like the above, but rather than appending to a vector, sizes the module and writes it
+// straight into the buffer returned by allocate(wordCount).  Returns false if there was no
+// tree to translate, or allocate() returned nullptr.
+//
+bool GlslangToSpv(const glslang::TIntermediate& intermediate, const std::function<unsigned int*(size_t)>& allocate,
+                  spv::SpvBuildLogger* logger)
+{
+    TIntermNode* root = intermediate.getTreeRoot();
+
+    if (root == 0)
+        return false;
+
+    glslang::GetThreadPoolAllocator().push();
+
+    TGlslangToSpvTraverser it(&intermediate, logger);
+
+    Translate(root, it);
+
+    const bool written = it.dumpSpv(allocate);
+
+    glslang::GetThreadPoolAllocator().pop();
+
+    return written;
+}
+
 }; // end namespace glslang
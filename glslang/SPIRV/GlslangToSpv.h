@@ -34,6 +34,7 @@
 
 #include "../glslang/Include/intermediate.h"
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,8 @@ namespace glslang {
 void GetSpirvVersion(std::string&);
 void GlslangToSpv(const glslang::TIntermediate& intermediate, std::vector<unsigned int>& spirv);
 void GlslangToSpv(const glslang::TIntermediate& intermediate, std::vector<unsigned int>& spirv, spv::SpvBuildLogger* logger);
+bool GlslangToSpv(const glslang::TIntermediate& intermediate, const std::function<unsigned int*(size_t)>& allocate,
+                  spv::SpvBuildLogger* logger);
 void OutputSpvBin(const std::vector<unsigned int>& spirv, const char* baseName);
 void OutputSpvHex(const std::vector<unsigned int>& spirv, const char* baseName);
 
@@ -147,11 +147,10 @@ namespace spv {
     // returns its size in 32-bit words.
     unsigned spirvbin_t::idTypeSizeInWords(spv::Id id) const
     {
-        const auto tid_it = idTypeSizeMap.find(id);
-        if (tid_it == idTypeSizeMap.end())
+        if (id >= idTypeSizeMap.size() || idTypeSizeMap[id] == 0)
             error("type size for ID not found");
 
-        return tid_it->second;
+        return idTypeSizeMap[id];
     }
 
     // Is this an opcode we should remove when using --strip?
@@ -236,10 +235,28 @@ namespace spv {
     const spv::Id spirvbin_t::unused      = spv::Id(-10001);
     const int     spirvbin_t::header_size = 5;
 
+    const std::uint32_t spirvbin_t::softTypeIdLimit = 3011; // small prime.  TODO: get from options
+    const std::uint32_t spirvbin_t::firstMappedID   = 8;    // offset into ID space
+
     spv::Id spirvbin_t::nextUnusedId(spv::Id id)
     {
-        while (isNewIdMapped(id))  // search for an unused ID
-            ++id;
+        // Search for an unused ID a bitset word at a time: large modules hash
+        // many IDs into the same small range, leaving long runs of mapped IDs.
+        static const bits_t wordMask = (bits_t(1) << mBits) - 1;
+
+        while (id < maxMappedId()) {
+            bits_t unmappedBits = ~(mapped[id/mBits] >> (id%mBits)) & (wordMask >> (id%mBits));
+
+            if (unmappedBits != 0) {
+                while ((unmappedBits & 1) == 0) {
+                    unmappedBits >>= 1;
+                    ++id;
+                }
+                return id;
+            }
+
+            id = (id/mBits + 1) * mBits; // start of next word
+        }
 
         return id;
     }
@@ -351,21 +368,30 @@ namespace spv {
         idMapL.clear();
 //      preserve nameMap, so we don't clear that.
         fnPos.clear();
-        fnPosDCE.clear();
+        fnIds.clear();
         fnCalls.clear();
+        instPos.clear();
         typeConstPos.clear();
         idPosR.clear();
         entryPoint = spv::NoResult;
         largestNewId = 0;
 
         idMapL.resize(bound(), unused);
+        fnPos.resize(bound(), range_t(0, 0));
+        fnCalls.resize(bound(), 0);
+        idPosR.resize(bound(), 0);
+        idTypeSizeMap.resize(bound(), 0); // preserved, like nameMap: strip() doesn't renumber
 
         int         fnStart = 0;
         spv::Id     fnRes   = spv::NoResult;
 
-        // build local Id and name maps
+        instPos.reserve(unsigned(spv.size()) / 4); // initial estimate; can grow if needed.
+
+        // build local Id and name maps, and the instruction table used by later passes
         process(
             [&](spv::Op opCode, unsigned start) {
+                instPos.push_back(start);
+
                 // remember opcodes we want to strip later
                 if ((options & STRIP) && isStripOp(opCode))
                     stripInst(start);
@@ -379,6 +405,8 @@ namespace spv {
                 // If there's a result ID, remember the size of its type
                 if (spv::InstructionDesc[opCode].hasResult()) {
                     const spv::Id resultId = asId(word++);
+                    if (resultId >= bound())
+                        error(std::string("ID out of bounds: ") + std::to_string(resultId));
                     idPosR[resultId] = start;
                     
                     if (typeId != spv::NoResult) {
@@ -395,6 +423,8 @@ namespace spv {
                     nameMap[name] = target;
 
                 } else if (opCode == spv::Op::OpFunctionCall) {
+                    if (asId(start + 3) >= bound())
+                        error(std::string("ID out of bounds: ") + std::to_string(asId(start + 3)));
                     ++fnCalls[asId(start + 3)];
                 } else if (opCode == spv::Op::OpEntryPoint) {
                     entryPoint = asId(start + 2);
@@ -408,19 +438,25 @@ namespace spv {
                     if (fnStart == 0)
                         error("function end without function start");
                     fnPos[fnRes] = range_t(fnStart, start + asWordCount(start));
+                    fnIds.push_back(fnRes);
                     fnStart = 0;
                 } else if (isConstOp(opCode)) {
                     assert(asId(start + 2) != spv::NoResult);
-                    typeConstPos.insert(start);
+                    typeConstPos.push_back(start);
                 } else if (isTypeOp(opCode)) {
                     assert(asId(start + 1) != spv::NoResult);
-                    typeConstPos.insert(start);
+                    typeConstPos.push_back(start);
                 }
 
                 return false;
             },
 
-            [this](spv::Id& id) { localId(id, unmapped); }
+            [this](spv::Id& id) {
+                // the per-ID vectors rely on this
+                if (id >= bound())
+                    error(std::string("ID out of bounds: ") + std::to_string(id));
+                localId(id, unmapped);
+            }
         );
     }
 
@@ -444,7 +480,8 @@ namespace spv {
     }
 
 
-    int spirvbin_t::processInstruction(unsigned word, instfn_t instFn, idfn_t idFn)
+    template <class InstFn, class IdFn>
+    int spirvbin_t::processInstruction(unsigned word, InstFn& instFn, IdFn& idFn)
     {
         const auto     instructionStart = word;
         const unsigned wordCount = asWordCount(instructionStart);
@@ -586,7 +623,8 @@ namespace spv {
     }
 
     // Make a pass over all the instructions and process them given appropriate functions
-    spirvbin_t& spirvbin_t::process(instfn_t instFn, idfn_t idFn, unsigned begin, unsigned end)
+    template <class InstFn, class IdFn>
+    spirvbin_t& spirvbin_t::process(InstFn instFn, IdFn idFn, unsigned begin, unsigned end)
     {
         // For efficiency, reserve name map space.  It can grow if needed.
         nameMap.reserve(32);
@@ -630,13 +668,9 @@ namespace spv {
         // hash values.
 
         spv::Id               fnId       = spv::NoResult;
-        std::vector<unsigned> instPos;
-        instPos.reserve(unsigned(spv.size()) / 16); // initial estimate; can grow if needed.
 
-        // Build local table of instruction start positions
-        process(
-            [&](spv::Op, unsigned start) { instPos.push_back(start); return true; },
-            op_fn_nop);
+        // The table of instruction start positions comes from buildLocalMaps: nothing has
+        // been stripped since.
 
         // Window size for context-sensitive canonicalization values
         // Empirical best size from a single data set.  TODO: Would be a good tunable.
@@ -946,37 +980,35 @@ namespace spv {
         while (changed) {
             changed = false;
 
-            for (auto fn = fnPos.begin(); fn != fnPos.end(); ) {
-                if (fn->first == entryPoint) { // don't DCE away the entry point!
+            for (auto fn = fnIds.begin(); fn != fnIds.end(); ) {
+                if (*fn == entryPoint) { // don't DCE away the entry point!
                     ++fn;
                     continue;
                 }
 
-                const auto call_it = fnCalls.find(fn->first);
+                if (fnCalls[*fn] <= 0) {
+                    const range_t range = fnPos[*fn];
 
-                if (call_it == fnCalls.end() || call_it->second == 0) {
                     changed = true;
-                    stripRange.push_back(fn->second);
-                    fnPosDCE.insert(*fn);
+                    stripRange.push_back(range);
 
                     // decrease counts of called functions
                     process(
                         [&](spv::Op opCode, unsigned start) {
                             if (opCode == spv::Op::OpFunctionCall) {
-                                const auto call_it = fnCalls.find(asId(start + 3));
-                                if (call_it != fnCalls.end()) {
-                                    if (--call_it->second <= 0)
-                                        fnCalls.erase(call_it);
-                                }
+                                int& calls = fnCalls[asId(start + 3)];
+                                if (calls > 0)
+                                    --calls;
                             }
 
                             return true;
                         },
                         op_fn_nop,
-                        fn->second.first,
-                        fn->second.second);
+                        range.first,
+                        range.second);
 
-                    fn = fnPos.erase(fn);
+                    fnPos[*fn] = range_t(0, 0);
+                    fn = fnIds.erase(fn);
                 } else ++fn;
             }
         }
@@ -987,7 +1019,7 @@ namespace spv {
     {
         msg(3, 2, std::string("DCE Vars: "));
 
-        std::unordered_map<spv::Id, int> varUseCount;
+        std::vector<int> varUseCount(bound(), 0);
 
         // Count function variable use
         process(
@@ -1030,30 +1062,39 @@ namespace spv {
         for (const auto typeStart : typeConstPos)
             isType[asTypeConstId(typeStart)] = true;
 
-        std::unordered_map<spv::Id, int> typeUseCount;
+        std::vector<int> typeUseCount(bound(), 0);
 
-        // This is not the most efficient algorithm, but this is an offline tool, and
-        // it's easy to write this way.  Can be improved opportunistically if needed.
-        bool changed = true;
-        while (changed) {
-            changed = false;
-            strip();
-            typeUseCount.clear();
+        strip();
 
-            // Count total type usage
-            process(inst_fn_nop,
-                    [&](spv::Id& id) { if (isType[id]) ++typeUseCount[id]; }
-                    );
+        // Count total type usage, once: removing a type then only needs to
+        // account for the references its own definition made.
+        process(inst_fn_nop,
+                [&](spv::Id& id) { if (isType[id]) ++typeUseCount[id]; }
+                );
 
-            // Remove single reference types
-            for (const auto typeStart : typeConstPos) {
-                const spv::Id typeId = asTypeConstId(typeStart);
-                if (typeUseCount[typeId] == 1) {
-                    changed = true;
-                    --typeUseCount[typeId];
-                    stripInst(typeStart);
-                }
-            }
+        // Remove single reference types (just the definition), and any types
+        // that leaves with a single reference in turn
+        std::vector<unsigned> deadTypes;
+
+        for (const auto typeStart : typeConstPos) {
+            if (typeUseCount[asTypeConstId(typeStart)] == 1)
+                deadTypes.push_back(typeStart);
+        }
+
+        while (!deadTypes.empty()) {
+            const unsigned typeStart = deadTypes.back();
+            const spv::Id  typeId    = asTypeConstId(typeStart);
+            deadTypes.pop_back();
+
+            --typeUseCount[typeId];
+            stripInst(typeStart);
+
+            process(inst_fn_nop,
+                    [&](spv::Id& id) {
+                        if (id != typeId && isType[id] && --typeUseCount[id] == 1)
+                            deadTypes.push_back(idPos(id));
+                    },
+                    typeStart, typeStart + asWordCount(typeStart));
         }
     }
 
@@ -1133,11 +1174,10 @@ namespace spv {
     // Return start position in SPV of given Id.  error if not found.
     unsigned spirvbin_t::idPos(spv::Id id) const
     {
-        const auto tid_it = idPosR.find(id);
-        if (tid_it == idPosR.end())
+        if (id >= idPosR.size() || idPosR[id] == 0)
             error("ID not found");
 
-        return tid_it->second;
+        return idPosR[id];
     }
 
     // Hash types to canonical values.  This can return ID collisions (it's a bit
@@ -1227,8 +1267,17 @@ namespace spv {
 
         msg(3, 2, std::string("Remapping Consts & Types: "));
 
-        static const std::uint32_t softTypeIdLimit = 3011; // small prime.  TODO: get from options
-        static const std::uint32_t firstMappedID   = 8;    // offset into ID space
+        // Shared IDs first, so hash collisions below can't take them.  Only the first of several
+        // types with the same hash gets the shared ID.
+        if (canonicalTypes != nullptr) {
+            for (auto& typeStart : typeConstPos) {
+                const spv::Id resId = asTypeConstId(typeStart);
+                const spv::Id newId = canonicalTypes->find(hashType(typeStart));
+
+                if (newId != spv::NoResult && isOldIdUnmapped(resId) && !isNewIdMapped(newId))
+                    localId(resId, newId);
+            }
+        }
 
         for (auto& typeStart : typeConstPos) {
             const spv::Id       resId     = asTypeConstId(typeStart);
@@ -1281,6 +1330,12 @@ namespace spv {
 
         msg(3, 4, std::string("ID bound: ") + std::to_string(bound()));
 
+        reduce();
+        mapIds();
+    }
+
+    void spirvbin_t::reduce()
+    {
         strip();        // strip out data we decided to eliminate
         if (options & OPT_LOADSTORE) optLoadStore();
         if (options & OPT_FWD_LS)    forwardLoadStores();
@@ -1288,7 +1343,10 @@ namespace spv {
         if (options & DCE_VARS)      dceVars();
         if (options & DCE_TYPES)     dceTypes();
         strip();        // strip out data we decided to eliminate
+    }
 
+    void spirvbin_t::mapIds()
+    {
         if (options & MAP_TYPES)     mapTypeConst();
         if (options & MAP_NAMES)     mapNames();
         if (options & MAP_FUNCS)     mapFnBodies();
@@ -1305,6 +1363,63 @@ namespace spv {
         spv.swap(in_spv);
     }
 
+    // shared type remapping, pass 1
+    std::vector<std::uint32_t> spirvbin_t::reduce(std::vector<std::uint32_t>& in_spv, std::uint32_t opts)
+    {
+        spv.swap(in_spv);
+
+        options = opts;
+        spv::Parameterize();
+
+        validate();
+        buildLocalMaps();
+        reduce();
+
+        std::vector<std::uint32_t> hashes;
+        if (options & MAP_TYPES) {
+            hashes.reserve(typeConstPos.size());
+            for (auto& typeStart : typeConstPos)
+                hashes.push_back(hashType(typeStart));
+        }
+
+        spv.swap(in_spv);
+        return hashes;
+    }
+
+    // shared type remapping, pass 2
+    void spirvbin_t::remap(std::vector<std::uint32_t>& in_spv, const canonicaltypes_t& types)
+    {
+        spv.swap(in_spv);
+
+        canonicalTypes = &types;
+        mapIds();
+        canonicalTypes = nullptr;
+
+        spv.swap(in_spv);
+    }
+
+    void spirvbin_t::canonicaltypes_t::add(const std::vector<std::uint32_t>& hashes)
+    {
+        for (const auto hash : hashes) {
+            if (ids.find(hash) != ids.end())
+                continue;
+
+            // same starting point as a single binary's mapTypeConst, probing past IDs already taken
+            spv::Id id = hash % softTypeIdLimit + firstMappedID;
+            while (used.find(id) != used.end())
+                ++id;
+
+            ids[hash] = id;
+            used.insert(id);
+        }
+    }
+
+    spv::Id spirvbin_t::canonicaltypes_t::find(std::uint32_t hash) const
+    {
+        const auto it = ids.find(hash);
+        return it == ids.end() ? spv::NoResult : it->second;
+    }
+
 } // namespace SPV
 
 #endif // defined (use_cpp11)
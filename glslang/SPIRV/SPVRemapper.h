@@ -110,11 +110,36 @@ namespace spv {
 class spirvbin_t : public spirvbin_base_t
 {
 public:
-   spirvbin_t(int verbose = 0) : entryPoint(spv::NoResult), largestNewId(0), verbose(verbose) { }
+   spirvbin_t(int verbose = 0) : entryPoint(spv::NoResult), largestNewId(0), verbose(verbose), canonicalTypes(nullptr) { }
    
    // remap on an existing binary in memory
    void remap(std::vector<std::uint32_t>& spv, std::uint32_t opts = DO_EVERYTHING);
 
+   // Canonical type & const IDs shared across a set of binaries, so that equal types & consts
+   // get equal IDs in every binary of the set.  IDs depend only on the order hashes are added,
+   // so add them in a fixed binary order for results that are stable across runs.
+   class canonicaltypes_t {
+   public:
+      // Assign IDs to any hashes not seen before, in order
+      void add(const std::vector<std::uint32_t>& hashes);
+
+      // Return the ID for a hash, or NoResult if it hasn't been added
+      spv::Id find(std::uint32_t hash) const;
+
+   private:
+      std::unordered_map<std::uint32_t, spv::Id> ids;
+      std::unordered_set<spv::Id>                used;
+   };
+
+   // Shared type remapping, pass 1: strip & DCE a binary as per opts (leaving its IDs as they
+   // are), and return the hashes of its remaining types & consts, for canonicaltypes_t::add.
+   std::vector<std::uint32_t> reduce(std::vector<std::uint32_t>& spv, std::uint32_t opts = DO_EVERYTHING);
+
+   // Shared type remapping, pass 2: map the IDs of the binary from pass 1, taking type & const
+   // IDs from canonicalTypes.  Must be called on the same spirvbin_t as pass 1, with the binary
+   // unchanged, since names seen before stripping are carried between the passes.
+   void remap(std::vector<std::uint32_t>& spv, const canonicaltypes_t& canonicalTypes);
+
    // Type for error/log handler functions
    typedef std::function<void(const std::string&)> errorfn_t;
    typedef std::function<void(const std::string&)> logfn_t;
@@ -134,6 +159,8 @@ private:
    typedef std::unordered_map<spv::Id, int>     blockmap_t;
 
    void remap(std::uint32_t opts = DO_EVERYTHING);
+   void reduce();  // strip & DCE per options
+   void mapIds();  // map & apply new IDs per options
 
    // Map of names to IDs
    typedef std::unordered_map<std::string, spv::Id> namemap_t;
@@ -141,6 +168,7 @@ private:
    typedef std::uint32_t spirword_t;
 
    typedef std::pair<unsigned, unsigned> range_t;
+   // Signatures of the callables given to process() and processInstruction()
    typedef std::function<void(spv::Id&)>                idfn_t;
    typedef std::function<bool(spv::Op, unsigned start)> instfn_t;
 
@@ -155,12 +183,16 @@ private:
    typedef std::vector<spirword_t>        typeentry_t;
    typedef std::map<spv::Id, typeentry_t> globaltypes_t;
 
-   // A set that preserves position order, and a reverse map
-   typedef std::set<int>                    posmap_t;
-   typedef std::unordered_map<spv::Id, int> posmap_rev_t;
+   // IDs are dense and below the header's ID bound, so per-ID data is kept in
+   // flat vectors indexed by ID rather than in hash maps.
+
+   // Positions in increasing order (they're gathered in a single forward walk),
+   // and a reverse map from IDs to positions (0 if the ID has no definition)
+   typedef std::vector<unsigned> posmap_t;
+   typedef std::vector<unsigned> posmap_rev_t;
 
-   // Maps and ID to the size of its base type, if known.
-   typedef std::unordered_map<spv::Id, unsigned> typesize_map_t;
+   // Maps an ID to the size of its base type, or 0 if unknown.
+   typedef std::vector<unsigned> typesize_map_t;
 
    // handle error
    void error(const std::string& txt) const { errorHandler(txt); }
@@ -215,14 +247,20 @@ private:
    bool isOldIdUnmapped(spv::Id oldId) const { return localId(oldId) == unmapped; }
    bool isOldIdUnused(spv::Id oldId)   const { return localId(oldId) == unused;   }
    bool isOldIdMapped(spv::Id oldId)   const { return !isOldIdUnused(oldId) && !isOldIdUnmapped(oldId); }
-   bool isFunction(spv::Id oldId)      const { return fnPos.find(oldId) != fnPos.end(); }
+   bool isFunction(spv::Id oldId)      const { return oldId < fnPos.size() && fnPos[oldId].second != 0; }
 
    // bool    matchType(const globaltypes_t& globalTypes, spv::Id lt, spv::Id gt) const;
    // spv::Id findType(const globaltypes_t& globalTypes, spv::Id lt) const;
    std::uint32_t hashType(unsigned typeStart) const;
 
-   spirvbin_t& process(instfn_t, idfn_t, unsigned begin = 0, unsigned end = 0);
-   int         processInstruction(unsigned word, instfn_t, idfn_t);
+   static const std::uint32_t softTypeIdLimit; // hashed type IDs start in [firstMappedID, firstMappedID+softTypeIdLimit)
+   static const std::uint32_t firstMappedID;
+
+   // Templated on the callables (see instfn_t, idfn_t) so they're inlined into the walk
+   template <class InstFn, class IdFn>
+   spirvbin_t& process(InstFn, IdFn, unsigned begin = 0, unsigned end = 0);
+   template <class InstFn, class IdFn>
+   int         processInstruction(unsigned word, InstFn&, IdFn&);
 
    void        validate() const;
    void        mapTypeConst();
@@ -260,14 +298,15 @@ private:
    // Note: avoiding brace initializers to please older versions os MSVC.
    void stripInst(unsigned start) { stripRange.push_back(range_t(start, start + asWordCount(start))); }
 
-   // Function start and end.  use unordered_map because we'll have
-   // many fewer functions than IDs.
-   std::unordered_map<spv::Id, range_t> fnPos;
-   std::unordered_map<spv::Id, range_t> fnPosDCE; // deleted functions
+   // Function start and end by ID ([0,0) if not a function), and the
+   // function IDs in module order.
+   std::vector<range_t> fnPos;
+   std::vector<spv::Id> fnIds;
 
    // Which functions are called, anywhere in the module, with a call count
-   std::unordered_map<spv::Id, int> fnCalls;
+   std::vector<int> fnCalls;
    
+   posmap_t       instPos;       // word positions of every instruction (ordered)
    posmap_t       typeConstPos;  // word positions that define types & consts (ordered)
    posmap_rev_t   idPosR;        // reverse map from IDs to positions
    typesize_map_t idTypeSizeMap; // maps each ID to its type size, if known.
@@ -284,6 +323,8 @@ private:
    std::uint32_t options;
    int           verbose;     // verbosity level
 
+   const canonicaltypes_t* canonicalTypes; // shared type & const IDs, if any
+
    static errorfn_t errorHandler;
    static logfn_t   logHandler;
 };
@@ -58,6 +58,7 @@ Builder::Builder(unsigned int magicNumber, SpvBuildLogger* buildLogger) :
     addressModel(AddressingModelLogical),
     memoryModel(MemoryModelGLSL450),
     builderNumber(magicNumber),
+    module(arena),
     buildPoint(0),
     uniqueId(0),
     mainFunction(0),
@@ -73,7 +74,7 @@ Builder::~Builder()
 
 Id Builder::import(const char* name)
 {
-    Instruction* import = new Instruction(getUniqueId(), NoType, OpExtInstImport);
+    Instruction* import = new (arena) Instruction(getUniqueId(), NoType, OpExtInstImport);
     import->addStringOperand(name);
     
     imports.push_back(std::unique_ptr<Instruction>(import));
@@ -85,7 +86,7 @@ Id Builder::makeVoidType()
 {
     Instruction* type;
     if (groupedTypes[OpTypeVoid].size() == 0) {
-        type = new Instruction(getUniqueId(), NoType, OpTypeVoid);
+        type = new (arena) Instruction(getUniqueId(), NoType, OpTypeVoid);
         groupedTypes[OpTypeVoid].push_back(type);
         constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
         module.mapInstruction(type);
@@ -99,7 +100,7 @@ Id Builder::makeBoolType()
 {
     Instruction* type;
     if (groupedTypes[OpTypeBool].size() == 0) {
-        type = new Instruction(getUniqueId(), NoType, OpTypeBool);
+        type = new (arena) Instruction(getUniqueId(), NoType, OpTypeBool);
         groupedTypes[OpTypeBool].push_back(type);
         constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
         module.mapInstruction(type);
@@ -113,7 +114,7 @@ Id Builder::makeSamplerType()
 {
     Instruction* type;
     if (groupedTypes[OpTypeSampler].size() == 0) {
-        type = new Instruction(getUniqueId(), NoType, OpTypeSampler);
+        type = new (arena) Instruction(getUniqueId(), NoType, OpTypeSampler);
         groupedTypes[OpTypeSampler].push_back(type);
         constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
         module.mapInstruction(type);
@@ -126,19 +127,17 @@ Id Builder::makeSamplerType()
 Id Builder::makePointer(StorageClass storageClass, Id pointee)
 {
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypePointer].size(); ++t) {
-        type = groupedTypes[OpTypePointer][t];
-        if (type->getImmediateOperand(0) == (unsigned)storageClass &&
-            type->getIdOperand(1) == pointee)
-            return type->getResultId();
-    }
+    Id operands[] = { (Id)storageClass, pointee };
+    Instruction* type = findUnique(OpTypePointer, NoType, operands, 2);
+    if (type)
+        return type->getResultId();
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypePointer);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypePointer);
     type->addImmediateOperand(storageClass);
     type->addIdOperand(pointee);
     groupedTypes[OpTypePointer].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -148,19 +147,17 @@ Id Builder::makePointer(StorageClass storageClass, Id pointee)
 Id Builder::makeIntegerType(int width, bool hasSign)
 {
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypeInt].size(); ++t) {
-        type = groupedTypes[OpTypeInt][t];
-        if (type->getImmediateOperand(0) == (unsigned)width &&
-            type->getImmediateOperand(1) == (hasSign ? 1u : 0u))
-            return type->getResultId();
-    }
+    Id operands[] = { (Id)width, hasSign ? 1u : 0u };
+    Instruction* type = findUnique(OpTypeInt, NoType, operands, 2);
+    if (type)
+        return type->getResultId();
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypeInt);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypeInt);
     type->addImmediateOperand(width);
     type->addImmediateOperand(hasSign ? 1 : 0);
     groupedTypes[OpTypeInt].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -182,17 +179,16 @@ Id Builder::makeIntegerType(int width, bool hasSign)
 Id Builder::makeFloatType(int width)
 {
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypeFloat].size(); ++t) {
-        type = groupedTypes[OpTypeFloat][t];
-        if (type->getImmediateOperand(0) == (unsigned)width)
-            return type->getResultId();
-    }
+    Id operands[] = { (Id)width };
+    Instruction* type = findUnique(OpTypeFloat, NoType, operands, 1);
+    if (type)
+        return type->getResultId();
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypeFloat);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypeFloat);
     type->addImmediateOperand(width);
     groupedTypes[OpTypeFloat].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -221,10 +217,11 @@ Id Builder::makeStructType(const std::vector<Id>& members, const char* name)
     // structs can be duplicated except for decorations.
 
     // not found, make it
-    Instruction* type = new Instruction(getUniqueId(), NoType, OpTypeStruct);
+    Instruction* type = new (arena) Instruction(getUniqueId(), NoType, OpTypeStruct);
     for (int op = 0; op < (int)members.size(); ++op)
         type->addIdOperand(members[op]);
     groupedTypes[OpTypeStruct].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
     addName(type->getResultId(), name);
@@ -237,16 +234,10 @@ Id Builder::makeStructType(const std::vector<Id>& members, const char* name)
 Id Builder::makeStructResultType(Id type0, Id type1)
 {
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypeStruct].size(); ++t) {
-        type = groupedTypes[OpTypeStruct][t];
-        if (type->getNumOperands() != 2)
-            continue;
-        if (type->getIdOperand(0) != type0 || 
-            type->getIdOperand(1) != type1)
-            continue;
+    Id operands[] = { type0, type1 };
+    Instruction* type = findUnique(OpTypeStruct, NoType, operands, 2);
+    if (type)
         return type->getResultId();
-    }
 
     // not found, make it
     std::vector<spv::Id> members;
@@ -259,19 +250,17 @@ Id Builder::makeStructResultType(Id type0, Id type1)
 Id Builder::makeVectorType(Id component, int size)
 {
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypeVector].size(); ++t) {
-        type = groupedTypes[OpTypeVector][t];
-        if (type->getIdOperand(0) == component &&
-            type->getImmediateOperand(1) == (unsigned)size)
-            return type->getResultId();
-    }
+    Id operands[] = { component, (Id)size };
+    Instruction* type = findUnique(OpTypeVector, NoType, operands, 2);
+    if (type)
+        return type->getResultId();
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypeVector);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypeVector);
     type->addIdOperand(component);
     type->addImmediateOperand(size);
     groupedTypes[OpTypeVector].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -285,19 +274,17 @@ Id Builder::makeMatrixType(Id component, int cols, int rows)
     Id column = makeVectorType(component, rows);
 
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypeMatrix].size(); ++t) {
-        type = groupedTypes[OpTypeMatrix][t];
-        if (type->getIdOperand(0) == column &&
-            type->getImmediateOperand(1) == (unsigned)cols)
-            return type->getResultId();
-    }
+    Id operands[] = { column, (Id)cols };
+    Instruction* type = findUnique(OpTypeMatrix, NoType, operands, 2);
+    if (type)
+        return type->getResultId();
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypeMatrix);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypeMatrix);
     type->addIdOperand(column);
     type->addImmediateOperand(cols);
     groupedTypes[OpTypeMatrix].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -313,19 +300,18 @@ Id Builder::makeArrayType(Id element, Id sizeId, int stride)
     Instruction* type;
     if (stride == 0) {
         // try to find existing type
-        for (int t = 0; t < (int)groupedTypes[OpTypeArray].size(); ++t) {
-            type = groupedTypes[OpTypeArray][t];
-            if (type->getIdOperand(0) == element &&
-                type->getIdOperand(1) == sizeId)
-                return type->getResultId();
-        }
+        Id operands[] = { element, sizeId };
+        type = findUnique(OpTypeArray, NoType, operands, 2);
+        if (type)
+            return type->getResultId();
     }
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypeArray);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypeArray);
     type->addIdOperand(element);
     type->addIdOperand(sizeId);
     groupedTypes[OpTypeArray].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -334,7 +320,7 @@ Id Builder::makeArrayType(Id element, Id sizeId, int stride)
 
 Id Builder::makeRuntimeArray(Id element)
 {
-    Instruction* type = new Instruction(getUniqueId(), NoType, OpTypeRuntimeArray);
+    Instruction* type = new (arena) Instruction(getUniqueId(), NoType, OpTypeRuntimeArray);
     type->addIdOperand(element);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
@@ -345,28 +331,19 @@ Id Builder::makeRuntimeArray(Id element)
 Id Builder::makeFunctionType(Id returnType, const std::vector<Id>& paramTypes)
 {
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypeFunction].size(); ++t) {
-        type = groupedTypes[OpTypeFunction][t];
-        if (type->getIdOperand(0) != returnType || (int)paramTypes.size() != type->getNumOperands() - 1)
-            continue;
-        bool mismatch = false;
-        for (int p = 0; p < (int)paramTypes.size(); ++p) {
-            if (paramTypes[p] != type->getIdOperand(p + 1)) {
-                mismatch = true;
-                break;
-            }
-        }
-        if (! mismatch)
-            return type->getResultId();
-    }
+    std::vector<Id> operands(1, returnType);
+    operands.insert(operands.end(), paramTypes.begin(), paramTypes.end());
+    Instruction* type = findUnique(OpTypeFunction, NoType, operands.data(), (int)operands.size());
+    if (type)
+        return type->getResultId();
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypeFunction);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypeFunction);
     type->addIdOperand(returnType);
     for (int p = 0; p < (int)paramTypes.size(); ++p)
         type->addIdOperand(paramTypes[p]);
     groupedTypes[OpTypeFunction].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -376,21 +353,13 @@ Id Builder::makeFunctionType(Id returnType, const std::vector<Id>& paramTypes)
 Id Builder::makeImageType(Id sampledType, Dim dim, bool depth, bool arrayed, bool ms, unsigned sampled, ImageFormat format)
 {
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypeImage].size(); ++t) {
-        type = groupedTypes[OpTypeImage][t];
-        if (type->getIdOperand(0) == sampledType &&
-            type->getImmediateOperand(1) == (unsigned int)dim &&
-            type->getImmediateOperand(2) == (  depth ? 1u : 0u) &&
-            type->getImmediateOperand(3) == (arrayed ? 1u : 0u) &&
-            type->getImmediateOperand(4) == (     ms ? 1u : 0u) &&
-            type->getImmediateOperand(5) == sampled &&
-            type->getImmediateOperand(6) == (unsigned int)format)
-            return type->getResultId();
-    }
+    Id operands[] = { sampledType, (Id)dim, depth ? 1u : 0u, arrayed ? 1u : 0u, ms ? 1u : 0u, sampled, (Id)format };
+    Instruction* type = findUnique(OpTypeImage, NoType, operands, 7);
+    if (type)
+        return type->getResultId();
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypeImage);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypeImage);
     type->addIdOperand(sampledType);
     type->addImmediateOperand(   dim);
     type->addImmediateOperand(  depth ? 1 : 0);
@@ -400,6 +369,7 @@ Id Builder::makeImageType(Id sampledType, Dim dim, bool depth, bool arrayed, boo
     type->addImmediateOperand((unsigned int)format);
 
     groupedTypes[OpTypeImage].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -451,18 +421,16 @@ Id Builder::makeImageType(Id sampledType, Dim dim, bool depth, bool arrayed, boo
 Id Builder::makeSampledImageType(Id imageType)
 {
     // try to find it
-    Instruction* type;
-    for (int t = 0; t < (int)groupedTypes[OpTypeSampledImage].size(); ++t) {
-        type = groupedTypes[OpTypeSampledImage][t];
-        if (type->getIdOperand(0) == imageType)
-            return type->getResultId();
-    }
+    Instruction* type = findUnique(OpTypeSampledImage, NoType, &imageType, 1);
+    if (type)
+        return type->getResultId();
 
     // not found, make it
-    type = new Instruction(getUniqueId(), NoType, OpTypeSampledImage);
+    type = new (arena) Instruction(getUniqueId(), NoType, OpTypeSampledImage);
     type->addIdOperand(imageType);
 
     groupedTypes[OpTypeSampledImage].push_back(type);
+    addUnique(type);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(type));
     module.mapInstruction(type);
 
@@ -586,36 +554,73 @@ Id Builder::getContainedTypeId(Id typeId) const
     return getContainedTypeId(typeId, 0);
 }
 
+// Hash of a type or constant instruction's opcode, type, and operands, for findUnique().
+size_t Builder::hashUnique(Op opcode, Id typeId, const Id* operands, int numOperands)
+{
+    size_t hash = opcode * 31 + typeId;
+    for (int op = 0; op < numOperands; ++op)
+        hash = hash * 1000003 ^ operands[op];
+
+    return hash;
+}
+
+// Find the first type or constant made with exactly this opcode, type, and operands,
+// or return nullptr if there isn't one.
+Instruction* Builder::findUnique(Op opcode, Id typeId, const Id* operands, int numOperands) const
+{
+    auto range = uniqueInstructions.equal_range(hashUnique(opcode, typeId, operands, numOperands));
+    for (auto it = range.first; it != range.second; ++it) {
+        Instruction* instruction = it->second;
+        if (instruction->getOpCode() != opcode ||
+            instruction->getTypeId() != typeId ||
+            instruction->getNumOperands() != numOperands)
+            continue;
+
+        bool mismatch = false;
+        for (int op = 0; op < numOperands; ++op) {
+            if (instruction->getIdOperand(op) != operands[op]) {
+                mismatch = true;
+                break;
+            }
+        }
+        if (! mismatch)
+            return instruction;
+    }
+
+    return nullptr;
+}
+
+// Make a type or constant findable by findUnique(), unless an identical one already is
+// (types and constants that are deliberately not shared, like decorated structs and
+// specialization constants, are still made, but lookups keep finding the first one).
+void Builder::addUnique(Instruction* instruction)
+{
+    std::vector<Id> operands;
+    for (int op = 0; op < instruction->getNumOperands(); ++op)
+        operands.push_back(instruction->getIdOperand(op));
+    const Id* words = operands.data();
+    int numWords = (int)operands.size();
+
+    if (findUnique(instruction->getOpCode(), instruction->getTypeId(), words, numWords) == nullptr)
+        uniqueInstructions.insert(std::make_pair(hashUnique(instruction->getOpCode(), instruction->getTypeId(), words, numWords), instruction));
+}
+
 // See if a scalar constant of this type has already been created, so it
 // can be reused rather than duplicated.  (Required by the specification).
-Id Builder::findScalarConstant(Op typeClass, Op opcode, Id typeId, unsigned value) const
+Id Builder::findScalarConstant(Op opcode, Id typeId, unsigned value) const
 {
-    Instruction* constant;
-    for (int i = 0; i < (int)groupedConstants[typeClass].size(); ++i) {
-        constant = groupedConstants[typeClass][i];
-        if (constant->getOpCode() == opcode &&
-            constant->getTypeId() == typeId &&
-            constant->getImmediateOperand(0) == value)
-            return constant->getResultId();
-    }
+    Instruction* constant = findUnique(opcode, typeId, &value, 1);
 
-    return 0;
+    return constant ? constant->getResultId() : 0;
 }
 
 // Version of findScalarConstant (see above) for scalars that take two operands (e.g. a 'double' or 'int64').
-Id Builder::findScalarConstant(Op typeClass, Op opcode, Id typeId, unsigned v1, unsigned v2) const
+Id Builder::findScalarConstant(Op opcode, Id typeId, unsigned v1, unsigned v2) const
 {
-    Instruction* constant;
-    for (int i = 0; i < (int)groupedConstants[typeClass].size(); ++i) {
-        constant = groupedConstants[typeClass][i];
-        if (constant->getOpCode() == opcode &&
-            constant->getTypeId() == typeId &&
-            constant->getImmediateOperand(0) == v1 &&
-            constant->getImmediateOperand(1) == v2)
-            return constant->getResultId();
-    }
+    Id operands[] = { v1, v2 };
+    Instruction* constant = findUnique(opcode, typeId, operands, 2);
 
-    return 0;
+    return constant ? constant->getResultId() : 0;
 }
 
 // Return true if consuming 'opcode' means consuming a constant.
@@ -660,27 +665,20 @@ bool Builder::isSpecConstantOpCode(Op opcode) const
 Id Builder::makeBoolConstant(bool b, bool specConstant)
 {
     Id typeId = makeBoolType();
-    Instruction* constant;
     Op opcode = specConstant ? (b ? OpSpecConstantTrue : OpSpecConstantFalse) : (b ? OpConstantTrue : OpConstantFalse);
 
     // See if we already made it. Applies only to regular constants, because specialization constants
     // must remain distinct for the purpose of applying a SpecId decoration.
     if (! specConstant) {
-        Id existing = 0;
-        for (int i = 0; i < (int)groupedConstants[OpTypeBool].size(); ++i) {
-            constant = groupedConstants[OpTypeBool][i];
-            if (constant->getTypeId() == typeId && constant->getOpCode() == opcode)
-                existing = constant->getResultId();
-        }
-
+        Instruction* existing = findUnique(opcode, typeId, nullptr, 0);
         if (existing)
-            return existing;
+            return existing->getResultId();
     }
 
     // Make it
-    Instruction* c = new Instruction(getUniqueId(), typeId, opcode);
+    Instruction* c = new (arena) Instruction(getUniqueId(), typeId, opcode);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(c));
-    groupedConstants[OpTypeBool].push_back(c);
+    addUnique(c);
     module.mapInstruction(c);
 
     return c->getResultId();
@@ -693,15 +691,15 @@ Id Builder::makeIntConstant(Id typeId, unsigned value, bool specConstant)
     // See if we already made it. Applies only to regular constants, because specialization constants
     // must remain distinct for the purpose of applying a SpecId decoration.
     if (! specConstant) {
-        Id existing = findScalarConstant(OpTypeInt, opcode, typeId, value);
+        Id existing = findScalarConstant(opcode, typeId, value);
         if (existing)
             return existing;
     }
 
-    Instruction* c = new Instruction(getUniqueId(), typeId, opcode);
+    Instruction* c = new (arena) Instruction(getUniqueId(), typeId, opcode);
     c->addImmediateOperand(value);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(c));
-    groupedConstants[OpTypeInt].push_back(c);
+    addUnique(c);
     module.mapInstruction(c);
 
     return c->getResultId();
@@ -717,16 +715,16 @@ Id Builder::makeInt64Constant(Id typeId, unsigned long long value, bool specCons
     // See if we already made it. Applies only to regular constants, because specialization constants
     // must remain distinct for the purpose of applying a SpecId decoration.
     if (! specConstant) {
-        Id existing = findScalarConstant(OpTypeInt, opcode, typeId, op1, op2);
+        Id existing = findScalarConstant(opcode, typeId, op1, op2);
         if (existing)
             return existing;
     }
 
-    Instruction* c = new Instruction(getUniqueId(), typeId, opcode);
+    Instruction* c = new (arena) Instruction(getUniqueId(), typeId, opcode);
     c->addImmediateOperand(op1);
     c->addImmediateOperand(op2);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(c));
-    groupedConstants[OpTypeInt].push_back(c);
+    addUnique(c);
     module.mapInstruction(c);
 
     return c->getResultId();
@@ -743,15 +741,15 @@ Id Builder::makeFloatConstant(float f, bool specConstant)
     // See if we already made it. Applies only to regular constants, because specialization constants
     // must remain distinct for the purpose of applying a SpecId decoration.
     if (! specConstant) {
-        Id existing = findScalarConstant(OpTypeFloat, opcode, typeId, value);
+        Id existing = findScalarConstant(opcode, typeId, value);
         if (existing)
             return existing;
     }
 
-    Instruction* c = new Instruction(getUniqueId(), typeId, opcode);
+    Instruction* c = new (arena) Instruction(getUniqueId(), typeId, opcode);
     c->addImmediateOperand(value);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(c));
-    groupedConstants[OpTypeFloat].push_back(c);
+    addUnique(c);
     module.mapInstruction(c);
 
     return c->getResultId();
@@ -770,49 +768,21 @@ Id Builder::makeDoubleConstant(double d, bool specConstant)
     // See if we already made it. Applies only to regular constants, because specialization constants
     // must remain distinct for the purpose of applying a SpecId decoration.
     if (! specConstant) {
-        Id existing = findScalarConstant(OpTypeFloat, opcode, typeId, op1, op2);
+        Id existing = findScalarConstant(opcode, typeId, op1, op2);
         if (existing)
             return existing;
     }
 
-    Instruction* c = new Instruction(getUniqueId(), typeId, opcode);
+    Instruction* c = new (arena) Instruction(getUniqueId(), typeId, opcode);
     c->addImmediateOperand(op1);
     c->addImmediateOperand(op2);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(c));
-    groupedConstants[OpTypeFloat].push_back(c);
+    addUnique(c);
     module.mapInstruction(c);
 
     return c->getResultId();
 }
 
-Id Builder::findCompositeConstant(Op typeClass, std::vector<Id>& comps) const
-{
-    Instruction* constant = 0;
-    bool found = false;
-    for (int i = 0; i < (int)groupedConstants[typeClass].size(); ++i) {
-        constant = groupedConstants[typeClass][i];
-
-        // same shape?
-        if (constant->getNumOperands() != (int)comps.size())
-            continue;
-
-        // same contents?
-        bool mismatch = false;
-        for (int op = 0; op < constant->getNumOperands(); ++op) {
-            if (constant->getIdOperand(op) != comps[op]) {
-                mismatch = true;
-                break;
-            }
-        }
-        if (! mismatch) {
-            found = true;
-            break;
-        }
-    }
-
-    return found ? constant->getResultId() : NoResult;
-}
-
 // Comments in header
 Id Builder::makeCompositeConstant(Id typeId, std::vector<Id>& members, bool specConstant)
 {
@@ -832,16 +802,16 @@ Id Builder::makeCompositeConstant(Id typeId, std::vector<Id>& members, bool spec
     }
 
     if (! specConstant) {
-        Id existing = findCompositeConstant(typeClass, members);
+        Instruction* existing = findUnique(opcode, typeId, members.data(), (int)members.size());
         if (existing)
-            return existing;
+            return existing->getResultId();
     }
 
-    Instruction* c = new Instruction(getUniqueId(), typeId, opcode);
+    Instruction* c = new (arena) Instruction(getUniqueId(), typeId, opcode);
     for (int op = 0; op < (int)members.size(); ++op)
         c->addIdOperand(members[op]);
     constantsTypesGlobals.push_back(std::unique_ptr<Instruction>(c));
-    groupedConstants[typeClass].push_back(c);
+    addUnique(c);
     module.mapInstruction(c);
 
     return c->getResultId();
@@ -849,7 +819,7 @@ Id Builder::makeCompositeConstant(Id typeId, std::vector<Id>& members, bool spec
 
 Instruction* Builder::addEntryPoint(ExecutionModel model, Function* function, const char* name)
 {
-    Instruction* entryPoint = new Instruction(OpEntryPoint);
+    Instruction* entryPoint = new (arena) Instruction(OpEntryPoint);
     entryPoint->addImmediateOperand(model);
     entryPoint->addIdOperand(function->getId());
     entryPoint->addStringOperand(name);
@@ -862,7 +832,7 @@ Instruction* Builder::addEntryPoint(ExecutionModel model, Function* function, co
 // Currently relying on the fact that all 'value' of interest are small non-negative values.
 void Builder::addExecutionMode(Function* entryPoint, ExecutionMode mode, int value1, int value2, int value3)
 {
-    Instruction* instr = new Instruction(OpExecutionMode);
+    Instruction* instr = new (arena) Instruction(OpExecutionMode);
     instr->addIdOperand(entryPoint->getId());
     instr->addImmediateOperand(mode);
     if (value1 >= 0)
@@ -877,7 +847,7 @@ void Builder::addExecutionMode(Function* entryPoint, ExecutionMode mode, int val
 
 void Builder::addName(Id id, const char* string)
 {
-    Instruction* name = new Instruction(OpName);
+    Instruction* name = new (arena) Instruction(OpName);
     name->addIdOperand(id);
     name->addStringOperand(string);
 
@@ -886,7 +856,7 @@ void Builder::addName(Id id, const char* string)
 
 void Builder::addMemberName(Id id, int memberNumber, const char* string)
 {
-    Instruction* name = new Instruction(OpMemberName);
+    Instruction* name = new (arena) Instruction(OpMemberName);
     name->addIdOperand(id);
     name->addImmediateOperand(memberNumber);
     name->addStringOperand(string);
@@ -896,7 +866,7 @@ void Builder::addMemberName(Id id, int memberNumber, const char* string)
 
 void Builder::addLine(Id target, Id fileName, int lineNum, int column)
 {
-    Instruction* line = new Instruction(OpLine);
+    Instruction* line = new (arena) Instruction(OpLine);
     line->addIdOperand(target);
     line->addIdOperand(fileName);
     line->addImmediateOperand(lineNum);
@@ -909,7 +879,7 @@ void Builder::addDecoration(Id id, Decoration decoration, int num)
 {
     if (decoration == spv::DecorationMax)
         return;
-    Instruction* dec = new Instruction(OpDecorate);
+    Instruction* dec = new (arena) Instruction(OpDecorate);
     dec->addIdOperand(id);
     dec->addImmediateOperand(decoration);
     if (num >= 0)
@@ -920,7 +890,7 @@ void Builder::addDecoration(Id id, Decoration decoration, int num)
 
 void Builder::addMemberDecoration(Id id, unsigned int member, Decoration decoration, int num)
 {
-    Instruction* dec = new Instruction(OpMemberDecorate);
+    Instruction* dec = new (arena) Instruction(OpMemberDecorate);
     dec->addIdOperand(id);
     dec->addImmediateOperand(member);
     dec->addImmediateOperand(decoration);
@@ -951,7 +921,7 @@ Function* Builder::makeFunctionEntry(Decoration precision, Id returnType, const
     // Make the function and initial instructions in it
     Id typeId = makeFunctionType(returnType, paramTypes);
     Id firstParamId = paramTypes.size() == 0 ? 0 : getUniqueIds((int)paramTypes.size());
-    Function* function = new Function(getUniqueId(), returnType, typeId, firstParamId, module);
+    Function* function = new (arena) Function(getUniqueId(), returnType, typeId, firstParamId, module);
 
     // Set up the precisions
     setPrecision(function->getId(), precision);
@@ -960,7 +930,7 @@ Function* Builder::makeFunctionEntry(Decoration precision, Id returnType, const
 
     // CFG
     if (entry) {
-        *entry = new Block(getUniqueId(), *function);
+        *entry = new (arena) Block(getUniqueId(), *function);
         function->addBlock(*entry);
         setBuildPoint(*entry);
     }
@@ -977,11 +947,11 @@ Function* Builder::makeFunctionEntry(Decoration precision, Id returnType, const
 void Builder::makeReturn(bool implicit, Id retVal)
 {
     if (retVal) {
-        Instruction* inst = new Instruction(NoResult, NoType, OpReturnValue);
+        Instruction* inst = new (arena) Instruction(NoResult, NoType, OpReturnValue);
         inst->addIdOperand(retVal);
         buildPoint->addInstruction(std::unique_ptr<Instruction>(inst));
     } else
-        buildPoint->addInstruction(std::unique_ptr<Instruction>(new Instruction(NoResult, NoType, OpReturn)));
+        buildPoint->addInstruction(std::unique_ptr<Instruction>(new (arena) Instruction(NoResult, NoType, OpReturn)));
 
     if (! implicit)
         createAndSetNoPredecessorBlock("post-return");
@@ -1007,7 +977,7 @@ void Builder::leaveFunction()
 // Comments in header
 void Builder::makeDiscard()
 {
-    buildPoint->addInstruction(std::unique_ptr<Instruction>(new Instruction(OpKill)));
+    buildPoint->addInstruction(std::unique_ptr<Instruction>(new (arena) Instruction(OpKill)));
     createAndSetNoPredecessorBlock("post-discard");
 }
 
@@ -1015,7 +985,7 @@ void Builder::makeDiscard()
 Id Builder::createVariable(StorageClass storageClass, Id type, const char* name)
 {
     Id pointerType = makePointer(storageClass, type);
-    Instruction* inst = new Instruction(getUniqueId(), pointerType, OpVariable);
+    Instruction* inst = new (arena) Instruction(getUniqueId(), pointerType, OpVariable);
     inst->addImmediateOperand(storageClass);
 
     switch (storageClass) {
@@ -1039,7 +1009,7 @@ Id Builder::createVariable(StorageClass storageClass, Id type, const char* name)
 // Comments in header
 Id Builder::createUndefined(Id type)
 {
-  Instruction* inst = new Instruction(getUniqueId(), type, OpUndef);
+  Instruction* inst = new (arena) Instruction(getUniqueId(), type, OpUndef);
   buildPoint->addInstruction(std::unique_ptr<Instruction>(inst));
   return inst->getResultId();
 }
@@ -1047,7 +1017,7 @@ Id Builder::createUndefined(Id type)
 // Comments in header
 void Builder::createStore(Id rValue, Id lValue)
 {
-    Instruction* store = new Instruction(OpStore);
+    Instruction* store = new (arena) Instruction(OpStore);
     store->addIdOperand(lValue);
     store->addIdOperand(rValue);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(store));
@@ -1056,7 +1026,7 @@ void Builder::createStore(Id rValue, Id lValue)
 // Comments in header
 Id Builder::createLoad(Id lValue)
 {
-    Instruction* load = new Instruction(getUniqueId(), getDerefTypeId(lValue), OpLoad);
+    Instruction* load = new (arena) Instruction(getUniqueId(), getDerefTypeId(lValue), OpLoad);
     load->addIdOperand(lValue);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(load));
 
@@ -1080,7 +1050,7 @@ Id Builder::createAccessChain(StorageClass storageClass, Id base, std::vector<Id
     typeId = makePointer(storageClass, typeId);
 
     // Make the instruction
-    Instruction* chain = new Instruction(getUniqueId(), typeId, OpAccessChain);
+    Instruction* chain = new (arena) Instruction(getUniqueId(), typeId, OpAccessChain);
     chain->addIdOperand(base);
     for (int i = 0; i < (int)offsets.size(); ++i)
         chain->addIdOperand(offsets[i]);
@@ -1091,7 +1061,7 @@ Id Builder::createAccessChain(StorageClass storageClass, Id base, std::vector<Id
 
 Id Builder::createArrayLength(Id base, unsigned int member)
 {
-    Instruction* length = new Instruction(getUniqueId(), makeIntType(32), OpArrayLength);
+    Instruction* length = new (arena) Instruction(getUniqueId(), makeIntType(32), OpArrayLength);
     length->addIdOperand(base);
     length->addImmediateOperand(member);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(length));
@@ -1106,7 +1076,7 @@ Id Builder::createCompositeExtract(Id composite, Id typeId, unsigned index)
     if (generatingOpCodeForSpecConst) {
         return createSpecConstantOp(OpCompositeExtract, typeId, std::vector<Id>(1, composite), std::vector<Id>(1, index));
     }
-    Instruction* extract = new Instruction(getUniqueId(), typeId, OpCompositeExtract);
+    Instruction* extract = new (arena) Instruction(getUniqueId(), typeId, OpCompositeExtract);
     extract->addIdOperand(composite);
     extract->addImmediateOperand(index);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(extract));
@@ -1121,7 +1091,7 @@ Id Builder::createCompositeExtract(Id composite, Id typeId, std::vector<unsigned
     if (generatingOpCodeForSpecConst) {
         return createSpecConstantOp(OpCompositeExtract, typeId, std::vector<Id>(1, composite), indexes);
     }
-    Instruction* extract = new Instruction(getUniqueId(), typeId, OpCompositeExtract);
+    Instruction* extract = new (arena) Instruction(getUniqueId(), typeId, OpCompositeExtract);
     extract->addIdOperand(composite);
     for (int i = 0; i < (int)indexes.size(); ++i)
         extract->addImmediateOperand(indexes[i]);
@@ -1132,7 +1102,7 @@ Id Builder::createCompositeExtract(Id composite, Id typeId, std::vector<unsigned
 
 Id Builder::createCompositeInsert(Id object, Id composite, Id typeId, unsigned index)
 {
-    Instruction* insert = new Instruction(getUniqueId(), typeId, OpCompositeInsert);
+    Instruction* insert = new (arena) Instruction(getUniqueId(), typeId, OpCompositeInsert);
     insert->addIdOperand(object);
     insert->addIdOperand(composite);
     insert->addImmediateOperand(index);
@@ -1143,7 +1113,7 @@ Id Builder::createCompositeInsert(Id object, Id composite, Id typeId, unsigned i
 
 Id Builder::createCompositeInsert(Id object, Id composite, Id typeId, std::vector<unsigned>& indexes)
 {
-    Instruction* insert = new Instruction(getUniqueId(), typeId, OpCompositeInsert);
+    Instruction* insert = new (arena) Instruction(getUniqueId(), typeId, OpCompositeInsert);
     insert->addIdOperand(object);
     insert->addIdOperand(composite);
     for (int i = 0; i < (int)indexes.size(); ++i)
@@ -1155,7 +1125,7 @@ Id Builder::createCompositeInsert(Id object, Id composite, Id typeId, std::vecto
 
 Id Builder::createVectorExtractDynamic(Id vector, Id typeId, Id componentIndex)
 {
-    Instruction* extract = new Instruction(getUniqueId(), typeId, OpVectorExtractDynamic);
+    Instruction* extract = new (arena) Instruction(getUniqueId(), typeId, OpVectorExtractDynamic);
     extract->addIdOperand(vector);
     extract->addIdOperand(componentIndex);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(extract));
@@ -1165,7 +1135,7 @@ Id Builder::createVectorExtractDynamic(Id vector, Id typeId, Id componentIndex)
 
 Id Builder::createVectorInsertDynamic(Id vector, Id typeId, Id component, Id componentIndex)
 {
-    Instruction* insert = new Instruction(getUniqueId(), typeId, OpVectorInsertDynamic);
+    Instruction* insert = new (arena) Instruction(getUniqueId(), typeId, OpVectorInsertDynamic);
     insert->addIdOperand(vector);
     insert->addIdOperand(component);
     insert->addIdOperand(componentIndex);
@@ -1177,14 +1147,14 @@ Id Builder::createVectorInsertDynamic(Id vector, Id typeId, Id component, Id com
 // An opcode that has no operands, no result id, and no type
 void Builder::createNoResultOp(Op opCode)
 {
-    Instruction* op = new Instruction(opCode);
+    Instruction* op = new (arena) Instruction(opCode);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(op));
 }
 
 // An opcode that has one operand, no result id, and no type
 void Builder::createNoResultOp(Op opCode, Id operand)
 {
-    Instruction* op = new Instruction(opCode);
+    Instruction* op = new (arena) Instruction(opCode);
     op->addIdOperand(operand);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(op));
 }
@@ -1192,7 +1162,7 @@ void Builder::createNoResultOp(Op opCode, Id operand)
 // An opcode that has one operand, no result id, and no type
 void Builder::createNoResultOp(Op opCode, const std::vector<Id>& operands)
 {
-    Instruction* op = new Instruction(opCode);
+    Instruction* op = new (arena) Instruction(opCode);
     for (auto it = operands.cbegin(); it != operands.cend(); ++it)
         op->addIdOperand(*it);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(op));
@@ -1200,7 +1170,7 @@ void Builder::createNoResultOp(Op opCode, const std::vector<Id>& operands)
 
 void Builder::createControlBarrier(Scope execution, Scope memory, MemorySemanticsMask semantics)
 {
-    Instruction* op = new Instruction(OpControlBarrier);
+    Instruction* op = new (arena) Instruction(OpControlBarrier);
     op->addImmediateOperand(makeUintConstant(execution));
     op->addImmediateOperand(makeUintConstant(memory));
     op->addImmediateOperand(makeUintConstant(semantics));
@@ -1209,7 +1179,7 @@ void Builder::createControlBarrier(Scope execution, Scope memory, MemorySemantic
 
 void Builder::createMemoryBarrier(unsigned executionScope, unsigned memorySemantics)
 {
-    Instruction* op = new Instruction(OpMemoryBarrier);
+    Instruction* op = new (arena) Instruction(OpMemoryBarrier);
     op->addImmediateOperand(makeUintConstant(executionScope));
     op->addImmediateOperand(makeUintConstant(memorySemantics));
     buildPoint->addInstruction(std::unique_ptr<Instruction>(op));
@@ -1223,7 +1193,7 @@ Id Builder::createUnaryOp(Op opCode, Id typeId, Id operand)
     if (generatingOpCodeForSpecConst) {
         return createSpecConstantOp(opCode, typeId, std::vector<Id>(1, operand), std::vector<Id>());
     }
-    Instruction* op = new Instruction(getUniqueId(), typeId, opCode);
+    Instruction* op = new (arena) Instruction(getUniqueId(), typeId, opCode);
     op->addIdOperand(operand);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(op));
 
@@ -1239,7 +1209,7 @@ Id Builder::createBinOp(Op opCode, Id typeId, Id left, Id right)
         operands[0] = left; operands[1] = right;
         return createSpecConstantOp(opCode, typeId, operands, std::vector<Id>());
     }
-    Instruction* op = new Instruction(getUniqueId(), typeId, opCode);
+    Instruction* op = new (arena) Instruction(getUniqueId(), typeId, opCode);
     op->addIdOperand(left);
     op->addIdOperand(right);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(op));
@@ -1259,7 +1229,7 @@ Id Builder::createTriOp(Op opCode, Id typeId, Id op1, Id op2, Id op3)
         return createSpecConstantOp(
             opCode, typeId, operands, std::vector<Id>());
     }
-    Instruction* op = new Instruction(getUniqueId(), typeId, opCode);
+    Instruction* op = new (arena) Instruction(getUniqueId(), typeId, opCode);
     op->addIdOperand(op1);
     op->addIdOperand(op2);
     op->addIdOperand(op3);
@@ -1270,7 +1240,7 @@ Id Builder::createTriOp(Op opCode, Id typeId, Id op1, Id op2, Id op3)
 
 Id Builder::createOp(Op opCode, Id typeId, const std::vector<Id>& operands)
 {
-    Instruction* op = new Instruction(getUniqueId(), typeId, opCode);
+    Instruction* op = new (arena) Instruction(getUniqueId(), typeId, opCode);
     for (auto it = operands.cbegin(); it != operands.cend(); ++it)
         op->addIdOperand(*it);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(op));
@@ -1280,7 +1250,7 @@ Id Builder::createOp(Op opCode, Id typeId, const std::vector<Id>& operands)
 
 Id Builder::createSpecConstantOp(Op opCode, Id typeId, const std::vector<Id>& operands, const std::vector<unsigned>& literals)
 {
-    Instruction* op = new Instruction(getUniqueId(), typeId, OpSpecConstantOp);
+    Instruction* op = new (arena) Instruction(getUniqueId(), typeId, OpSpecConstantOp);
     op->addImmediateOperand((unsigned) opCode);
     for (auto it = operands.cbegin(); it != operands.cend(); ++it)
         op->addIdOperand(*it);
@@ -1294,7 +1264,7 @@ Id Builder::createSpecConstantOp(Op opCode, Id typeId, const std::vector<Id>& op
 
 Id Builder::createFunctionCall(spv::Function* function, std::vector<spv::Id>& args)
 {
-    Instruction* op = new Instruction(getUniqueId(), function->getReturnType(), OpFunctionCall);
+    Instruction* op = new (arena) Instruction(getUniqueId(), function->getReturnType(), OpFunctionCall);
     op->addIdOperand(function->getId());
     for (int a = 0; a < (int)args.size(); ++a)
         op->addIdOperand(args[a]);
@@ -1314,7 +1284,7 @@ Id Builder::createRvalueSwizzle(Decoration precision, Id typeId, Id source, std:
         operands[0] = operands[1] = source;
         return setPrecision(createSpecConstantOp(OpVectorShuffle, typeId, operands, channels), precision);
     }
-    Instruction* swizzle = new Instruction(getUniqueId(), typeId, OpVectorShuffle);
+    Instruction* swizzle = new (arena) Instruction(getUniqueId(), typeId, OpVectorShuffle);
     assert(isVector(source));
     swizzle->addIdOperand(source);
     swizzle->addIdOperand(source);
@@ -1332,7 +1302,7 @@ Id Builder::createLvalueSwizzle(Id typeId, Id target, Id source, std::vector<uns
     if (channels.size() == 1 && getNumComponents(source) == 1)
         return createCompositeInsert(source, target, typeId, channels.front());
 
-    Instruction* swizzle = new Instruction(getUniqueId(), typeId, OpVectorShuffle);
+    Instruction* swizzle = new (arena) Instruction(getUniqueId(), typeId, OpVectorShuffle);
     assert(isVector(source));
     assert(isVector(target));
     swizzle->addIdOperand(target);
@@ -1393,7 +1363,7 @@ Id Builder::smearScalar(Decoration precision, Id scalar, Id vectorType)
         auto result_id = makeCompositeConstant(vectorType, members, isSpecConstant(scalar));
         smear = module.getInstruction(result_id);
     } else {
-        smear = new Instruction(getUniqueId(), vectorType, OpCompositeConstruct);
+        smear = new (arena) Instruction(getUniqueId(), vectorType, OpCompositeConstruct);
         for (int c = 0; c < numComponents; ++c)
             smear->addIdOperand(scalar);
         buildPoint->addInstruction(std::unique_ptr<Instruction>(smear));
@@ -1405,7 +1375,7 @@ Id Builder::smearScalar(Decoration precision, Id scalar, Id vectorType)
 // Comments in header
 Id Builder::createBuiltinCall(Id resultType, Id builtins, int entryPoint, std::vector<Id>& args)
 {
-    Instruction* inst = new Instruction(getUniqueId(), resultType, OpExtInst);
+    Instruction* inst = new (arena) Instruction(getUniqueId(), resultType, OpExtInst);
     inst->addIdOperand(builtins);
     inst->addImmediateOperand(entryPoint);
     for (int arg = 0; arg < (int)args.size(); ++arg)
@@ -1587,7 +1557,7 @@ Id Builder::createTextureCall(Decoration precision, Id resultType, bool sparse,
     }
 
     // Build the SPIR-V instruction
-    Instruction* textureInst = new Instruction(getUniqueId(), resultType, opCode);
+    Instruction* textureInst = new (arena) Instruction(getUniqueId(), resultType, opCode);
     for (int op = 0; op < optArgNum; ++op)
         textureInst->addIdOperand(texArgs[op]);
     if (optArgNum < numArgs)
@@ -1670,7 +1640,7 @@ Id Builder::createTextureQueryCall(Op opCode, const TextureParameters& parameter
         break;
     }
 
-    Instruction* query = new Instruction(getUniqueId(), resultType, opCode);
+    Instruction* query = new (arena) Instruction(getUniqueId(), resultType, opCode);
     query->addIdOperand(parameters.sampler);
     if (parameters.coords)
         query->addIdOperand(parameters.coords);
@@ -1769,7 +1739,7 @@ Id Builder::createCompositeConstruct(Id typeId, std::vector<Id>& constituents)
                                                  [&](spv::Id id) { return isSpecConstant(id); }));
     }
 
-    Instruction* op = new Instruction(getUniqueId(), typeId, OpCompositeConstruct);
+    Instruction* op = new (arena) Instruction(getUniqueId(), typeId, OpCompositeConstruct);
     for (int c = 0; c < (int)constituents.size(); ++c)
         op->addIdOperand(constituents[c]);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(op));
@@ -1924,8 +1894,8 @@ Builder::If::If(Id cond, Builder& gb) :
     // make the blocks, but only put the then-block into the function,
     // the else-block and merge-block will be added later, in order, after
     // earlier code is emitted
-    thenBlock = new Block(builder.getUniqueId(), *function);
-    mergeBlock = new Block(builder.getUniqueId(), *function);
+    thenBlock = new (builder.arena) Block(builder.getUniqueId(), *function);
+    mergeBlock = new (builder.arena) Block(builder.getUniqueId(), *function);
 
     // Save the current block, so that we can add in the flow control split when
     // makeEndIf is called.
@@ -1942,7 +1912,7 @@ void Builder::If::makeBeginElse()
     builder.createBranch(mergeBlock);
 
     // Make the first else block and add it to the function
-    elseBlock = new Block(builder.getUniqueId(), *function);
+    elseBlock = new (builder.arena) Block(builder.getUniqueId(), *function);
     function->addBlock(elseBlock);
 
     // Start building the else block
@@ -1976,15 +1946,15 @@ void Builder::makeSwitch(Id selector, int numSegments, std::vector<int>& caseVal
 
     // make all the blocks
     for (int s = 0; s < numSegments; ++s)
-        segmentBlocks.push_back(new Block(getUniqueId(), function));
+        segmentBlocks.push_back(new (arena) Block(getUniqueId(), function));
 
-    Block* mergeBlock = new Block(getUniqueId(), function);
+    Block* mergeBlock = new (arena) Block(getUniqueId(), function);
 
     // make and insert the switch's selection-merge instruction
     createSelectionMerge(mergeBlock, SelectionControlMaskNone);
 
     // make the switch instruction
-    Instruction* switchInst = new Instruction(NoResult, NoType, OpSwitch);
+    Instruction* switchInst = new (arena) Instruction(NoResult, NoType, OpSwitch);
     switchInst->addIdOperand(selector);
     auto defaultOrMerge = (defaultSegment >= 0) ? segmentBlocks[defaultSegment] : mergeBlock;
     switchInst->addIdOperand(defaultOrMerge->getId());
@@ -2038,7 +2008,7 @@ void Builder::endSwitch(std::vector<Block*>& /*segmentBlock*/)
 Block& Builder::makeNewBlock()
 {
     Function& function = buildPoint->getParent();
-    auto block = new Block(getUniqueId(), function);
+    auto block = new (arena) Block(getUniqueId(), function);
     function.addBlock(block);
     return *block;
 }
@@ -2297,6 +2267,28 @@ void Builder::eliminateDeadDecorations() {
 }
 
 void Builder::dump(std::vector<unsigned int>& out) const
+{
+    dumpModule(out);
+}
+
+size_t Builder::getDumpSize() const
+{
+    WordCounter counter;
+    dumpModule(counter);
+
+    return counter.size();
+}
+
+size_t Builder::dump(unsigned int* out, size_t capacity) const
+{
+    WordWriter writer(out, capacity);
+    dumpModule(writer);
+
+    return writer.size();
+}
+
+template <class Out>
+void Builder::dumpModule(Out& out) const
 {
     // Header, before first instructions:
     out.push_back(MagicNumber);
@@ -2446,7 +2438,7 @@ void Builder::transferAccessChainSwizzle(bool dynamic)
 // block proceeding them (e.g. instructions after a discard, etc).
 void Builder::createAndSetNoPredecessorBlock(const char* /*name*/)
 {
-    Block* block = new Block(getUniqueId(), buildPoint->getParent());
+    Block* block = new (arena) Block(getUniqueId(), buildPoint->getParent());
     block->setUnreachable();
     buildPoint->getParent().addBlock(block);
     setBuildPoint(block);
@@ -2458,7 +2450,7 @@ void Builder::createAndSetNoPredecessorBlock(const char* /*name*/)
 // Comments in header
 void Builder::createBranch(Block* block)
 {
-    Instruction* branch = new Instruction(OpBranch);
+    Instruction* branch = new (arena) Instruction(OpBranch);
     branch->addIdOperand(block->getId());
     buildPoint->addInstruction(std::unique_ptr<Instruction>(branch));
     block->addPredecessor(buildPoint);
@@ -2466,7 +2458,7 @@ void Builder::createBranch(Block* block)
 
 void Builder::createSelectionMerge(Block* mergeBlock, unsigned int control)
 {
-    Instruction* merge = new Instruction(OpSelectionMerge);
+    Instruction* merge = new (arena) Instruction(OpSelectionMerge);
     merge->addIdOperand(mergeBlock->getId());
     merge->addImmediateOperand(control);
     buildPoint->addInstruction(std::unique_ptr<Instruction>(merge));
@@ -2474,7 +2466,7 @@ void Builder::createSelectionMerge(Block* mergeBlock, unsigned int control)
 
 void Builder::createLoopMerge(Block* mergeBlock, Block* continueBlock, unsigned int control)
 {
-    Instruction* merge = new Instruction(OpLoopMerge);
+    Instruction* merge = new (arena) Instruction(OpLoopMerge);
     merge->addIdOperand(mergeBlock->getId());
     merge->addIdOperand(continueBlock->getId());
     merge->addImmediateOperand(control);
@@ -2483,7 +2475,7 @@ void Builder::createLoopMerge(Block* mergeBlock, Block* continueBlock, unsigned
 
 void Builder::createConditionalBranch(Id condition, Block* thenBlock, Block* elseBlock)
 {
-    Instruction* branch = new Instruction(OpBranchConditional);
+    Instruction* branch = new (arena) Instruction(OpBranchConditional);
     branch->addIdOperand(condition);
     branch->addIdOperand(thenBlock->getId());
     branch->addIdOperand(elseBlock->getId());
@@ -2492,7 +2484,8 @@ void Builder::createConditionalBranch(Id condition, Block* thenBlock, Block* els
     elseBlock->addPredecessor(buildPoint);
 }
 
-void Builder::dumpInstructions(std::vector<unsigned int>& out, const std::vector<std::unique_ptr<Instruction> >& instructions) const
+template <class Out>
+void Builder::dumpInstructions(Out& out, const std::vector<std::unique_ptr<Instruction> >& instructions) const
 {
     for (int i = 0; i < (int)instructions.size(); ++i) {
         instructions[i]->dump(out);
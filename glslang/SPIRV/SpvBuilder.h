@@ -55,6 +55,7 @@
 #include <set>
 #include <sstream>
 #include <stack>
+#include <unordered_map>
 
 namespace spv {
 
@@ -526,6 +527,15 @@ public:
     void eliminateDeadDecorations();
     void dump(std::vector<unsigned int>&) const;
 
+    // Number of words dump() will write for the module as it stands.
+    size_t getDumpSize() const;
+
+    // Write the module straight into a caller-provided buffer of 'capacity' words, such as
+    // one sized by getDumpSize().  Returns the number of words the module needs; nothing
+    // past 'capacity' is written, so a result larger than 'capacity' means the buffer was
+    // too small.
+    size_t dump(unsigned int* out, size_t capacity) const;
+
     void createBranch(Block* block);
     void createConditionalBranch(Id condition, Block* thenBlock, Block* elseBlock);
     void createLoopMerge(Block* mergeBlock, Block* continueBlock, unsigned int control);
@@ -540,15 +550,18 @@ public:
  protected:
     Id makeIntConstant(Id typeId, unsigned value, bool specConstant);
     Id makeInt64Constant(Id typeId, unsigned long long value, bool specConstant);
-    Id findScalarConstant(Op typeClass, Op opcode, Id typeId, unsigned value) const;
-    Id findScalarConstant(Op typeClass, Op opcode, Id typeId, unsigned v1, unsigned v2) const;
-    Id findCompositeConstant(Op typeClass, std::vector<Id>& comps) const;
+    static size_t hashUnique(Op opcode, Id typeId, const Id* operands, int numOperands);
+    Instruction* findUnique(Op opcode, Id typeId, const Id* operands, int numOperands) const;
+    void addUnique(Instruction*);
+    Id findScalarConstant(Op opcode, Id typeId, unsigned value) const;
+    Id findScalarConstant(Op opcode, Id typeId, unsigned v1, unsigned v2) const;
     Id collapseAccessChain();
     void transferAccessChainSwizzle(bool dynamic);
     void simplifyAccessChainSwizzle();
     void createAndSetNoPredecessorBlock(const char*);
     void createSelectionMerge(Block* mergeBlock, unsigned int control);
-    void dumpInstructions(std::vector<unsigned int>&, const std::vector<std::unique_ptr<Instruction> >&) const;
+    template <class Out> void dumpModule(Out&) const;
+    template <class Out> void dumpInstructions(Out&, const std::vector<std::unique_ptr<Instruction> >&) const;
 
     SourceLanguage source;
     int sourceVersion;
@@ -558,6 +571,7 @@ public:
     MemoryModel memoryModel;
     std::set<spv::Capability> capabilities;
     int builderNumber;
+    Arena arena;      // must outlive everything allocated from it, so declared before them
     Module module;
     Block* buildPoint;
     Id uniqueId;
@@ -577,8 +591,10 @@ public:
     std::vector<std::unique_ptr<Function> > functions;
 
      // not output, internally used for quick & dirty canonical (unique) creation
-    std::vector<Instruction*> groupedConstants[OpConstant];  // all types appear before OpConstant
-    std::vector<Instruction*> groupedTypes[OpConstant];
+    std::vector<Instruction*> groupedTypes[OpConstant];  // all types appear before OpConstant
+
+     // not output, types and constants hashed by opcode, type, and operands, for findUnique()
+    std::unordered_multimap<size_t, Instruction*> uniqueInstructions;
 
     // stack of switches
     std::stack<Block*> switchMerges;
@@ -50,6 +50,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -74,11 +75,155 @@ const MemorySemanticsMask MemorySemanticsAllMemory =
                                       MemorySemanticsAtomicCounterMemoryMask |
                                       MemorySemanticsImageMemoryMask);
 
+//
+// Word sinks for the dump() methods, which accept anything with push_back(unsigned int):
+// WordCounter only counts the words, so a module can be sized before it is written, and
+// WordWriter writes them into a caller-provided buffer.
+//
+
+class WordCounter {
+public:
+    WordCounter() : count(0) { }
+    void push_back(unsigned int) { ++count; }
+    size_t size() const { return count; }
+
+protected:
+    size_t count;
+};
+
+class WordWriter {
+public:
+    WordWriter(unsigned int* buffer, size_t capacity) : buffer(buffer), capacity(capacity), count(0) { }
+
+    // Words past the capacity are counted, but not written, so size() > capacity means the
+    // buffer was too small
+    void push_back(unsigned int word)
+    {
+        if (count < capacity)
+            buffer[count] = word;
+        ++count;
+    }
+    size_t size() const { return count; }
+
+protected:
+    unsigned int* buffer;
+    size_t capacity;
+    size_t count;
+};
+
+//
+// Bump allocator for the IR of one module.  Instructions, blocks, and functions are
+// carved out of large chunks, which are all released together when the arena is
+// destroyed, instead of being individually allocated and freed.  An arena is owned
+// by whatever builds the module, and must outlive everything allocated from it.
+//
+
+class Arena {
+public:
+    Arena() : next(nullptr), end(nullptr) { }
+    ~Arena()
+    {
+        for (int c = 0; c < (int)chunks.size(); ++c)
+            ::operator delete(chunks[c]);
+    }
+
+    void* allocate(size_t size)
+    {
+        size = (size + alignment - 1) & ~(alignment - 1);
+        if (size > (size_t)(end - next))
+            grow(size);
+        void* memory = next;
+        next += size;
+        return memory;
+    }
+
+protected:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    static const size_t alignment = alignof(std::max_align_t);
+    static const size_t chunkSize = 64 * 1024;
+
+    void grow(size_t size)
+    {
+        size_t chunk = size > chunkSize ? size : chunkSize;
+        next = (char*)::operator new(chunk);
+        end = next + chunk;
+        chunks.push_back(next);
+    }
+
+    char* next;
+    char* end;
+    std::vector<char*> chunks;
+};
+
+//
+// Base for the IR classes, which can only be created inside an arena:
+//
+//     new (arena) Instruction(...)
+//
+// Deleting one (e.g., through a std::unique_ptr) still runs its destructor, but leaves
+// the memory to the arena.
+//
+
+class ArenaObject {
+public:
+    static void* operator new(size_t size, Arena& arena) { return arena.allocate(size); }
+    static void operator delete(void*, Arena&) { }
+    static void operator delete(void*) { }
+};
+
+//
+// Operand words of an instruction.  Most instructions have only a few operands, so
+// these are stored inside the instruction itself, and only longer lists (strings,
+// large composites, switches, ...) spill to the heap.
+//
+
+class Operands {
+public:
+    Operands() : words(inlineWords), count(0), capacity(inlineCapacity) { }
+    ~Operands()
+    {
+        if (words != inlineWords)
+            delete [] words;
+    }
+
+    void push_back(Id word)
+    {
+        if (count == capacity)
+            grow();
+        words[count++] = word;
+    }
+    size_t size() const { return count; }
+    Id operator[](int i) const { return words[i]; }
+
+protected:
+    Operands(const Operands&);
+    Operands& operator=(const Operands&);
+
+    static const unsigned int inlineCapacity = 4;
+
+    void grow()
+    {
+        capacity *= 2;
+        Id* larger = new Id[capacity];
+        std::copy(words, words + count, larger);
+        if (words != inlineWords)
+            delete [] words;
+        words = larger;
+    }
+
+    Id* words;
+    unsigned int count;
+    unsigned int capacity;
+    Id inlineWords[inlineCapacity];
+};
+
 //
 // SPIR-V IR instruction.
 //
 
-class Instruction {
+class Instruction : public ArenaObject {
 public:
     Instruction(Id resultId, Id typeId, Op opCode) : resultId(resultId), typeId(typeId), opCode(opCode), block(nullptr) { }
     explicit Instruction(Op opCode) : resultId(NoResult), typeId(NoType), opCode(opCode), block(nullptr) { }
@@ -123,7 +268,8 @@ public:
     const char* getStringOperand() const { return originalString.c_str(); }
 
     // Write out the binary form.
-    void dump(std::vector<unsigned int>& out) const
+    template <class Out>
+    void dump(Out& out) const
     {
         // Compute the wordCount
         unsigned int wordCount = 1;
@@ -150,7 +296,7 @@ protected:
     Id resultId;
     Id typeId;
     Op opCode;
-    std::vector<Id> operands;
+    Operands operands;
     std::string originalString;        // could be optimized away; convenience for getting string operand
     Block* block;
 };
@@ -159,7 +305,7 @@ protected:
 // SPIR-V IR block.
 //
 
-class Block {
+class Block : public ArenaObject {
 public:
     Block(Id id, Function& parent);
     virtual ~Block()
@@ -208,7 +354,8 @@ public:
         }
     }
 
-    void dump(std::vector<unsigned int>& out) const
+    template <class Out>
+    void dump(Out& out) const
     {
         instructions[0]->dump(out);
         for (int i = 0; i < (int)localVariables.size(); ++i)
@@ -244,7 +391,7 @@ void inReadableOrder(Block* root, std::function<void(Block*)> callback);
 // SPIR-V IR Function.
 //
 
-class Function {
+class Function : public ArenaObject {
 public:
     Function(Id id, Id resultType, Id functionType, Id firstParam, Module& parent);
     virtual ~Function()
@@ -273,7 +420,8 @@ public:
     const std::vector<Block*>& getBlocks() const { return blocks; }
     void addLocalVariable(std::unique_ptr<Instruction> inst);
     Id getReturnType() const { return functionInstruction.getTypeId(); }
-    void dump(std::vector<unsigned int>& out) const
+    template <class Out>
+    void dump(Out& out) const
     {
         // OpFunction
         functionInstruction.dump(out);
@@ -304,12 +452,15 @@ protected:
 
 class Module {
 public:
-    Module() {}
+    explicit Module(Arena& arena) : arena(arena) {}
     virtual ~Module()
     {
         // TODO delete things
     }
 
+    // Where the module's instructions, blocks, and functions are allocated
+    Arena& getArena() const { return arena; }
+
     void addFunction(Function *fun) { functions.push_back(fun); }
 
     void mapInstruction(Instruction *instruction)
@@ -330,7 +481,8 @@ public:
         return (StorageClass)idToInstruction[typeId]->getImmediateOperand(0);
     }
 
-    void dump(std::vector<unsigned int>& out) const
+    template <class Out>
+    void dump(Out& out) const
     {
         for (int f = 0; f < (int)functions.size(); ++f)
             functions[f]->dump(out);
@@ -338,6 +490,7 @@ public:
 
 protected:
     Module(const Module&);
+    Arena& arena;
     std::vector<Function*> functions;
 
     // map from result id to instruction having that result id
@@ -366,7 +519,7 @@ __inline Function::Function(Id id, Id resultType, Id functionType, Id firstParam
     Instruction* typeInst = parent.getInstruction(functionType);
     int numParams = typeInst->getNumOperands() - 1;
     for (int p = 0; p < numParams; ++p) {
-        Instruction* param = new Instruction(firstParamId + p, typeInst->getIdOperand(p + 1), OpFunctionParameter);
+        Instruction* param = new (parent.getArena()) Instruction(firstParamId + p, typeInst->getIdOperand(p + 1), OpFunctionParameter);
         parent.mapInstruction(param);
         parameterInstructions.push_back(param);
     }
@@ -381,7 +534,7 @@ __inline void Function::addLocalVariable(std::unique_ptr<Instruction> inst)
 
 __inline Block::Block(Id id, Function& parent) : parent(parent), unreachable(false)
 {
-    instructions.push_back(std::unique_ptr<Instruction>(new Instruction(id, NoType, OpLabel)));
+    instructions.push_back(std::unique_ptr<Instruction>(new (parent.getParent().getArena()) Instruction(id, NoType, OpLabel)));
     instructions.back()->setBlock(this);
     parent.getParent().mapInstruction(instructions.back().get());
 }
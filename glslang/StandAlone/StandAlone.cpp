@@ -40,6 +40,7 @@
 #include "ResourceLimits.h"
 #include "Worklist.h"
 #include "./../glslang/Include/ShHandle.h"
+#include "./../glslang/Include/PoolAlloc.h"
 #include "./../glslang/Include/revision.h"
 #include "./../glslang/Public/ShaderLang.h"
 #include "../SPIRV/GlslangToSpv.h"
@@ -49,6 +50,18 @@
 #include <cstring>
 #include <cstdlib>
 #include <cmath>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#else
+    #include <unistd.h>
+#endif
 
 #include "../glslang/OSDependent/osinclude.h"
 
@@ -114,6 +127,27 @@ int NumShaderStrings;
 TBuiltInResource Resources;
 std::string ConfigFile;
 
+// Set when running as a persistent server (--server).  Process-wide glslang
+// state is then set up once, and fatal usage errors end the current request
+// rather than the process.
+bool ServerMode = false;
+
+// Thrown instead of calling exit() while in server mode.
+struct TRequestExit {
+    int code;
+};
+
+//
+// Exit the process, or in server mode, just the current request.
+//
+void Exit(int code)
+{
+    if (ServerMode)
+        throw TRequestExit{ code };
+
+    exit(code);
+}
+
 //
 // Parse either a .conf file provided by the user or the default from glslang::DefaultTBuiltInResource
 //
@@ -201,7 +235,7 @@ bool SetConfigFile(const std::string& name)
 void Error(const char* message)
 {
     printf("%s: Error %s (use -h for usage)\n", ExecutableName, message);
-    exit(EFailUsage);
+    Exit(EFailUsage);
 }
 
 //
@@ -366,7 +400,35 @@ void SetMessageOptions(EShMessages& messages)
 }
 
 //
-// Thread entry point, for non-linking asynchronous mode.
+// Compile one work item, for non-linking mode, leaving its infolog in the
+// work item.
+//
+// Return false if a compiler couldn't be constructed.
+//
+bool CompileWorkItem(glslang::TWorkItem* workItem)
+{
+    ShHandle compiler = ShConstructCompiler(FindLanguage(workItem->name), Options);
+    if (compiler == 0)
+        return false;
+
+    try {
+        CompileFile(workItem->name.c_str(), compiler);
+    } catch (...) {
+        // server mode, or out of memory; don't leak the compiler across requests
+        ShDestruct(compiler);
+        throw;
+    }
+
+    if (! (Options & EOptionSuppressInfolog))
+        workItem->results = ShGetInfoLog(compiler);
+
+    ShDestruct(compiler);
+
+    return true;
+}
+
+//
+// Non-linking mode, on the main thread.
 //
 // Return 0 for failure, 1 for success.
 //
@@ -374,16 +436,40 @@ unsigned int CompileShaders(void*)
 {
     glslang::TWorkItem* workItem;
     while (Worklist.remove(workItem)) {
-        ShHandle compiler = ShConstructCompiler(FindLanguage(workItem->name), Options);
-        if (compiler == 0)
+        if (! CompileWorkItem(workItem))
             return 0;
+    }
 
-        CompileFile(workItem->name.c_str(), compiler);
-
-        if (! (Options & EOptionSuppressInfolog))
-            workItem->results = ShGetInfoLog(compiler);
+    return 0;
+}
 
-        ShDestruct(compiler);
+//
+// Thread entry point, for non-linking asynchronous mode.
+//
+// An exception escaping the thread would end the process (the whole server,
+// in server mode), so a work item that throws is reported as a failed
+// compile, like any other, and the thread moves on to the next item.
+//
+// Return 0 for failure, 1 for success.
+//
+unsigned int CompileShadersOnThread(void*)
+{
+    glslang::TWorkItem* workItem;
+    while (Worklist.remove(workItem)) {
+        try {
+            if (! CompileWorkItem(workItem))
+                return 0;
+        } catch (const TRequestExit& e) {
+            // the reason was already printed, by Error() or usage()
+            workItem->results = "ERROR: compile stopped with exit code " + std::to_string(e.code);
+            CompileFailed = true;
+        } catch (const std::exception& e) {
+            workItem->results = std::string("ERROR: compile stopped: ") + e.what();
+            CompileFailed = true;
+        } catch (...) {
+            workItem->results = "ERROR: compile stopped by an unknown exception";
+            CompileFailed = true;
+        }
     }
 
     return 0;
@@ -606,7 +692,10 @@ void CompileAndLinkShaderFiles()
         FreeFileData(it->text);
 }
 
-int C_DECL main(int argc, char* argv[])
+//
+// One full run over a command line; the body of main() when not in server mode.
+//
+int RunCommandLine(int argc, char* argv[])
 {
     ProcessArguments(argc, argv);
 
@@ -644,16 +733,19 @@ int C_DECL main(int argc, char* argv[])
     //
     if (Options & EOptionLinkProgram ||
         Options & EOptionOutputPreprocessed) {
-        glslang::InitializeProcess();
+        if (! ServerMode)
+            glslang::InitializeProcess();
         CompileAndLinkShaderFiles();
-        glslang::FinalizeProcess();
+        if (! ServerMode)
+            glslang::FinalizeProcess();
         for (int w = 0; w < NumWorkItems; ++w) {
           if (Work[w]) {
             delete Work[w];
           }
         }
     } else {
-        ShInitialize();
+        if (! ServerMode)
+            ShInitialize();
 
         bool printShaderNames = Worklist.size() > 1;
 
@@ -661,7 +753,7 @@ int C_DECL main(int argc, char* argv[])
             const int NumThreads = 16;
             void* threads[NumThreads];
             for (int t = 0; t < NumThreads; ++t) {
-                threads[t] = glslang::OS_CreateThread(&CompileShaders);
+                threads[t] = glslang::OS_CreateThread(&CompileShadersOnThread);
                 if (! threads[t]) {
                     printf("Failed to create thread\n");
                     return EFailThreadCreate;
@@ -681,10 +773,13 @@ int C_DECL main(int argc, char* argv[])
             }
         }
 
-        ShFinalize();
+        if (! ServerMode)
+            ShFinalize();
     }
 
     delete[] Work;
+    Work = 0;
+    NumWorkItems = 0;
 
     if (CompileFailed)
         return EFailCompile;
@@ -694,6 +789,208 @@ int C_DECL main(int argc, char* argv[])
     return 0;
 }
 
+//
+// Put all the per-run globals back to their initial state, so the next
+// server request starts from scratch.  Also cleans up after a request that
+// ended early.
+//
+void ResetRunState()
+{
+    glslang::TWorkItem* workItem;
+    while (Worklist.remove(workItem))
+        ;
+
+    if (Work) {
+        for (int w = 0; w < NumWorkItems; ++w)
+            delete Work[w];
+        delete[] Work;
+    }
+    Work = 0;
+    NumWorkItems = 0;
+
+    Options = 0;
+    binaryFileName = nullptr;
+    entryPointName = nullptr;
+    shaderStageName = nullptr;
+    ConfigFile.clear();
+    CompileFailed = false;
+    LinkFailed = false;
+}
+
+//
+// Read exactly 'size' bytes; false on end-of-file or error.
+//
+bool ReadFully(FILE* in, void* data, size_t size)
+{
+    return size == 0 || fread(data, 1, size, in) == size;
+}
+
+bool ReadFrameLength(FILE* in, unsigned int& length)
+{
+    unsigned char bytes[4];
+    if (! ReadFully(in, bytes, sizeof(bytes)))
+        return false;
+
+    length = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+    return true;
+}
+
+void AppendFrameLength(std::string& out, size_t length)
+{
+    for (int b = 0; b < 4; ++b)
+        out.push_back((char)((length >> (8 * b)) & 0xff));
+}
+
+//
+// Captures everything a request writes to one of the standard streams, by
+// pointing the stream's descriptor at a scratch file for the duration of the
+// request.  The scratch file is reused; only the bytes written since begin()
+// are returned by end().
+//
+class TStreamCapture {
+public:
+    TStreamCapture(FILE* stream) : stream(stream), scratch(tmpfile()), savedFd(-1) { }
+    ~TStreamCapture()
+    {
+        if (scratch)
+            fclose(scratch);
+    }
+
+    bool valid() const { return scratch != nullptr; }
+
+    void begin()
+    {
+        fflush(stream);
+        lseek(fileno(scratch), 0, SEEK_SET);
+        savedFd = dup(fileno(stream));
+        dup2(fileno(scratch), fileno(stream));
+    }
+
+    std::string end()
+    {
+        fflush(stream);
+        dup2(savedFd, fileno(stream));
+        close(savedFd);
+        savedFd = -1;
+
+        // the stream shared the scratch file's offset, which now marks the end of this request's output
+        long length = (long)lseek(fileno(scratch), 0, SEEK_CUR);
+        lseek(fileno(scratch), 0, SEEK_SET);
+
+        std::string text(length > 0 ? length : 0, '\0');
+        long done = 0;
+        while (done < length) {
+            int got = (int)read(fileno(scratch), &text[done], (unsigned int)(length - done));
+            if (got <= 0)
+                break;
+            done += got;
+        }
+        text.resize(done);
+
+        return text;
+    }
+
+private:
+    FILE* stream;
+    FILE* scratch;
+    int savedFd;
+};
+
+//
+// Persistent mode: keep the process (and its builtin symbol tables) alive,
+// and run one command line per request frame read from stdin.
+//
+int ServerMain(char* executableName)
+{
+    ServerMode = true;
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    // responses go to the original stdout; fd 1 itself is redirected during each request
+    fflush(stdout);
+    FILE* responses = fdopen(dup(fileno(stdout)), "wb");
+    TStreamCapture capturedOut(stdout);
+    TStreamCapture capturedErr(stderr);
+    if (! responses || ! capturedOut.valid() || ! capturedErr.valid()) {
+        fprintf(stderr, "%s: Error unable to set up server mode\n", executableName);
+        return EFailUsage;
+    }
+
+    ShInitialize();
+
+    // TShader leaves its own (soon deleted) pool installed as the thread's
+    // allocator, which the handle-based path would then pick up; put the
+    // thread's original pool back after every request
+    glslang::TPoolAllocator& threadPool = glslang::GetThreadPoolAllocator();
+
+    std::vector<char> request;
+    unsigned int length;
+    while (ReadFrameLength(stdin, length) && length > 0) {
+        request.resize(length);
+        if (! ReadFully(stdin, request.data(), length))
+            break;
+
+        // rebuild argv from the NUL-terminated arguments; the strings must outlive
+        // the run, as the option globals point into them
+        std::vector<std::string> args(1, executableName);
+        size_t start = 0;
+        for (size_t c = 0; c < request.size(); ++c) {
+            if (request[c] == '\0') {
+                args.push_back(std::string(&request[start], c - start));
+                start = c + 1;
+            }
+        }
+        std::vector<char*> argv;
+        for (auto& arg : args)
+            argv.push_back(&arg[0]);
+        argv.push_back(nullptr);
+
+        capturedOut.begin();
+        capturedErr.begin();
+
+        int code;
+        try {
+            code = RunCommandLine((int)args.size(), argv.data());
+        } catch (const TRequestExit& e) {
+            code = e.code;
+        }
+        std::cout.flush();
+
+        std::string out = capturedOut.end();
+        std::string err = capturedErr.end();
+
+        ResetRunState();
+        glslang::SetThreadPoolAllocator(threadPool);
+
+        std::string response;
+        AppendFrameLength(response, 4 + 4 + out.size() + 4 + err.size());
+        AppendFrameLength(response, (size_t)code);
+        AppendFrameLength(response, out.size());
+        response += out;
+        AppendFrameLength(response, err.size());
+        response += err;
+
+        if (fwrite(response.data(), 1, response.size(), responses) != response.size() || fflush(responses) != 0)
+            break;
+    }
+
+    ShFinalize();
+    fclose(responses);
+
+    return ESuccess;
+}
+
+int C_DECL main(int argc, char* argv[])
+{
+    if (argc == 2 && strcmp(argv[1], "--server") == 0)
+        return ServerMain(argv[0]);
+
+    return RunCommandLine(argc, argv);
+}
+
 //
 //   Deduce the language from the filename.  Files must end in one of the
 //   following extensions:
@@ -831,9 +1128,17 @@ void usage()
            "  -v          print version strings\n"
            "  -w          suppress warnings (except as required by #extension : warn)\n"
            "  -x          save 32-bit hexadecimal numbers as text, requires a binary option (e.g., -V)\n"
+           "\n"
+           "  --server    persistent mode, must be the only argument; reads requests from stdin\n"
+           "              and writes responses to stdout, each framed as a 32-bit little-endian\n"
+           "              byte count followed by that many bytes.  A request holds the\n"
+           "              arguments for one run, each terminated by a NUL byte; the response\n"
+           "              holds the exit code, then the byte count and text of stdout, then\n"
+           "              the byte count and text of stderr.  An empty request or end-of-file\n"
+           "              stops the server.\n"
            );
 
-    exit(EFailUsage);
+    Exit(EFailUsage);
 }
 
 #if !defined _MSC_VER && !defined MINGW_HAS_SECURE_API
@@ -69,8 +69,10 @@ namespace glslang {
         {
             GetGlobalLock();
             
-            if (worklist.empty())
+            if (worklist.empty()) {
+                ReleaseGlobalLock();
                 return false;
+            }
             item = worklist.front();
             worklist.pop_front();
             
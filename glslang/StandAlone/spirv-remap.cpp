@@ -36,8 +36,14 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <cstdio>
 #include <stdexcept>
 
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#endif
+
 #include "../SPIRV/SPVRemapper.h"
 
 namespace {
@@ -148,6 +154,15 @@ namespace {
             << " --input | -i file1 [file2...] --output|-o DESTDIR"
             << std::endl;
 
+        std::cout << "  " << basename(name)
+            << " --server [remap options...]"
+            << std::endl;
+        std::cout << "      Persistent mode: instead of files, read SPIR-V modules from stdin and write the" << std::endl
+                  << "      remapped modules to stdout.  Each module is framed as a 32-bit little-endian byte" << std::endl
+                  << "      count followed by the module words.  Each response frame holds a 32-bit status" << std::endl
+                  << "      word (0 on success) followed by the remapped module, or by the error text on" << std::endl
+                  << "      failure.  An empty frame or end-of-file stops the server." << std::endl;
+
         std::cout << "  " << basename(name) << " [--version | -V]" << std::endl;
         std::cout << "  " << basename(name) << " [--help | -?]" << std::endl;
 
@@ -177,13 +192,15 @@ namespace {
     void parseCmdLine(int argc, char** argv, std::vector<std::string>& inputFile,
         std::string& outputDir,
         int& options,
-        int& verbosity)
+        int& verbosity,
+        bool& server)
     {
         if (argc < 2)
             usage(argv[0]);
 
         verbosity  = 0;
         options    = spv::spirvbin_t::NONE;
+        server     = false;
 
         // Parse command line.
         // boost::program_options would be quite a bit nicer, but we don't want to
@@ -233,6 +250,9 @@ namespace {
                 // Collect input files
                 for (++a; a < argc && argv[a][0] != '-'; ++a)
                     inputFile.push_back(argv[a]);
+            } else if (arg == "--server") {
+                ++a;
+                server = true;
             } else if (arg == "--do-everything") {
                 ++a;
                 options = options | spv::spirvbin_t::DO_EVERYTHING;
@@ -309,6 +329,76 @@ namespace {
         }
     }
 
+    // Read exactly 'size' bytes from stdin; false on end-of-file or error.
+    bool readFully(void* data, size_t size)
+    {
+        return size == 0 || fread(data, 1, size, stdin) == size;
+    }
+
+    void appendWord(std::string& out, std::uint32_t word)
+    {
+        for (int b = 0; b < 4; ++b)
+            out.push_back(char((word >> (8 * b)) & 0xff));
+    }
+
+    // Persistent mode: remap each module framed on stdin, and frame the result
+    // back on stdout.  Nothing touches the disk.
+    void serve(int opts, int verbosity)
+    {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+        // stdout carries the responses, so failures throw to the request loop
+        // and log messages go to stderr
+        spv::spirvbin_t::registerErrorHandler([](const std::string& str) { throw std::runtime_error(str); });
+        spv::spirvbin_t::registerLogHandler([](const std::string& str) { std::cerr << str << std::endl; });
+
+        std::vector<SpvWord> spv;
+        std::string          response;
+
+        for (;;) {
+            unsigned char header[4];
+            if (!readFully(header, sizeof(header)))
+                break;
+
+            const size_t length = header[0] | (header[1] << 8) | (header[2] << 16) | (size_t(header[3]) << 24);
+            if (length == 0)
+                break;
+
+            spv.resize((length + sizeof(SpvWord) - 1) / sizeof(SpvWord));
+            if (!readFully(spv.data(), length))
+                break;
+
+            std::uint32_t status = 0;
+            std::string   errorText;
+
+            try {
+                if (length % sizeof(SpvWord) != 0)
+                    throw std::runtime_error("module size is not a whole number of words");
+
+                spv::spirvbin_t(verbosity).remap(spv, opts);
+            } catch (const std::exception& e) {
+                status    = 5;
+                errorText = e.what();
+            }
+
+            const size_t payloadSize = status == 0 ? spv.size() * sizeof(SpvWord) : errorText.size();
+
+            response.clear();
+            appendWord(response, std::uint32_t(sizeof(status) + payloadSize));
+            appendWord(response, status);
+            if (status == 0)
+                response.append(reinterpret_cast<const char*>(spv.data()), payloadSize);
+            else
+                response += errorText;
+
+            if (fwrite(response.data(), 1, response.size(), stdout) != response.size() || fflush(stdout) != 0)
+                break;
+        }
+    }
+
 } // namespace
 
 
@@ -318,6 +408,7 @@ int main(int argc, char** argv)
     std::string              outputDir;
     int                      opts;
     int                      verbosity;
+    bool                     server;
 
 #ifdef use_cpp11
     // handle errors by exiting
@@ -330,7 +421,15 @@ int main(int argc, char** argv)
     if (argc < 2)
         usage(argv[0]);
 
-    parseCmdLine(argc, argv, inputFile, outputDir, opts, verbosity);
+    parseCmdLine(argc, argv, inputFile, outputDir, opts, verbosity, server);
+
+    if (server) {
+        if (!inputFile.empty() || !outputDir.empty())
+            usage(argv[0], "--server takes no input files or output directory");
+
+        serve(opts, verbosity);
+        return 0;
+    }
 
     if (outputDir.empty())
         usage(argv[0], "Output directory required");
@@ -0,0 +1,43 @@
+#version 450
+#extension GL_ARB_gpu_shader_int64 : enable
+
+layout(location = 0) flat in int index;
+
+void main()
+{
+    // int64 divisors with all of their low 32 bits zero are not zero
+    int64_t i64Div[4] = int64_t[4](
+        0x700000000l / 0x100000000l,                // 7
+        5l / 0x100000000l,                          // 0
+        -0x700000000l / 0x100000000l,               // -7
+        0x7FFFFFFFFFFFFFFFl / -0x100000000l);       // -2147483647
+    uint64_t u64Div[2] = uint64_t[2](
+        0x700000000ul / 0x100000000ul,              // 7
+        0xFFFFFFFFFFFFFFFFul / 0x8000000000000000ul); // 1
+
+    // ... and so their modulus is taken, rather than the dividend left alone
+    int64_t i64Mod = 0x700000005l % 0x100000000l;   // 5
+    uint64_t u64Mod = 0x700000005ul % 0x100000000ul; // 5
+
+    // Division and modulus by zero
+    ivec2 iZero = ivec2(7, -7) / ivec2(0);          // 0x7FFFFFFF, 0x7FFFFFFF
+    uvec2 uZero = uvec2(7u) / uvec2(0u);            // 0xFFFFFFFF
+    int64_t i64Zero = 7l / 0l;                      // 0x7FFFFFFFFFFFFFFF
+    uint64_t u64Zero = 7ul / 0ul;                   // 0xFFFFFFFFFFFFFFFF
+    ivec2 iModZero = ivec2(7, -7) % ivec2(0);       // 7, -7
+    int64_t i64ModZero = 7l % 0l;                   // 7
+
+    // The minimum divided by -1 wraps, and its modulus by -1 is 0
+    int iMinDiv = (-2147483647 - 1) / -1;           // -2147483648
+    int iMinMod = (-2147483647 - 1) % -1;           // 0
+    int64_t i64MinDiv = (-0x7FFFFFFFFFFFFFFFl - 1l) / -1l;   // -9223372036854775808
+    int64_t i64MinMod = (-0x7FFFFFFFFFFFFFFFl - 1l) % -1l;   // 0
+
+    // Modulus by -1 is 0 for any signed dividend, per component
+    ivec4 iMod = ivec4(7, -7, 0, 2147483647) % ivec4(-1);    // 0, 0, 0, 0
+    int64_t i64ModMinus1[2] = int64_t[2](7l % -1l, -7l % -1l); // 0, 0
+
+    // ... while unsigned -1 is just the largest value
+    uvec2 uMod = uvec2(7u, 0xFFFFFFFFu) % uvec2(0xFFFFFFFFu);  // 7, 0
+    uint64_t u64ModMax = 7ul % 0xFFFFFFFFFFFFFFFFul;           // 7
+}
@@ -0,0 +1,16 @@
+#version 450
+
+layout(location=0) in vec4 locMismatch;   // error: vec3 out, vec4 in
+layout(location=1) in vec4 renamed;       // matched by location, names needn't match
+in vec4 nameMismatch;                     // error: vec2 out, vec4 in
+in vec4 nameMatch;
+in Block { vec4 member; } instance;       // matched by block name
+in vec4 missingUsed;                      // error: read, but not written by the vertex stage
+in vec4 missingUnused;                    // not read, so needs no output
+
+layout(location=0) out vec4 color;
+
+void main()
+{
+    color = locMismatch + renamed + nameMismatch + nameMatch + instance.member + missingUsed;
+}
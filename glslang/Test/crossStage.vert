@@ -0,0 +1,17 @@
+#version 450
+
+layout(location=0) out vec3 locMismatch;
+layout(location=1) out vec4 locRenamed;
+out vec2 nameMismatch;
+out vec4 nameMatch;
+out Block { vec4 member; } block;
+
+void main()
+{
+    locMismatch = vec3(1.0);
+    locRenamed = vec4(1.0);
+    nameMismatch = vec2(1.0);
+    nameMatch = vec4(1.0);
+    block.member = vec4(1.0);
+    gl_Position = vec4(0.0);
+}
@@ -0,0 +1,10 @@
+#version 450
+
+in vec4 color;
+
+layout(location=0) out vec4 fragColor;
+
+void main()
+{
+    fragColor = color;
+}
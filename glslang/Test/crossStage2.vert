@@ -0,0 +1,13 @@
+#version 450
+
+out Block { vec4 member; } block;
+out vec2 uv;
+out vec3 normal;
+
+void main()
+{
+    block.member = vec4(1.0);
+    uv = vec2(0.0);
+    normal = vec3(0.0);
+    gl_Position = vec4(0.0);
+}
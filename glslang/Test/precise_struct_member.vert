@@ -0,0 +1,21 @@
+#version 450
+
+// Members 1 and 10 of a struct have access chains where one is a textual
+// prefix of the other, but only the assignment to member 1 is precise.
+struct S {
+  float m0; float m1; float m2; float m3; float m4; float m5;
+  float m6; float m7; float m8; float m9; float m10;
+};
+
+uniform float a, b, c;
+out float o;
+
+void main()
+{
+  precise S s;
+  S t;
+  t.m1 = a * b + c;
+  t.m10 = a * c + b;
+  s.m1 = t.m1;
+  o = t.m10;
+}
@@ -37,6 +37,8 @@
 #ifndef _CONSTANT_UNION_INCLUDED_
 #define _CONSTANT_UNION_INCLUDED_
 
+#include <atomic>
+
 namespace glslang {
 
 class TConstUnion {
@@ -537,6 +539,24 @@ private:
     TBasicType type;
 };
 
+// The components of one or more TConstUnionArrays, which share them rather than
+// each having a copy.  refCount is the number of arrays using the storage; arrays
+// that are pool allocated are never destroyed, so it can be higher than the number
+// still in use, but never lower.
+struct TConstUnionStorage {
+    POOL_ALLOCATOR_NEW_DELETE(GetThreadPoolAllocator())
+
+    explicit TConstUnionStorage(int size) : components(size), refCount(0) { }
+    TConstUnionStorage(int size, const TConstUnion& val) : components(size, val), refCount(0) { }
+
+    TVector<TConstUnion> components;
+    std::atomic<int> refCount;
+
+private:
+    TConstUnionStorage(const TConstUnionStorage&);
+    TConstUnionStorage& operator=(const TConstUnionStorage&);
+};
+
 // Encapsulate having a pointer to an array of TConstUnion,
 // which only needs to be allocated if it's size is going to be
 // bigger than 0.
@@ -547,69 +567,142 @@ private:
 // General usage is that the size is known up front, and it is 
 // created once with the proper size.
 //
+// Copies share the components rather than copying them, and so do views of
+// part of an array (e.g., one element of a constant array), so a write through
+// one is seen by all of them.  Call makeUnique() before writing to an array that
+// might be shared with others that must not change.
+//
 class TConstUnionArray {
 public:
     POOL_ALLOCATOR_NEW_DELETE(GetThreadPoolAllocator())
 
-    TConstUnionArray() : unionArray(nullptr) { }
-    virtual ~TConstUnionArray() { }
+    TConstUnionArray() : storage(nullptr), start(0), count(0) { }
+    virtual ~TConstUnionArray() { release(); }
 
-    explicit TConstUnionArray(int size)
+    explicit TConstUnionArray(int size) : storage(nullptr), start(0), count(size)
     {
-        if (size == 0)
-            unionArray = nullptr;
-        else
-            unionArray =  new TConstUnionVector(size);
+        if (size != 0)
+            acquire(new TConstUnionStorage(size));
     }
-    TConstUnionArray(const TConstUnionArray& a) : unionArray(a.unionArray) { }
-    TConstUnionArray(const TConstUnionArray& a, int start, int size)
+    TConstUnionArray(const TConstUnionArray& a) : storage(nullptr), start(a.start), count(a.count)
     {
-        unionArray = new TConstUnionVector(size);
-        for (int i = 0; i < size; ++i)
-            (*unionArray)[i] = a[start + i];
+        acquire(a.storage);
+    }
+
+    // A view of size components of a, starting at offset, sharing a's components
+    TConstUnionArray(const TConstUnionArray& a, int offset, int size) : storage(nullptr), start(a.start + offset), count(size)
+    {
+        acquire(a.storage);
+        sharedBytes() += bytes(size);
     }
 
     // Use this constructor for a smear operation
-    TConstUnionArray(int size, const TConstUnion& val)
+    TConstUnionArray(int size, const TConstUnion& val) : storage(nullptr), start(0), count(size)
     {
-        unionArray = new TConstUnionVector(size, val);
+        acquire(new TConstUnionStorage(size, val));
     }
 
-    int size() const { return unionArray ? (int)unionArray->size() : 0; }
-    TConstUnion& operator[](size_t index) { return (*unionArray)[index]; }
-    const TConstUnion& operator[](size_t index) const { return (*unionArray)[index]; }
+    TConstUnionArray& operator=(const TConstUnionArray& a)
+    {
+        if (a.storage != storage) {
+            release();
+            acquire(a.storage);
+        }
+        start = a.start;
+        count = a.count;
+
+        return *this;
+    }
+
+    int size() const { return count; }
+    TConstUnion& operator[](size_t index) { return storage->components[start + index]; }
+    const TConstUnion& operator[](size_t index) const { return storage->components[start + index]; }
     bool operator==(const TConstUnionArray& rhs) const
     {
         // this includes the case that both are unallocated
-        if (unionArray == rhs.unionArray)
+        if (storage == rhs.storage && start == rhs.start && count == rhs.count)
             return true;
 
-        if (! unionArray || ! rhs.unionArray)
+        if (! storage || ! rhs.storage)
             return false;
 
-        if (! unionArray || ! rhs.unionArray)
+        if (count != rhs.count)
             return false;
 
-        return *unionArray == *rhs.unionArray;
+        for (int i = 0; i < count; ++i) {
+            if ((*this)[i] != rhs[i])
+                return false;
+        }
+
+        return true;
     }
     bool operator!=(const TConstUnionArray& rhs) const { return ! operator==(rhs); }
 
     double dot(const TConstUnionArray& rhs)
     {
-        assert(rhs.unionArray->size() == unionArray->size());
+        assert(rhs.count == count);
         double sum = 0.0;
 
-        for (size_t comp = 0; comp < unionArray->size(); ++comp)
+        for (int comp = 0; comp < count; ++comp)
             sum += (*this)[comp].getDConst() * rhs[comp].getDConst();
 
         return sum;
     }
 
-    bool empty() const { return unionArray == nullptr; }
+    bool empty() const { return storage == nullptr; }
+
+    // Give this array components of its own, copying them if the storage is shared
+    // with another array, or holds more than this array's view of it.
+    void makeUnique()
+    {
+        if (storage == nullptr || (storage->refCount == 1 && start == 0 && count == (int)storage->components.size()))
+            return;
+
+        TConstUnionStorage* unique = new TConstUnionStorage(count);
+        for (int i = 0; i < count; ++i)
+            unique->components[i] = (*this)[i];
+
+        release();
+        acquire(unique);
+        start = 0;
+    }
+
+    // Memory accounting, across all threads: the bytes of components allocated, and
+    // the bytes that views shared rather than copied.
+    static unsigned long long getAllocatedBytes() { return allocatedBytes(); }
+    static unsigned long long getSharedBytes() { return sharedBytes(); }
 
 protected:
-    typedef TVector<TConstUnion> TConstUnionVector;
-    TConstUnionVector* unionArray;
+    void acquire(TConstUnionStorage* s)
+    {
+        storage = s;
+        if (storage == nullptr)
+            return;
+        if (storage->refCount++ == 0)
+            allocatedBytes() += bytes((int)storage->components.size());
+    }
+    void release()
+    {
+        if (storage != nullptr)
+            --storage->refCount;
+        storage = nullptr;
+    }
+
+    static unsigned long long bytes(int size) { return size * (unsigned long long)sizeof(TConstUnion); }
+    static std::atomic<unsigned long long>& allocatedBytes()
+    {
+        static std::atomic<unsigned long long> allocated(0);
+        return allocated;
+    }
+    static std::atomic<unsigned long long>& sharedBytes()
+    {
+        static std::atomic<unsigned long long> shared(0);
+        return shared;
+    }
+
+    TConstUnionStorage* storage;
+    int start;
+    int count;
 };
 
 } // end namespace glslang
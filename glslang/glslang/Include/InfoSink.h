@@ -37,6 +37,7 @@
 
 #include "../Include/Common.h"
 #include <cmath>
+#include <vector>
 
 namespace glslang {
 
@@ -59,6 +60,31 @@ enum TOutputStream {
     EStdOut = 0x02,
     EString = 0x04,
 };
+
+//
+// A diagnostic kept in structured form, so that clients can read its parts
+// instead of parsing the log text.  'reason' is the message itself (in
+// practice a fixed string for each kind of diagnostic), while 'token' and
+// 'extraInfo' are its arguments; diagnostics reported through message()
+// have only a reason.
+//
+// This is for the structured output, not for speed: 'extraInfo' is still
+// formatted from its printf-style arguments when the diagnostic is
+// reported, and each entry keeps copies of its strings.
+//
+struct TDiagnostic {
+    TPrefixType severity;
+    TPersistString name;      // the source string's name, empty if it has none
+    int string;
+    int line;
+    int column;
+    bool hasToken;
+    TPersistString token;
+    TPersistString reason;
+    TPersistString extraInfo;
+    size_t offset;            // where in the rest of the log text it was reported
+};
+
 //
 // Encapsulate info logs for all objects that have them.
 //
@@ -67,8 +93,8 @@ enum TOutputStream {
 //
 class TInfoSinkBase {
 public:
-    TInfoSinkBase() : outputStream(4) {}
-    void erase() { sink.erase(); }
+    TInfoSinkBase() : outputStream(4), renderedSinkSize(0), renderedCount(0) {}
+    void erase() { sink.erase(); diagnostics.clear(); rendered.erase(); renderedSinkSize = 0; renderedCount = 0; }
     TInfoSinkBase& operator<<(const TPersistString& t) { append(t); return *this; }
     TInfoSinkBase& operator<<(char c)                  { append(1, c); return *this; }
     TInfoSinkBase& operator<<(const char* s)           { append(s); return *this; }
@@ -83,18 +109,23 @@ public:
     TInfoSinkBase& operator+(const TString& t)         { append(t); return *this; }
     TInfoSinkBase& operator<<(const TString& t)        { append(t); return *this; }
     TInfoSinkBase& operator+(const char* s)            { append(s); return *this; }
-    const char* c_str() const { return sink.c_str(); }
-    void prefix(TPrefixType message) {
+    // Returns the log text, rendering any structured diagnostics into it.
+    // The rendered text is cached in the sink, so although this is const, it
+    // is not safe to call concurrently on the same sink (nor while anything
+    // is being added to it).
+    const char* c_str() const;
+    static const char* prefixText(TPrefixType message) {
         switch(message) {
-        case EPrefixNone:                                      break;
-        case EPrefixWarning:       append("WARNING: ");        break;
-        case EPrefixError:         append("ERROR: ");          break;
-        case EPrefixInternalError: append("INTERNAL ERROR: "); break;
-        case EPrefixUnimplemented: append("UNIMPLEMENTED: ");  break;
-        case EPrefixNote:          append("NOTE: ");           break;
-        default:                   append("UNKNOWN ERROR: ");   break;
+        case EPrefixNone:          return "";
+        case EPrefixWarning:       return "WARNING: ";
+        case EPrefixError:         return "ERROR: ";
+        case EPrefixInternalError: return "INTERNAL ERROR: ";
+        case EPrefixUnimplemented: return "UNIMPLEMENTED: ";
+        case EPrefixNote:          return "NOTE: ";
+        default:                   return "UNKNOWN ERROR: ";
         }
     }
+    void prefix(TPrefixType message) { append(prefixText(message)); }
     void location(const TSourceLoc& loc) {
         const int maxSize = 24;
         char locText[maxSize];
@@ -109,11 +140,16 @@ public:
         append("\n");
     }
     void message(TPrefixType message, const char* s, const TSourceLoc& loc) {
-        prefix(message);
-        location(loc);
-        append(s);
-        append("\n");
+        diagnostic(message, loc, nullptr, s, nullptr);
     }
+
+    // Reports a diagnostic of the form "'token' : reason extraInfo", or just
+    // "reason" if token is null.  It is recorded as a TDiagnostic, and merged
+    // into the text by c_str(), unless the sink also writes somewhere other
+    // than the string, in which case it is written out as text right away.
+    void diagnostic(TPrefixType message, const TSourceLoc& loc, const char* token, const char* reason,
+                    const char* extraInfo);
+    const std::vector<TDiagnostic>& getDiagnostics() const { return diagnostics; }
     
     void setOutputStream(int output = 4)
     {
@@ -130,8 +166,16 @@ protected:
     void checkMem(size_t growth) { if (sink.capacity() < sink.size() + growth + 2)  
                                        sink.reserve(sink.capacity() +  sink.capacity() / 2); }
     void appendToStream(const char* s);
+    static void render(TPersistString& out, const TDiagnostic&);
     TPersistString sink;
     int outputStream;
+    std::vector<TDiagnostic> diagnostics;
+
+    // the sink with the diagnostics merged in, as of the last c_str() (which
+    // fills these in without any locking)
+    mutable TPersistString rendered;
+    mutable size_t renderedSinkSize;
+    mutable size_t renderedCount;
 };
 
 } // end namespace glslang
@@ -234,6 +234,19 @@ struct TTypeLoc {
 };
 typedef TVector<TTypeLoc> TTypeList;
 
+//
+// The strings for the type of a structure member, built once when the structure
+// is complete rather than on every function-call lookup or tree dump.  Only
+// structures (not blocks) have them, as nothing changes their members' types
+// after declaration.
+//
+struct TMemberStrings {
+    POOL_ALLOCATOR_NEW_DELETE(GetThreadPoolAllocator())
+
+    TString mangledName;        // from buildMangledName()
+    TString completeString;     // from getCompleteString()
+};
+
 typedef TVector<TString*> TIdentifierList;
 
 //
@@ -1059,7 +1072,7 @@ public:
     explicit TType(TBasicType t = EbtVoid, TStorageQualifier q = EvqTemporary, int vs = 1, int mc = 0, int mr = 0,
                    bool isVector = false) :
                             basicType(t), vectorSize(vs), matrixCols(mc), matrixRows(mr), vector1(isVector && vs == 1),
-                            arraySizes(nullptr), structure(nullptr), fieldName(nullptr), typeName(nullptr)
+                            arraySizes(nullptr), structure(nullptr), fieldName(nullptr), typeName(nullptr), memberStrings(nullptr)
                             {
                                 sampler.clear();
                                 qualifier.clear();
@@ -1069,7 +1082,7 @@ public:
     TType(TBasicType t, TStorageQualifier q, TPrecisionQualifier p, int vs = 1, int mc = 0, int mr = 0, 
           bool isVector = false) :
                             basicType(t), vectorSize(vs), matrixCols(mc), matrixRows(mr), vector1(isVector && vs == 1),
-                            arraySizes(nullptr), structure(nullptr), fieldName(nullptr), typeName(nullptr)
+                            arraySizes(nullptr), structure(nullptr), fieldName(nullptr), typeName(nullptr), memberStrings(nullptr)
                             {
                                 sampler.clear();
                                 qualifier.clear();
@@ -1081,7 +1094,7 @@ public:
     explicit TType(const TPublicType& p) :
                             basicType(p.basicType),
                             vectorSize(p.vectorSize), matrixCols(p.matrixCols), matrixRows(p.matrixRows), vector1(false),
-                            arraySizes(p.arraySizes), structure(nullptr), fieldName(nullptr), typeName(nullptr)
+                            arraySizes(p.arraySizes), structure(nullptr), fieldName(nullptr), typeName(nullptr), memberStrings(nullptr)
                             {
                                 if (basicType == EbtSampler)
                                     sampler = p.sampler;
@@ -1097,7 +1110,7 @@ public:
     TType(const TSampler& sampler, TStorageQualifier q = EvqUniform, TArraySizes* as = nullptr) :
         basicType(EbtSampler), vectorSize(1), matrixCols(0), matrixRows(0), vector1(false),
         arraySizes(as), structure(nullptr), fieldName(nullptr), typeName(nullptr),
-        sampler(sampler)
+        sampler(sampler), memberStrings(nullptr)
     {
         qualifier.clear();
         qualifier.storage = q;
@@ -1144,7 +1157,7 @@ public:
     // for making structures, ...
     TType(TTypeList* userDef, const TString& n) :
                             basicType(EbtStruct), vectorSize(1), matrixCols(0), matrixRows(0), vector1(false),
-                            arraySizes(nullptr), structure(userDef), fieldName(nullptr)
+                            arraySizes(nullptr), structure(userDef), fieldName(nullptr), memberStrings(nullptr)
                             {
                                 sampler.clear();
                                 qualifier.clear();
@@ -1153,7 +1166,7 @@ public:
     // For interface blocks
     TType(TTypeList* userDef, const TString& n, const TQualifier& q) :
                             basicType(EbtBlock), vectorSize(1), matrixCols(0), matrixRows(0), vector1(false),
-                            qualifier(q), arraySizes(nullptr), structure(userDef), fieldName(nullptr)
+                            qualifier(q), arraySizes(nullptr), structure(userDef), fieldName(nullptr), memberStrings(nullptr)
                             {
                                 sampler.clear();
                                 typeName = NewPoolTString(n.c_str());
@@ -1176,6 +1189,7 @@ public:
         structure = copyOf.structure;
         fieldName = copyOf.fieldName;
         typeName = copyOf.typeName;
+        memberStrings = nullptr;    // the copy might be changed
     }
 
     void deepCopy(const TType& copyOf)
@@ -1194,6 +1208,13 @@ public:
                 typeLoc.loc = (*copyOf.structure)[i].loc;
                 typeLoc.type = new TType();
                 typeLoc.type->deepCopy(*(*copyOf.structure)[i].type);
+                const TMemberStrings* strings = (*copyOf.structure)[i].type->memberStrings;
+                if (strings) {
+                    // assign rather than copy construct, so they are allocated from this pool
+                    typeLoc.type->memberStrings = new TMemberStrings;
+                    typeLoc.type->memberStrings->mangledName = strings->mangledName;
+                    typeLoc.type->memberStrings->completeString = strings->completeString;
+                }
                 structure->push_back(typeLoc);
             }
         }
@@ -1466,6 +1487,9 @@ public:
 
     TString getCompleteString() const
     {
+        if (memberStrings)
+            return memberStrings->completeString;
+
         const int maxSize = GlslangMaxTypeLength;
         char buf[maxSize];
         char* p = &buf[0];
@@ -1633,6 +1657,20 @@ public:
         return components;
     }
 
+    // Build the strings of a structure's members, once nothing will change them.
+    // Like getWritableStruct(), this changes the members, not this type.
+    void buildMemberStrings() const
+    {
+        assert(basicType == EbtStruct);
+        for (unsigned int i = 0; i < structure->size(); ++i) {
+            TType& member = *(*structure)[i].type;
+            TMemberStrings* strings = new TMemberStrings;
+            member.buildMangledName(strings->mangledName);
+            strings->completeString = member.getCompleteString();
+            member.memberStrings = strings;
+        }
+    }
+
     // append this type's mangled name to the passed in 'name'
     void appendMangledName(TString& name)
     {
@@ -1740,6 +1778,7 @@ protected:
     TString *fieldName;         // for structure field names
     TString *typeName;          // for structure type name
     TSampler sampler;
+    TMemberStrings* memberStrings;  // nullptr unless this is the type of a structure member
 };
 
 } // end namespace glslang
@@ -593,6 +593,7 @@ class TIntermBranch;
 class TIntermTyped;
 class TIntermMethod;
 class TIntermSymbol;
+class TIntermLoop;
 
 } // end namespace glslang
 
@@ -620,6 +621,7 @@ public:
     virtual       glslang::TIntermMethod*        getAsMethodNode()          { return 0; }
     virtual       glslang::TIntermSymbol*        getAsSymbolNode()          { return 0; }
     virtual       glslang::TIntermBranch*        getAsBranchNode()          { return 0; }
+    virtual       glslang::TIntermLoop*          getAsLoopNode()            { return 0; }
 
     virtual const glslang::TIntermTyped*         getAsTyped()         const { return 0; }
     virtual const glslang::TIntermOperator*      getAsOperator()      const { return 0; }
@@ -632,6 +634,7 @@ public:
     virtual const glslang::TIntermMethod*        getAsMethodNode()    const { return 0; }
     virtual const glslang::TIntermSymbol*        getAsSymbolNode()    const { return 0; }
     virtual const glslang::TIntermBranch*        getAsBranchNode()    const { return 0; }
+    virtual const glslang::TIntermLoop*          getAsLoopNode()      const { return 0; }
     virtual ~TIntermNode() { }
 
 protected:
@@ -692,6 +695,8 @@ public:
         test(aTest),
         terminal(aTerminal),
         first(testFirst) { }
+    virtual       TIntermLoop* getAsLoopNode()       { return this; }
+    virtual const TIntermLoop* getAsLoopNode() const { return this; }
     virtual void traverse(TIntermTraverser*);
     TIntermNode*  getBody() const { return body; }
     TIntermTyped* getTest() const { return test; }
@@ -1165,6 +1170,12 @@ public:
         return path.size() == 0 ? NULL : path.back();
     }
 
+    // Traverse the subtree at 'root'; this is what the nodes' traverse() do.
+    // It keeps the nodes whose children are being traversed on an explicit
+    // stack, rather than recursing, so a deep tree can't exhaust the thread's
+    // stack.  A visit function can still traverse() a child itself.
+    void traverseSubtree(TIntermNode* root);
+
     const bool preVisit;
     const bool inVisit;
     const bool postVisit;
@@ -1178,6 +1189,23 @@ protected:
 
     // All the nodes from root to the current node's parent during traversing.
     TVector<TIntermNode *> path;
+
+private:
+    enum TWalkKind { EwkBinary, EwkUnary, EwkAggregate, EwkSelection, EwkLoop, EwkBranch, EwkSwitch };
+
+    // A node whose children are being traversed.
+    struct TWalkFrame {
+        TIntermNode* node;
+        TWalkKind kind;
+        int step;       // how many of its children have been traversed
+        bool visit;     // false once an in-visit has cut off the rest of its children
+    };
+
+    void enterNode(TIntermNode*);
+    TIntermNode* nextChild(size_t frame, bool& done);
+    void leaveNode();
+
+    TVector<TWalkFrame> walk;
 };
 
 // KHR_vulkan_glsl says "Two arrays sized with specialization constants are the same type only if
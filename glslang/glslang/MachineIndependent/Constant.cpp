@@ -38,6 +38,8 @@
 #include <cmath>
 #include <cfloat>
 #include <cstdlib>
+#include <algorithm>
+#include <limits>
 
 namespace {
 
@@ -74,6 +76,235 @@ bool isInf(double x)
 
 const double pi = 3.1415926535897932384626433832795;
 
+//
+// Folding kernels.
+//
+// TConstUnion's operators switch on the basic type of each component they touch.  The
+// kernels below are instead instantiated per component type: a fold switches on the type
+// once, and then loops over the components with plain arithmetic on one member of the
+// union.  That saves the per-component switch only: writing a component still sets its
+// type too, and components are a whole TConstUnion apart, so the loops don't vectorize.
+//
+
+// Reading and writing the member of a TConstUnion that holds each type of component.
+// (Floats are held as doubles.)
+struct TDoubleComponent {
+    typedef double Value;
+    static double get(const TConstUnion& c) { return c.getDConst(); }
+    static void set(TConstUnion& c, double v) { c.setDConst(v); }
+};
+
+struct TIntComponent {
+    typedef int Value;
+    static int get(const TConstUnion& c) { return c.getIConst(); }
+    static void set(TConstUnion& c, int v) { c.setIConst(v); }
+};
+
+struct TUintComponent {
+    typedef unsigned int Value;
+    static unsigned int get(const TConstUnion& c) { return c.getUConst(); }
+    static void set(TConstUnion& c, unsigned int v) { c.setUConst(v); }
+};
+
+struct TInt64Component {
+    typedef long long Value;
+    static long long get(const TConstUnion& c) { return c.getI64Const(); }
+    static void set(TConstUnion& c, long long v) { c.setI64Const(v); }
+};
+
+struct TUint64Component {
+    typedef unsigned long long Value;
+    static unsigned long long get(const TConstUnion& c) { return c.getU64Const(); }
+    static void set(TConstUnion& c, unsigned long long v) { c.setU64Const(v); }
+};
+
+struct TBoolComponent {
+    typedef bool Value;
+    static bool get(const TConstUnion& c) { return c.getBConst(); }
+    static void set(TConstUnion& c, bool v) { c.setBConst(v); }
+};
+
+// Stands for the operands' own component type, as the result's component type.
+struct TSameComponent;
+
+template<typename In, typename Out> struct TResultComponent { typedef Out Type; };
+template<typename In> struct TResultComponent<In, TSameComponent> { typedef In Type; };
+
+// result[i] = op(operand[i])
+template<typename Out, typename Op>
+struct TUnaryKernel {
+    const TConstUnion* operand;
+    TConstUnion* result;
+    int size;
+    Op op;
+
+    template<typename In>
+    void run() const
+    {
+        typedef typename TResultComponent<In, Out>::Type Result;
+        for (int i = 0; i < size; ++i)
+            Result::set(result[i], op(In::get(operand[i])));
+    }
+};
+
+// result[i] = op(left[i], right[i])
+template<typename Out, typename Op>
+struct TBinaryKernel {
+    const TConstUnion* left;
+    const TConstUnion* right;
+    TConstUnion* result;
+    int size;
+    Op op;
+
+    template<typename In>
+    void run() const
+    {
+        typedef typename TResultComponent<In, Out>::Type Result;
+        for (int i = 0; i < size; ++i)
+            Result::set(result[i], op(In::get(left[i]), In::get(right[i])));
+    }
+};
+
+// An argument of a componentwise built-in; one that is a scalar rather than a vector
+// of the result's size is smeared across the components.
+struct TFoldArgument {
+    const TConstUnion* components;
+    int last;
+
+    const TConstUnion& operator[](int comp) const { return components[std::min(comp, last)]; }
+};
+
+// result[i] = op(args[0][i], args[1][i], args[2][i]), for built-ins of up to three arguments
+template<typename Out, typename Op>
+struct TBuiltInKernel {
+    TFoldArgument args[3];
+    TConstUnion* result;
+    int size;
+    Op op;
+
+    template<typename In>
+    void run() const
+    {
+        typedef typename TResultComponent<In, Out>::Type Result;
+        for (int i = 0; i < size; ++i)
+            Result::set(result[i], op(In::get(args[0][i]), In::get(args[1][i]), In::get(args[2][i])));
+    }
+};
+
+template<typename Out, typename Op>
+TUnaryKernel<Out, Op> unaryKernel(const TConstUnionArray& operand, TConstUnionArray& result, int size, Op op)
+{
+    TUnaryKernel<Out, Op> kernel = { size > 0 ? &operand[0] : nullptr, size > 0 ? &result[0] : nullptr, size, op };
+    return kernel;
+}
+
+template<typename Out, typename Op>
+TBinaryKernel<Out, Op> binaryKernel(const TConstUnionArray& left, const TConstUnionArray& right,
+                                    TConstUnionArray& result, int size, Op op)
+{
+    TBinaryKernel<Out, Op> kernel = { size > 0 ? &left[0] : nullptr, size > 0 ? &right[0] : nullptr,
+                                      size > 0 ? &result[0] : nullptr, size, op };
+    return kernel;
+}
+
+template<typename Out, typename Op>
+TBuiltInKernel<Out, Op> builtInKernel(const TFoldArgument args[3], TConstUnionArray& result, int size, Op op)
+{
+    TBuiltInKernel<Out, Op> kernel = { { args[0], args[1], args[2] }, size > 0 ? &result[0] : nullptr, size, op };
+    return kernel;
+}
+
+// Run a kernel on components of the given type, if it is one the kernel's operation is
+// defined for.  Returns false if it isn't.
+template<typename Kernel>
+bool runOnInteger(TBasicType type, const Kernel& kernel)
+{
+    switch (type) {
+    case EbtInt:    kernel.template run<TIntComponent>();    return true;
+    case EbtUint:   kernel.template run<TUintComponent>();   return true;
+    case EbtInt64:  kernel.template run<TInt64Component>();  return true;
+    case EbtUint64: kernel.template run<TUint64Component>(); return true;
+    default:
+        return false;
+    }
+}
+
+template<typename Kernel>
+bool runOnNumber(TBasicType type, const Kernel& kernel)
+{
+    if (type == EbtDouble) {
+        kernel.template run<TDoubleComponent>();
+        return true;
+    }
+
+    return runOnInteger(type, kernel);
+}
+
+// The operations of the kernels.
+
+struct TAdd { template<typename T> T operator()(T a, T b) const { return a + b; } };
+struct TSub { template<typename T> T operator()(T a, T b) const { return a - b; } };
+struct TMul { template<typename T> T operator()(T a, T b) const { return a * b; } };
+struct TAnd { template<typename T> T operator()(T a, T b) const { return a & b; } };
+struct TOr  { template<typename T> T operator()(T a, T b) const { return a | b; } };
+struct TXor { template<typename T> T operator()(T a, T b) const { return a ^ b; } };
+struct TComplement { template<typename T> T operator()(T a) const { return ~a; } };
+
+// Division by zero gives the largest value of the type, and the one signed overflow wraps.
+struct TDiv {
+    double operator()(double a, double b) const { return a / b; }
+    int operator()(int a, int b) const
+    {
+        if (b == 0)
+            return 0x7FFFFFFF;
+        if (b == -1 && a == (int)0x80000000)
+            return 0x80000000;
+        return a / b;
+    }
+    unsigned int operator()(unsigned int a, unsigned int b) const { return b == 0 ? 0xFFFFFFFF : a / b; }
+    long long operator()(long long a, long long b) const
+    {
+        if (b == 0)
+            return 0x7FFFFFFFFFFFFFFFll;
+        if (b == -1 && a == (long long)0x8000000000000000)
+            return 0x8000000000000000;
+        return a / b;
+    }
+    unsigned long long operator()(unsigned long long a, unsigned long long b) const { return b == 0 ? 0xFFFFFFFFFFFFFFFFull : a / b; }
+};
+
+// Modulus by zero leaves the dividend alone (and by -1 gives 0, rather than overflowing).
+struct TMod {
+    template<typename T> T operator()(T a, T b) const
+    {
+        if (b == 0)
+            return a;
+        if (std::numeric_limits<T>::is_signed && b == static_cast<T>(-1))
+            return 0;
+        return a % b;
+    }
+};
+
+// Unsigned negation is done in 32 bits, as it always has been.
+struct TNegate {
+    double operator()(double a) const { return -a; }
+    int operator()(int a) const { return -a; }
+    unsigned int operator()(unsigned int a) const { return static_cast<unsigned int>(-static_cast<int>(a)); }
+    long long operator()(long long a) const { return -a; }
+    unsigned long long operator()(unsigned long long a) const { return static_cast<unsigned int>(-static_cast<int>(a)); }
+};
+
+struct TMin   { template<typename T> T operator()(T a, T b, T) const { return std::min(a, b); } };
+struct TMax   { template<typename T> T operator()(T a, T b, T) const { return std::max(a, b); } };
+struct TClamp { template<typename T> T operator()(T a, T b, T c) const { return std::min(std::max(a, b), c); } };
+
+struct TLessThan         { template<typename T> bool operator()(T a, T b, T) const { return a < b; } };
+struct TGreaterThan      { template<typename T> bool operator()(T a, T b, T) const { return a > b; } };
+struct TLessThanEqual    { template<typename T> bool operator()(T a, T b, T) const { return ! (a > b); } };
+struct TGreaterThanEqual { template<typename T> bool operator()(T a, T b, T) const { return ! (a < b); } };
+struct TEqual            { template<typename T> bool operator()(T a, T b, T) const { return a == b; } };
+struct TNotEqual         { template<typename T> bool operator()(T a, T b, T) const { return a != b; } };
+
 } // end anonymous namespace
 
 
@@ -144,21 +375,24 @@ TIntermTyped* TIntermConstantUnion::fold(TOperator op, const TIntermTyped* right
     TConstUnionArray newConstArray(newComps);
     TType constBool(EbtBool, EvqConst);
 
+    // the type of the components, for the componentwise kernels
+    TBasicType componentType = newComps > 0 ? leftUnionArray[0].getType() : EbtVoid;
+
     switch(op) {
     case EOpAdd:
-        for (int i = 0; i < newComps; i++)
-            newConstArray[i] = leftUnionArray[i] + rightUnionArray[i];
+        if (! runOnNumber(componentType, binaryKernel<TSameComponent>(leftUnionArray, rightUnionArray, newConstArray, newComps, TAdd())))
+            return 0;
         break;
     case EOpSub:
-        for (int i = 0; i < newComps; i++)
-            newConstArray[i] = leftUnionArray[i] - rightUnionArray[i];
+        if (! runOnNumber(componentType, binaryKernel<TSameComponent>(leftUnionArray, rightUnionArray, newConstArray, newComps, TSub())))
+            return 0;
         break;
 
     case EOpMul:
     case EOpVectorTimesScalar:
     case EOpMatrixTimesScalar:
-        for (int i = 0; i < newComps; i++)
-            newConstArray[i] = leftUnionArray[i] * rightUnionArray[i];
+        if (! runOnNumber(componentType, binaryKernel<TSameComponent>(leftUnionArray, rightUnionArray, newConstArray, newComps, TMul())))
+            return 0;
         break;
     case EOpMatrixTimesMatrix:
         for (int row = 0; row < getMatrixRows(); row++) {
@@ -172,48 +406,8 @@ TIntermTyped* TIntermConstantUnion::fold(TOperator op, const TIntermTyped* right
         returnType.shallowCopy(TType(getType().getBasicType(), EvqConst, 0, rightNode->getMatrixCols(), getMatrixRows()));
         break;
     case EOpDiv:
-        for (int i = 0; i < newComps; i++) {
-            switch (getType().getBasicType()) {
-            case EbtDouble:
-            case EbtFloat:
-                newConstArray[i].setDConst(leftUnionArray[i].getDConst() / rightUnionArray[i].getDConst());
-                break;
-
-            case EbtInt:
-                if (rightUnionArray[i] == 0)
-                    newConstArray[i].setIConst(0x7FFFFFFF);
-                else if (rightUnionArray[i].getIConst() == -1 && leftUnionArray[i].getIConst() == (int)0x80000000)
-                    newConstArray[i].setIConst(0x80000000);
-                else
-                    newConstArray[i].setIConst(leftUnionArray[i].getIConst() / rightUnionArray[i].getIConst());
-                break;
-
-            case EbtUint:
-                if (rightUnionArray[i] == 0) {
-                    newConstArray[i].setUConst(0xFFFFFFFF);
-                } else
-                    newConstArray[i].setUConst(leftUnionArray[i].getUConst() / rightUnionArray[i].getUConst());
-                break;
-
-            case EbtInt64:
-                if (rightUnionArray[i] == 0)
-                    newConstArray[i].setI64Const(0x7FFFFFFFFFFFFFFFll);
-                else if (rightUnionArray[i].getI64Const() == -1 && leftUnionArray[i].getI64Const() == (long long)0x8000000000000000)
-                    newConstArray[i].setI64Const(0x8000000000000000);
-                else
-                    newConstArray[i].setI64Const(leftUnionArray[i].getI64Const() / rightUnionArray[i].getI64Const());
-                break;
-
-            case EbtUint64:
-                if (rightUnionArray[i] == 0) {
-                    newConstArray[i].setU64Const(0xFFFFFFFFFFFFFFFFull);
-                } else
-                    newConstArray[i].setU64Const(leftUnionArray[i].getU64Const() / rightUnionArray[i].getU64Const());
-                break;
-            default:
-                return 0;
-            }
-        }
+        if (! runOnNumber(componentType, binaryKernel<TSameComponent>(leftUnionArray, rightUnionArray, newConstArray, newComps, TDiv())))
+            return 0;
         break;
 
     case EOpMatrixTimesVector:
@@ -240,12 +434,8 @@ TIntermTyped* TIntermConstantUnion::fold(TOperator op, const TIntermTyped* right
         break;
 
     case EOpMod:
-        for (int i = 0; i < newComps; i++) {
-            if (rightUnionArray[i] == 0)
-                newConstArray[i] = leftUnionArray[i];
-            else
-                newConstArray[i] = leftUnionArray[i] % rightUnionArray[i];
-        }
+        if (! runOnInteger(componentType, binaryKernel<TSameComponent>(leftUnionArray, rightUnionArray, newConstArray, newComps, TMod())))
+            return 0;
         break;
 
     case EOpRightShift:
@@ -259,16 +449,16 @@ TIntermTyped* TIntermConstantUnion::fold(TOperator op, const TIntermTyped* right
         break;
 
     case EOpAnd:
-        for (int i = 0; i < newComps; i++)
-            newConstArray[i] = leftUnionArray[i] & rightUnionArray[i];
+        if (! runOnInteger(componentType, binaryKernel<TSameComponent>(leftUnionArray, rightUnionArray, newConstArray, newComps, TAnd())))
+            return 0;
         break;
     case EOpInclusiveOr:
-        for (int i = 0; i < newComps; i++)
-            newConstArray[i] = leftUnionArray[i] | rightUnionArray[i];
+        if (! runOnInteger(componentType, binaryKernel<TSameComponent>(leftUnionArray, rightUnionArray, newConstArray, newComps, TOr())))
+            return 0;
         break;
     case EOpExclusiveOr:
-        for (int i = 0; i < newComps; i++)
-            newConstArray[i] = leftUnionArray[i] ^ rightUnionArray[i];
+        if (! runOnInteger(componentType, binaryKernel<TSameComponent>(leftUnionArray, rightUnionArray, newConstArray, newComps, TXor())))
+            return 0;
         break;
 
     case EOpLogicalAnd: // this code is written for possible future use, will not get executed currently
@@ -440,59 +630,51 @@ TIntermTyped* TIntermConstantUnion::fold(TOperator op, const TType& returnType)
         break;
     }
 
-    // Turn off the componentwise loop
+    // Turn off the componentwise kernels
     if (! componentWise)
         objectSize = 0;
 
     // Process component-wise operations
-    for (int i = 0; i < objectSize; i++) {
+    if (objectSize > 0) {
+        TBasicType componentType = unionArray[0].getType();
+        bool folded = true;
+
         switch (op) {
         case EOpNegative:
-            switch (getType().getBasicType()) {
-            case EbtDouble:
-            case EbtFloat: newConstArray[i].setDConst(-unionArray[i].getDConst()); break;
-            case EbtInt:   newConstArray[i].setIConst(-unionArray[i].getIConst()); break;
-            case EbtUint:  newConstArray[i].setUConst(static_cast<unsigned int>(-static_cast<int>(unionArray[i].getUConst())));  break;
-            case EbtInt64: newConstArray[i].setI64Const(-unionArray[i].getI64Const()); break;
-            case EbtUint64: newConstArray[i].setU64Const(static_cast<unsigned int>(-static_cast<int>(unionArray[i].getU64Const())));  break;
-            default:
-                return 0;
-            }
+            folded = runOnNumber(componentType, unaryKernel<TSameComponent>(unionArray, newConstArray, objectSize, TNegate()));
             break;
         case EOpLogicalNot:
         case EOpVectorLogicalNot:
-            switch (getType().getBasicType()) {
-            case EbtBool:  newConstArray[i].setBConst(!unionArray[i].getBConst()); break;
-            default:
-                return 0;
-            }
+            folded = componentType == EbtBool;
+            if (folded)
+                unaryKernel<TBoolComponent>(unionArray, newConstArray, objectSize, [](bool x) { return ! x; }).run<TBoolComponent>();
             break;
         case EOpBitwiseNot:
-            newConstArray[i] = ~unionArray[i];
+            folded = runOnInteger(componentType, unaryKernel<TSameComponent>(unionArray, newConstArray, objectSize, TComplement()));
             break;
         case EOpRadians:
-            newConstArray[i].setDConst(unionArray[i].getDConst() * pi / 180.0);
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return x * pi / 180.0; }).run<TDoubleComponent>();
             break;
         case EOpDegrees:
-            newConstArray[i].setDConst(unionArray[i].getDConst() * 180.0 / pi);
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return x * 180.0 / pi; }).run<TDoubleComponent>();
             break;
         case EOpSin:
-            newConstArray[i].setDConst(sin(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return sin(x); }).run<TDoubleComponent>();
             break;
         case EOpCos:
-            newConstArray[i].setDConst(cos(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return cos(x); }).run<TDoubleComponent>();
             break;
         case EOpTan:
-            newConstArray[i].setDConst(tan(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return tan(x); }).run<TDoubleComponent>();
             break;
         case EOpAsin:
-            newConstArray[i].setDConst(asin(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return asin(x); }).run<TDoubleComponent>();
             break;
         case EOpAcos:
-            newConstArray[i].setDConst(acos(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return acos(x); }).run<TDoubleComponent>();
             break;
         case EOpAtan:
-            newConstArray[i].setDConst(atan(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return atan(x); }).run<TDoubleComponent>();
             break;
 
         case EOpDPdx:
@@ -505,89 +687,80 @@ TIntermTyped* TIntermConstantUnion::fold(TOperator op, const TType& returnType)
         case EOpDPdyCoarse:
         case EOpFwidthCoarse:
             // The derivatives are all mandated to create a constant 0.
-            newConstArray[i].setDConst(0.0);
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double) { return 0.0; }).run<TDoubleComponent>();
             break;
 
         case EOpExp:
-            newConstArray[i].setDConst(exp(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return exp(x); }).run<TDoubleComponent>();
             break;
         case EOpLog:
-            newConstArray[i].setDConst(log(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return log(x); }).run<TDoubleComponent>();
             break;
         case EOpExp2:
-            {
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) {
                 const double inv_log2_e = 0.69314718055994530941723212145818;
-                newConstArray[i].setDConst(exp(unionArray[i].getDConst() * inv_log2_e));
-                break;
-            }
+                return exp(x * inv_log2_e);
+            }).run<TDoubleComponent>();
+            break;
         case EOpLog2:
-            {
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) {
                 const double log2_e = 1.4426950408889634073599246810019;
-                newConstArray[i].setDConst(log2_e * log(unionArray[i].getDConst()));
-                break;
-            }
+                return log2_e * log(x);
+            }).run<TDoubleComponent>();
+            break;
         case EOpSqrt:
-            newConstArray[i].setDConst(sqrt(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return sqrt(x); }).run<TDoubleComponent>();
             break;
         case EOpInverseSqrt:
-            newConstArray[i].setDConst(1.0 / sqrt(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return 1.0 / sqrt(x); }).run<TDoubleComponent>();
             break;
 
         case EOpAbs:
-            if (unionArray[i].getType() == EbtDouble)
-                newConstArray[i].setDConst(fabs(unionArray[i].getDConst()));
-            else if (unionArray[i].getType() == EbtInt)
-                newConstArray[i].setIConst(abs(unionArray[i].getIConst()));
-            else
-                newConstArray[i] = unionArray[i];
+            if (componentType == EbtDouble)
+                unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return fabs(x); }).run<TDoubleComponent>();
+            else if (componentType == EbtInt)
+                unaryKernel<TIntComponent>(unionArray, newConstArray, objectSize, [](int x) { return abs(x); }).run<TIntComponent>();
+            else {
+                for (int i = 0; i < objectSize; i++)
+                    newConstArray[i] = unionArray[i];
+            }
             break;
         case EOpSign:
             #define SIGN(X) (X == 0 ? 0 : (X < 0 ? -1 : 1))
-            if (unionArray[i].getType() == EbtDouble)
-                newConstArray[i].setDConst(SIGN(unionArray[i].getDConst()));
+            if (componentType == EbtDouble)
+                unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return (double)SIGN(x); }).run<TDoubleComponent>();
             else
-                newConstArray[i].setIConst(SIGN(unionArray[i].getIConst()));
+                unaryKernel<TIntComponent>(unionArray, newConstArray, objectSize, [](int x) { return SIGN(x); }).run<TIntComponent>();
             break;
         case EOpFloor:
-            newConstArray[i].setDConst(floor(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return floor(x); }).run<TDoubleComponent>();
             break;
         case EOpTrunc:
-            if (unionArray[i].getDConst() > 0)
-                newConstArray[i].setDConst(floor(unionArray[i].getDConst()));
-            else
-                newConstArray[i].setDConst(ceil(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return x > 0 ? floor(x) : ceil(x); }).run<TDoubleComponent>();
             break;
         case EOpRound:
-            newConstArray[i].setDConst(floor(0.5 + unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return floor(0.5 + x); }).run<TDoubleComponent>();
             break;
         case EOpRoundEven:
-        {
-            double flr = floor(unionArray[i].getDConst());
-            bool even = flr / 2.0 == floor(flr / 2.0);
-            double rounded = even ? ceil(unionArray[i].getDConst() - 0.5) : floor(unionArray[i].getDConst() + 0.5);
-            newConstArray[i].setDConst(rounded);
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) {
+                double flr = floor(x);
+                bool even = flr / 2.0 == floor(flr / 2.0);
+                return even ? ceil(x - 0.5) : floor(x + 0.5);
+            }).run<TDoubleComponent>();
             break;
-        }
         case EOpCeil:
-            newConstArray[i].setDConst(ceil(unionArray[i].getDConst()));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return ceil(x); }).run<TDoubleComponent>();
             break;
         case EOpFract:
-        {
-            double x = unionArray[i].getDConst();
-            newConstArray[i].setDConst(x - floor(x));
+            unaryKernel<TDoubleComponent>(unionArray, newConstArray, objectSize, [](double x) { return x - floor(x); }).run<TDoubleComponent>();
             break;
-        }
 
         case EOpIsNan:
-        {
-            newConstArray[i].setBConst(isNan(unionArray[i].getDConst()));
+            unaryKernel<TBoolComponent>(unionArray, newConstArray, objectSize, [](double x) { return isNan(x); }).run<TDoubleComponent>();
             break;
-        }
         case EOpIsInf:
-        {
-            newConstArray[i].setBConst(isInf(unionArray[i].getDConst()));
+            unaryKernel<TBoolComponent>(unionArray, newConstArray, objectSize, [](double x) { return isInf(x); }).run<TDoubleComponent>();
             break;
-        }
 
         // TODO: 3.0 Functionality: unary constant folding: the rest of the ops have to be fleshed out
 
@@ -606,8 +779,12 @@ TIntermTyped* TIntermConstantUnion::fold(TOperator op, const TType& returnType)
         case EOpDoubleBitsToUint64:
 
         default:
-            return 0;
+            folded = false;
+            break;
         }
+
+        if (! folded)
+            return 0;
     }
 
     TIntermConstantUnion *newNode = new TIntermConstantUnion(newConstArray, returnType);
@@ -687,125 +864,88 @@ TIntermTyped* TIntermediate::fold(TIntermAggregate* aggrNode)
 
     // Second, do the actual folding
 
-    bool isFloatingPoint = children[0]->getAsTyped()->getBasicType() == EbtFloat ||
-                           children[0]->getAsTyped()->getBasicType() == EbtDouble;
-    bool isSigned = children[0]->getAsTyped()->getBasicType() == EbtInt ||
-                    children[0]->getAsTyped()->getBasicType() == EbtInt64;
-    bool isInt64 = children[0]->getAsTyped()->getBasicType() == EbtInt64 ||
-                   children[0]->getAsTyped()->getBasicType() == EbtUint64;
     if (componentwise) {
-        for (int comp = 0; comp < objectSize; comp++) {
-
-            // some arguments are scalars instead of matching vectors; simulate a smear
-            int arg0comp = std::min(comp, children[0]->getAsTyped()->getType().getVectorSize() - 1);
-            int arg1comp = 0;
-            if (children.size() > 1)
-                arg1comp = std::min(comp, children[1]->getAsTyped()->getType().getVectorSize() - 1);
-            int arg2comp = 0;
-            if (children.size() > 2)
-                arg2comp = std::min(comp, children[2]->getAsTyped()->getType().getVectorSize() - 1);
-
-            switch (aggrNode->getOp()) {
-            case EOpAtan:
-                newConstArray[comp].setDConst(atan2(childConstUnions[0][arg0comp].getDConst(), childConstUnions[1][arg1comp].getDConst()));
-                break;
-            case EOpPow:
-                newConstArray[comp].setDConst(pow(childConstUnions[0][arg0comp].getDConst(), childConstUnions[1][arg1comp].getDConst()));
-                break;
-            case EOpMin:
-                if (isFloatingPoint)
-                    newConstArray[comp].setDConst(std::min(childConstUnions[0][arg0comp].getDConst(), childConstUnions[1][arg1comp].getDConst()));
-                else if (isSigned) {
-                    if (isInt64)
-                        newConstArray[comp].setI64Const(std::min(childConstUnions[0][arg0comp].getI64Const(), childConstUnions[1][arg1comp].getI64Const()));
-                    else
-                        newConstArray[comp].setIConst(std::min(childConstUnions[0][arg0comp].getIConst(), childConstUnions[1][arg1comp].getIConst()));
-                } else {
-                    if (isInt64)
-                        newConstArray[comp].setU64Const(std::min(childConstUnions[0][arg0comp].getU64Const(), childConstUnions[1][arg1comp].getU64Const()));
-                    else
-                        newConstArray[comp].setUConst(std::min(childConstUnions[0][arg0comp].getUConst(), childConstUnions[1][arg1comp].getUConst()));
-                }
-                break;
-            case EOpMax:
-                if (isFloatingPoint)
-                    newConstArray[comp].setDConst(std::max(childConstUnions[0][arg0comp].getDConst(), childConstUnions[1][arg1comp].getDConst()));
-                else if (isSigned) {
-                    if (isInt64)
-                        newConstArray[comp].setI64Const(std::max(childConstUnions[0][arg0comp].getI64Const(), childConstUnions[1][arg1comp].getI64Const()));
-                    else
-                        newConstArray[comp].setIConst(std::max(childConstUnions[0][arg0comp].getIConst(), childConstUnions[1][arg1comp].getIConst()));
-                } else {
-                    if (isInt64)
-                        newConstArray[comp].setU64Const(std::max(childConstUnions[0][arg0comp].getU64Const(), childConstUnions[1][arg1comp].getU64Const()));
-                    else
-                        newConstArray[comp].setUConst(std::max(childConstUnions[0][arg0comp].getUConst(), childConstUnions[1][arg1comp].getUConst()));
-                }
-                break;
-            case EOpClamp:
-                if (isFloatingPoint)
-                    newConstArray[comp].setDConst(std::min(std::max(childConstUnions[0][arg0comp].getDConst(), childConstUnions[1][arg1comp].getDConst()),
-                                                                                                               childConstUnions[2][arg2comp].getDConst()));
-                else if (isSigned) {
-                    if (isInt64)
-                        newConstArray[comp].setI64Const(std::min(std::max(childConstUnions[0][arg0comp].getI64Const(), childConstUnions[1][arg1comp].getI64Const()),
-                                                                                                                       childConstUnions[2][arg2comp].getI64Const()));
-                    else
-                        newConstArray[comp].setIConst(std::min(std::max(childConstUnions[0][arg0comp].getIConst(), childConstUnions[1][arg1comp].getIConst()),
-                                                                                                                   childConstUnions[2][arg2comp].getIConst()));
-                } else {
-                    if (isInt64)
-                        newConstArray[comp].setU64Const(std::min(std::max(childConstUnions[0][arg0comp].getU64Const(), childConstUnions[1][arg1comp].getU64Const()),
-                                                                                                                       childConstUnions[2][arg2comp].getU64Const()));
-                    else
-                        newConstArray[comp].setUConst(std::min(std::max(childConstUnions[0][arg0comp].getUConst(), childConstUnions[1][arg1comp].getUConst()),
-                                                                                                                   childConstUnions[2][arg2comp].getUConst()));
-                }
-                break;
-            case EOpLessThan:
-                newConstArray[comp].setBConst(childConstUnions[0][arg0comp] < childConstUnions[1][arg1comp]);
-                break;
-            case EOpGreaterThan:
-                newConstArray[comp].setBConst(childConstUnions[0][arg0comp] > childConstUnions[1][arg1comp]);
-                break;
-            case EOpLessThanEqual:
-                newConstArray[comp].setBConst(! (childConstUnions[0][arg0comp] > childConstUnions[1][arg1comp]));
-                break;
-            case EOpGreaterThanEqual:
-                newConstArray[comp].setBConst(! (childConstUnions[0][arg0comp] < childConstUnions[1][arg1comp]));
-                break;
-            case EOpVectorEqual:
-                newConstArray[comp].setBConst(childConstUnions[0][arg0comp] == childConstUnions[1][arg1comp]);
-                break;
-            case EOpVectorNotEqual:
-                newConstArray[comp].setBConst(childConstUnions[0][arg0comp] != childConstUnions[1][arg1comp]);
-                break;
-            case EOpMix:
-                if (children[2]->getAsTyped()->getBasicType() == EbtBool)
-                    newConstArray[comp].setDConst(childConstUnions[2][arg2comp].getBConst() ? childConstUnions[1][arg1comp].getDConst() :
-                                                                                              childConstUnions[0][arg0comp].getDConst());
-                else
-                    newConstArray[comp].setDConst(childConstUnions[0][arg0comp].getDConst() * (1.0 - childConstUnions[2][arg2comp].getDConst()) +
-                                                  childConstUnions[1][arg1comp].getDConst() *        childConstUnions[2][arg2comp].getDConst());
-                break;
-            case EOpStep:
-                newConstArray[comp].setDConst(childConstUnions[1][arg1comp].getDConst() < childConstUnions[0][arg0comp].getDConst() ? 0.0 : 1.0);
-                break;
-            case EOpSmoothStep:
-            {
-                double t = (childConstUnions[2][arg2comp].getDConst() - childConstUnions[0][arg0comp].getDConst()) / 
-                           (childConstUnions[1][arg1comp].getDConst() - childConstUnions[0][arg0comp].getDConst());
+        // some arguments are scalars instead of matching vectors; simulate a smear
+        TFoldArgument args[3];
+        for (int arg = 0; arg < 3; ++arg) {
+            if (arg < (int)children.size()) {
+                args[arg].components = &childConstUnions[arg][0];
+                args[arg].last = children[arg]->getAsTyped()->getType().getVectorSize() - 1;
+            } else
+                args[arg] = args[0];
+        }
+
+        TBasicType componentType = childConstUnions[0][0].getType();
+        bool folded = true;
+
+        switch (aggrNode->getOp()) {
+        case EOpAtan:
+            builtInKernel<TDoubleComponent>(args, newConstArray, objectSize, [](double y, double x, double) { return atan2(y, x); }).run<TDoubleComponent>();
+            break;
+        case EOpPow:
+            builtInKernel<TDoubleComponent>(args, newConstArray, objectSize, [](double x, double y, double) { return pow(x, y); }).run<TDoubleComponent>();
+            break;
+        case EOpMin:
+            folded = runOnNumber(componentType, builtInKernel<TSameComponent>(args, newConstArray, objectSize, TMin()));
+            break;
+        case EOpMax:
+            folded = runOnNumber(componentType, builtInKernel<TSameComponent>(args, newConstArray, objectSize, TMax()));
+            break;
+        case EOpClamp:
+            folded = runOnNumber(componentType, builtInKernel<TSameComponent>(args, newConstArray, objectSize, TClamp()));
+            break;
+        case EOpLessThan:
+            folded = runOnNumber(componentType, builtInKernel<TBoolComponent>(args, newConstArray, objectSize, TLessThan()));
+            break;
+        case EOpGreaterThan:
+            folded = runOnNumber(componentType, builtInKernel<TBoolComponent>(args, newConstArray, objectSize, TGreaterThan()));
+            break;
+        case EOpLessThanEqual:
+            folded = runOnNumber(componentType, builtInKernel<TBoolComponent>(args, newConstArray, objectSize, TLessThanEqual()));
+            break;
+        case EOpGreaterThanEqual:
+            folded = runOnNumber(componentType, builtInKernel<TBoolComponent>(args, newConstArray, objectSize, TGreaterThanEqual()));
+            break;
+        case EOpVectorEqual:
+            if (componentType == EbtBool)
+                builtInKernel<TBoolComponent>(args, newConstArray, objectSize, TEqual()).run<TBoolComponent>();
+            else
+                folded = runOnNumber(componentType, builtInKernel<TBoolComponent>(args, newConstArray, objectSize, TEqual()));
+            break;
+        case EOpVectorNotEqual:
+            if (componentType == EbtBool)
+                builtInKernel<TBoolComponent>(args, newConstArray, objectSize, TNotEqual()).run<TBoolComponent>();
+            else
+                folded = runOnNumber(componentType, builtInKernel<TBoolComponent>(args, newConstArray, objectSize, TNotEqual()));
+            break;
+        case EOpMix:
+            if (children[2]->getAsTyped()->getBasicType() == EbtBool) {
+                // the selector isn't of the same type as the values, so this one isn't a kernel
+                for (int comp = 0; comp < objectSize; comp++)
+                    newConstArray[comp].setDConst(args[2][comp].getBConst() ? args[1][comp].getDConst() : args[0][comp].getDConst());
+            } else
+                builtInKernel<TDoubleComponent>(args, newConstArray, objectSize, [](double x, double y, double a) { return x * (1.0 - a) + y * a; }).run<TDoubleComponent>();
+            break;
+        case EOpStep:
+            builtInKernel<TDoubleComponent>(args, newConstArray, objectSize, [](double edge, double x, double) { return x < edge ? 0.0 : 1.0; }).run<TDoubleComponent>();
+            break;
+        case EOpSmoothStep:
+            builtInKernel<TDoubleComponent>(args, newConstArray, objectSize, [](double edge0, double edge1, double x) {
+                double t = (x - edge0) / (edge1 - edge0);
                 if (t < 0.0)
                     t = 0.0;
                 if (t > 1.0)
                     t = 1.0;
-                newConstArray[comp].setDConst(t * t * (3.0 - 2.0 * t));
-                break;
-            }
-            default:
-                return aggrNode;
-            }
+                return t * t * (3.0 - 2.0 * t);
+            }).run<TDoubleComponent>();
+            break;
+        default:
+            folded = false;
+            break;
         }
+
+        if (! folded)
+            return aggrNode;
     } else {
         // Non-componentwise...
 
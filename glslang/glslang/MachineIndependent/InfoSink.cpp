@@ -106,4 +106,80 @@ void TInfoSinkBase::append(const TString& t)
         fprintf(stdout, "%s", t.c_str());
 }
 
+void TInfoSinkBase::diagnostic(TPrefixType message, const TSourceLoc& loc, const char* token, const char* reason,
+                               const char* extraInfo)
+{
+    if (outputStream != EString) {
+        prefix(message);
+        location(loc);
+        if (token != nullptr)
+            *this << "'" << token << "' : " << reason << " " << extraInfo << "\n";
+        else
+            *this << reason << "\n";
+        return;
+    }
+
+    diagnostics.push_back(TDiagnostic());
+    TDiagnostic& diagnostic = diagnostics.back();
+    diagnostic.severity = message;
+    if (loc.name != nullptr)
+        diagnostic.name = loc.name;
+    diagnostic.string = loc.string;
+    diagnostic.line = loc.line;
+    diagnostic.column = loc.column;
+    diagnostic.hasToken = token != nullptr;
+    if (diagnostic.hasToken) {
+        diagnostic.token = token;
+        diagnostic.extraInfo = extraInfo;
+    }
+    diagnostic.reason = reason;
+    diagnostic.offset = sink.size();
+}
+
+const char* TInfoSinkBase::c_str() const
+{
+    if (diagnostics.empty())
+        return sink.c_str();
+
+    if (renderedCount != diagnostics.size() || renderedSinkSize != sink.size()) {
+        rendered.clear();
+        size_t offset = 0;
+        for (const TDiagnostic& diagnostic : diagnostics) {
+            rendered.append(sink, offset, diagnostic.offset - offset);
+            offset = diagnostic.offset;
+            render(rendered, diagnostic);
+        }
+        rendered.append(sink, offset, TPersistString::npos);
+
+        renderedCount = diagnostics.size();
+        renderedSinkSize = sink.size();
+    }
+
+    return rendered.c_str();
+}
+
+// Formats a diagnostic the same way prefix(), location(), and the message
+// would have, had it been written directly.
+void TInfoSinkBase::render(TPersistString& out, const TDiagnostic& diagnostic)
+{
+    out.append(prefixText(diagnostic.severity));
+    if (diagnostic.name.empty())
+        out.append(std::to_string((long long)diagnostic.string));
+    else
+        out.append(diagnostic.name);
+    out.append(":");
+    out.append(std::to_string((long long)diagnostic.line));
+    out.append(": ");
+    if (diagnostic.hasToken) {
+        out.append("'");
+        out.append(diagnostic.token);
+        out.append("' : ");
+        out.append(diagnostic.reason);
+        out.append(" ");
+        out.append(diagnostic.extraInfo);
+    } else
+        out.append(diagnostic.reason);
+    out.append("\n");
+}
+
 } // end namespace glslang
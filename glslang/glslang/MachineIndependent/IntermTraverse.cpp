@@ -42,7 +42,8 @@ namespace glslang {
 //
 // Traverse the intermediate representation tree, and
 // call a node type specific function for each node.
-// Done recursively through the member function Traverse().
+// Done by TIntermTraverser::traverseSubtree(), which every node's
+// traverse() calls, using an explicit stack instead of recursion.
 // Node types can be skipped if their function to call is 0,
 // but their subtree will still be traversed.
 // Nodes with children can have their whole subtree skipped
@@ -71,232 +72,243 @@ void TIntermConstantUnion::traverse(TIntermTraverser *it)
     it->visitConstantUnion(this);
 }
 
-//
-// Traverse a binary node.
-//
 void TIntermBinary::traverse(TIntermTraverser *it)
 {
-    bool visit = true;
-
-    //
-    // visit the node before children if pre-visiting.
-    //
-    if (it->preVisit)
-        visit = it->visitBinary(EvPreVisit, this);
-
-    //
-    // Visit the children, in the right order.
-    //
-    if (visit) {
-        it->incrementDepth(this);
-
-        if (it->rightToLeft) {
-            if (right)
-                right->traverse(it);
-
-            if (it->inVisit)
-                visit = it->visitBinary(EvInVisit, this);
-
-            if (visit && left)
-                left->traverse(it);
-        } else {
-            if (left)
-                left->traverse(it);
-
-            if (it->inVisit)
-                visit = it->visitBinary(EvInVisit, this);
-
-            if (visit && right)
-                right->traverse(it);
-        }
-
-        it->decrementDepth();
-    }
-
-    //
-    // Visit the node after the children, if requested and the traversal
-    // hasn't been canceled yet.
-    //
-    if (visit && it->postVisit)
-        it->visitBinary(EvPostVisit, this);
+    it->traverseSubtree(this);
 }
 
-//
-// Traverse a unary node.  Same comments in binary node apply here.
-//
 void TIntermUnary::traverse(TIntermTraverser *it)
 {
-    bool visit = true;
-
-    if (it->preVisit)
-        visit = it->visitUnary(EvPreVisit, this);
-
-    if (visit) {
-        it->incrementDepth(this);
-        operand->traverse(it);
-        it->decrementDepth();
-    }
-
-    if (visit && it->postVisit)
-        it->visitUnary(EvPostVisit, this);
+    it->traverseSubtree(this);
 }
 
-//
-// Traverse an aggregate node.  Same comments in binary node apply here.
-//
 void TIntermAggregate::traverse(TIntermTraverser *it)
 {
-    bool visit = true;
-
-    if (it->preVisit)
-        visit = it->visitAggregate(EvPreVisit, this);
-
-    if (visit) {
-        it->incrementDepth(this);
+    it->traverseSubtree(this);
+}
 
-        if (it->rightToLeft) {
-            for (TIntermSequence::reverse_iterator sit = sequence.rbegin(); sit != sequence.rend(); sit++) {
-                (*sit)->traverse(it);
+void TIntermSelection::traverse(TIntermTraverser *it)
+{
+    it->traverseSubtree(this);
+}
 
-                if (visit && it->inVisit) {
-                    if (*sit != sequence.front())
-                        visit = it->visitAggregate(EvInVisit, this);
-                }
-            }
-        } else {
-            for (TIntermSequence::iterator sit = sequence.begin(); sit != sequence.end(); sit++) {
-                (*sit)->traverse(it);
-
-                if (visit && it->inVisit) {
-                    if (*sit != sequence.back())
-                        visit = it->visitAggregate(EvInVisit, this);
-                }
-            }
-        }
+void TIntermLoop::traverse(TIntermTraverser *it)
+{
+    it->traverseSubtree(this);
+}
 
-        it->decrementDepth();
-    }
+void TIntermBranch::traverse(TIntermTraverser *it)
+{
+    it->traverseSubtree(this);
+}
 
-    if (visit && it->postVisit)
-        it->visitAggregate(EvPostVisit, this);
+void TIntermSwitch::traverse(TIntermTraverser* it)
+{
+    it->traverseSubtree(this);
 }
 
 //
-// Traverse a selection node.  Same comments in binary node apply here.
+// Walk the subtree, one node at a time, keeping the nodes whose children
+// are being traversed on the 'walk' stack.  A visit function that calls
+// traverse() on a node walks that node's subtree on top of the same stack,
+// and is back where it started when it returns.
 //
-void TIntermSelection::traverse(TIntermTraverser *it)
+void TIntermTraverser::traverseSubtree(TIntermNode* root)
 {
-    bool visit = true;
-
-    if (it->preVisit)
-        visit = it->visitSelection(EvPreVisit, this);
-
-    if (visit) {
-        it->incrementDepth(this);
-        if (it->rightToLeft) {
-            if (falseBlock)
-                falseBlock->traverse(it);
-            if (trueBlock)
-                trueBlock->traverse(it);
-            condition->traverse(it);
-        } else {
-            condition->traverse(it);
-            if (trueBlock)
-                trueBlock->traverse(it);
-            if (falseBlock)
-                falseBlock->traverse(it);
-        }
-        it->decrementDepth();
+    const size_t base = walk.size();
+
+    enterNode(root);
+    while (walk.size() > base) {
+        bool done;
+        TIntermNode* child = nextChild(walk.size() - 1, done);
+        if (done)
+            leaveNode();
+        else if (child)
+            enterNode(child);
     }
-
-    if (visit && it->postVisit)
-        it->visitSelection(EvPostVisit, this);
 }
 
 //
-// Traverse a loop node.  Same comments in binary node apply here.
+// Visit a node before its children, if pre-visiting.  Unless that
+// skips its subtree, push it to have its children traversed.
 //
-void TIntermLoop::traverse(TIntermTraverser *it)
+// Terminals are visited right away, as they have no children.
+//
+void TIntermTraverser::enterNode(TIntermNode* node)
 {
-    bool visit = true;
-
-    if (it->preVisit)
-        visit = it->visitLoop(EvPreVisit, this);
-
-    if (visit) {
-        it->incrementDepth(this);
-
-        if (it->rightToLeft) {
-            if (terminal)
-                terminal->traverse(it);
-
-            if (body)
-                body->traverse(it);
-
-            if (test)
-                test->traverse(it);
-        } else {
-            if (test)
-                test->traverse(it);
-
-            if (body)
-                body->traverse(it);
-
-            if (terminal)
-                terminal->traverse(it);
+    TWalkFrame frame;
+    frame.node = node;
+    frame.step = 0;
+    frame.visit = true;
+
+    if (TIntermBinary* binary = node->getAsBinaryNode()) {
+        frame.kind = EwkBinary;
+        if (preVisit)
+            frame.visit = visitBinary(EvPreVisit, binary);
+    } else if (TIntermSymbol* symbol = node->getAsSymbolNode()) {
+        visitSymbol(symbol);
+        return;
+    } else if (TIntermConstantUnion* constant = node->getAsConstantUnion()) {
+        visitConstantUnion(constant);
+        return;
+    } else if (TIntermAggregate* aggregate = node->getAsAggregate()) {
+        frame.kind = EwkAggregate;
+        if (preVisit)
+            frame.visit = visitAggregate(EvPreVisit, aggregate);
+    } else if (TIntermUnary* unary = node->getAsUnaryNode()) {
+        frame.kind = EwkUnary;
+        if (preVisit)
+            frame.visit = visitUnary(EvPreVisit, unary);
+    } else if (TIntermSelection* selection = node->getAsSelectionNode()) {
+        frame.kind = EwkSelection;
+        if (preVisit)
+            frame.visit = visitSelection(EvPreVisit, selection);
+    } else if (TIntermBranch* branch = node->getAsBranchNode()) {
+        frame.kind = EwkBranch;
+        if (preVisit)
+            frame.visit = visitBranch(EvPreVisit, branch);
+
+        // a branch without an expression has no subtree to descend into
+        if (frame.visit && ! branch->getExpression()) {
+            if (postVisit)
+                visitBranch(EvPostVisit, branch);
+            return;
         }
-
-        it->decrementDepth();
+    } else if (TIntermLoop* loop = node->getAsLoopNode()) {
+        frame.kind = EwkLoop;
+        if (preVisit)
+            frame.visit = visitLoop(EvPreVisit, loop);
+    } else if (TIntermSwitch* switchNode = node->getAsSwitchNode()) {
+        frame.kind = EwkSwitch;
+        if (preVisit)
+            frame.visit = visitSwitch(EvPreVisit, switchNode);
+    } else {
+        // a method, or anything else without children to walk
+        node->traverse(this);
+        return;
     }
 
-    if (visit && it->postVisit)
-        it->visitLoop(EvPostVisit, this);
+    // the subtree is skipped, and so is the post-visit
+    if (! frame.visit)
+        return;
+
+    incrementDepth(node);
+    walk.push_back(frame);
 }
 
 //
-// Traverse a branch node.  Same comments in binary node apply here.
+// Return the next child of the node in walk[frame] to traverse, which can be
+// nullptr for a missing one, or set 'done' once there are no more.
 //
-void TIntermBranch::traverse(TIntermTraverser *it)
+// This also does the in-visits between children.  Those can walk more of
+// the tree, growing 'walk', so it is indexed again after any visit rather
+// than held by reference.
+//
+TIntermNode* TIntermTraverser::nextChild(size_t frame, bool& done)
 {
-    bool visit = true;
+    done = false;
+    const int step = walk[frame].step++;
+
+    switch (walk[frame].kind) {
+    case EwkBinary:
+    {
+        TIntermBinary* binary = walk[frame].node->getAsBinaryNode();
+        if (step == 0)
+            return rightToLeft ? binary->getRight() : binary->getLeft();
+        if (step == 1) {
+            if (inVisit) {
+                const bool visit = visitBinary(EvInVisit, binary);
+                walk[frame].visit = visit;
+            }
+            if (walk[frame].visit)
+                return rightToLeft ? binary->getLeft() : binary->getRight();
+        }
+        break;
+    }
 
-    if (it->preVisit)
-        visit = it->visitBranch(EvPreVisit, this);
+    case EwkUnary:
+        if (step == 0)
+            return walk[frame].node->getAsUnaryNode()->getOperand();
+        break;
+
+    case EwkAggregate:
+    {
+        TIntermAggregate* aggregate = walk[frame].node->getAsAggregate();
+        TIntermSequence& sequence = aggregate->getSequence();
+
+        // in-visit after each child but the last
+        if (step > 0 && walk[frame].visit && inVisit) {
+            TIntermNode* previous = rightToLeft ? sequence[sequence.size() - step] : sequence[step - 1];
+            if (previous != (rightToLeft ? sequence.front() : sequence.back())) {
+                const bool visit = visitAggregate(EvInVisit, aggregate);
+                walk[frame].visit = visit;
+            }
+        }
+        if (step < (int)sequence.size())
+            return rightToLeft ? sequence[sequence.size() - 1 - step] : sequence[step];
+        break;
+    }
 
-    if (visit && expression) {
-        it->incrementDepth(this);
-        expression->traverse(it);
-        it->decrementDepth();
+    case EwkSelection:
+    {
+        TIntermSelection* selection = walk[frame].node->getAsSelectionNode();
+        TIntermNode* const children[] = { selection->getCondition(), selection->getTrueBlock(), selection->getFalseBlock() };
+        if (step < 3)
+            return children[rightToLeft ? 2 - step : step];
+        break;
     }
 
-    if (visit && it->postVisit)
-        it->visitBranch(EvPostVisit, this);
+    case EwkLoop:
+    {
+        TIntermLoop* loop = walk[frame].node->getAsLoopNode();
+        TIntermNode* const children[] = { loop->getTest(), loop->getBody(), loop->getTerminal() };
+        if (step < 3)
+            return children[rightToLeft ? 2 - step : step];
+        break;
+    }
+
+    case EwkBranch:
+        if (step == 0)
+            return walk[frame].node->getAsBranchNode()->getExpression();
+        break;
+
+    case EwkSwitch:
+    {
+        TIntermSwitch* switchNode = walk[frame].node->getAsSwitchNode();
+        if (step == 0)
+            return rightToLeft ? (TIntermNode*)switchNode->getBody() : switchNode->getCondition();
+        if (step == 1)
+            return rightToLeft ? (TIntermNode*)switchNode->getCondition() : switchNode->getBody();
+        break;
+    }
+    }
+
+    done = true;
+    return nullptr;
 }
 
 //
-// Traverse a switch node.
+// Pop the node whose children are all traversed, and visit it after them, if
+// post-visiting and an in-visit didn't cut its traversal short.
 //
-void TIntermSwitch::traverse(TIntermTraverser* it)
+void TIntermTraverser::leaveNode()
 {
-    bool visit = true;
-
-    if (it->preVisit)
-        visit = it->visitSwitch(EvPreVisit, this);
-
-    if (visit) {
-        it->incrementDepth(this);
-        if (it->rightToLeft) {
-            body->traverse(it);
-            condition->traverse(it);
-        } else {
-            condition->traverse(it);
-            body->traverse(it);
-        }
-        it->decrementDepth();
+    const TWalkFrame frame = walk.back();
+    walk.pop_back();
+    decrementDepth();
+
+    if (! frame.visit || ! postVisit)
+        return;
+
+    switch (frame.kind) {
+    case EwkBinary:    visitBinary(EvPostVisit, frame.node->getAsBinaryNode());       break;
+    case EwkUnary:     visitUnary(EvPostVisit, frame.node->getAsUnaryNode());         break;
+    case EwkAggregate: visitAggregate(EvPostVisit, frame.node->getAsAggregate());     break;
+    case EwkSelection: visitSelection(EvPostVisit, frame.node->getAsSelectionNode()); break;
+    case EwkLoop:      visitLoop(EvPostVisit, frame.node->getAsLoopNode());           break;
+    case EwkBranch:    visitBranch(EvPostVisit, frame.node->getAsBranchNode());       break;
+    case EwkSwitch:    visitSwitch(EvPostVisit, frame.node->getAsSwitchNode());       break;
     }
-
-    if (visit && it->postVisit)
-        it->visitSwitch(EvPostVisit, this);
 }
 
 } // end namespace glslang
@@ -359,9 +359,7 @@ void TParseContext::outputMessage(const TSourceLoc& loc, const char* szReason,
 
     safe_vsprintf(szExtraInfo, maxSize, szExtraInfoFormat, args);
 
-    infoSink.info.prefix(prefix);
-    infoSink.info.location(loc);
-    infoSink.info << "'" << szToken <<  "' : " << szReason << " " << szExtraInfo << "\n";
+    infoSink.info.diagnostic(prefix, loc, szToken, szReason, szExtraInfo);
 
     if (prefix == EPrefixError) {
         ++numErrors;
@@ -408,6 +406,8 @@ void C_DECL TParseContext::ppError(const TSourceLoc& loc, const char* szReason,
 void C_DECL TParseContext::ppWarn(const TSourceLoc& loc, const char* szReason, const char* szToken,
                                  const char* szExtraInfoFormat, ...)
 {
+    if (suppressWarnings())
+        return;
     va_list args;
     va_start(args, szExtraInfoFormat);
     outputMessage(loc, szReason, szToken, szExtraInfoFormat, EPrefixWarning, args);
@@ -3733,6 +3733,9 @@ void TParseContext::structTypeCheck(const TSourceLoc& /*loc*/, TPublicType& publ
         if (memberQualifier.invariant)
             error(memberLoc, "cannot use invariant qualifier on structure members", typeList[member].type->getFieldName().c_str(), "");
     }
+
+    // the members are final now
+    publicType.userDef->buildMemberStrings();
 }
 
 //
@@ -4845,15 +4848,12 @@ const TFunction* TParseContext::findFunction120(const TSourceLoc& loc, const TFu
 
     const TFunction* candidate = nullptr;
     TVector<TFunction*> candidateList;
-    symbolTable.findFunctionNameList(call.getMangledName(), candidateList, builtIn);
+    // to even be a potential match, number of arguments has to match
+    symbolTable.findFunctionNameList(call.getMangledName(), call.getParamCount(), candidateList, builtIn);
 
     for (TVector<TFunction*>::const_iterator it = candidateList.begin(); it != candidateList.end(); ++it) {
         const TFunction& function = *(*it);
 
-        // to even be a potential match, number of arguments has to match
-        if (call.getParamCount() != function.getParamCount())
-            continue;
-
         bool possibleMatch = true;
         for (int i = 0; i < function.getParamCount(); ++i) {
             // same types is easy
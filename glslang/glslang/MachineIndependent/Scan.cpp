@@ -38,9 +38,19 @@
 // GLSL scanning, leveraging the scanning done by the preprocessor.
 //
 
+#include <algorithm>
+#include <cassert>
 #include <cstring>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
+
+// GLSLANG_SCAN_NO_SSE2 leaves the scalar loops alone, for comparison (see gtests/ScanBenchmark.cpp)
+#if ! defined(GLSLANG_SCAN_NO_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define GLSLANG_SCAN_SSE2
+    #include <emmintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
 
 #include "../Include/Types.h"
 #include "SymbolTable.h"
@@ -56,8 +66,90 @@
 // Required to avoid missing prototype warnings for some compilers
 int yylex(YYSTYPE*, glslang::TParseContext&);
 
+namespace {
+
+#ifdef GLSLANG_SCAN_SSE2
+
+// index of the lowest set bit of a non-zero mask
+inline int lowestBit(unsigned int mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#endif
+
+// Length of the run of ' ' and '\t' that starts s, looking at no more than n characters.
+size_t spaceTabRun(const unsigned char* s, size_t n)
+{
+    size_t i = 0;
+
+#ifdef GLSLANG_SCAN_SSE2
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    for (; i + 16 <= n; i += 16) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmpeq_epi8(chars, tab));
+        const unsigned int other = ~(unsigned int)_mm_movemask_epi8(blank) & 0xFFFF;
+        if (other != 0)
+            return i + lowestBit(other);
+    }
+#endif
+
+    while (i < n && (s[i] == ' ' || s[i] == '\t'))
+        ++i;
+
+    return i;
+}
+
+// Length of the run that starts s and holds no a, b, or c, looking at no more than n characters.
+size_t runWithout(const unsigned char* s, size_t n, unsigned char a, unsigned char b, unsigned char c)
+{
+    size_t i = 0;
+
+#ifdef GLSLANG_SCAN_SSE2
+    const __m128i stopA = _mm_set1_epi8((char)a);
+    const __m128i stopB = _mm_set1_epi8((char)b);
+    const __m128i stopC = _mm_set1_epi8((char)c);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const __m128i stops = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, stopA), _mm_cmpeq_epi8(chars, stopB)),
+                                           _mm_cmpeq_epi8(chars, stopC));
+        const unsigned int found = (unsigned int)_mm_movemask_epi8(stops);
+        if (found != 0)
+            return i + lowestBit(found);
+    }
+#endif
+
+    while (i < n && s[i] != a && s[i] != b && s[i] != c)
+        ++i;
+
+    return i;
+}
+
+};
+
 namespace glslang {
 
+void TInputScanner::skipSpaceTab()
+{
+    const size_t count = skippable();
+    if (count > 0)
+        skip(spaceTabRun(sources[currentSource] + currentChar, count));
+}
+
+void TInputScanner::skipUntil(unsigned char a, unsigned char b)
+{
+    const size_t count = skippable();
+    if (count > 0)
+        skip(runWithout(sources[currentSource] + currentChar, count, a, b, '\n'));
+}
+
 // read past any white space
 void TInputScanner::consumeWhiteSpace(bool& foundNonSpaceTab)
 {
@@ -66,6 +158,7 @@ void TInputScanner::consumeWhiteSpace(bool& foundNonSpaceTab)
         if (c == '\r' || c == '\n')
             foundNonSpaceTab = true;
         get();
+        skipSpaceTab();
         c = peek();
     }
 }
@@ -84,8 +177,10 @@ bool TInputScanner::consumeComment()
         get();  // consume the second '/'
         c = get();
         do {
-            while (c != EndOfInput && c != '\\' && c != '\r' && c != '\n')
+            while (c != EndOfInput && c != '\\' && c != '\r' && c != '\n') {
+                skipUntil('\\', '\r');
                 c = get();
+            }
 
             if (c == EndOfInput || c == '\r' || c == '\n') {
                 while (c == '\r' || c == '\n')
@@ -117,8 +212,10 @@ bool TInputScanner::consumeComment()
         get();  // consume the '*'
         c = get();
         do {
-            while (c != EndOfInput && c != '*')
+            while (c != EndOfInput && c != '*') {
+                skipUntil('*', '*');
                 c = get();
+            }
             if (c == '*') {
                 c = get();
                 if (c == '/')
@@ -296,322 +393,393 @@ int yylex(YYSTYPE* glslangTokenDesc, glslang::TParseContext& parseContext)
 
 namespace {
 
-struct str_eq
-{
-    bool operator()(const char* lhs, const char* rhs) const
-    {
-        return strcmp(lhs, rhs) == 0;
-    }
+// The token of identifiers that are reserved words, rather than keywords.
+const int ReservedWord = -1;
+
+struct TKeyword {
+    const char* name;
+    int token;
 };
 
-struct str_hash
-{
-    size_t operator()(const char* str) const
+// All keywords and reserved words.  Being read only, this is usable by all
+// threads, by all versions, by all languages.
+const TKeyword Keywords[] = {
+    { "const",                    CONST },
+    { "uniform",                  UNIFORM },
+    { "in",                       IN },
+    { "out",                      OUT },
+    { "inout",                    INOUT },
+    { "struct",                   STRUCT },
+    { "break",                    BREAK },
+    { "continue",                 CONTINUE },
+    { "do",                       DO },
+    { "for",                      FOR },
+    { "while",                    WHILE },
+    { "switch",                   SWITCH },
+    { "case",                     CASE },
+    { "default",                  DEFAULT },
+    { "if",                       IF },
+    { "else",                     ELSE },
+    { "discard",                  DISCARD },
+    { "return",                   RETURN },
+    { "void",                     VOID },
+    { "bool",                     BOOL },
+    { "float",                    FLOAT },
+    { "int",                      INT },
+    { "bvec2",                    BVEC2 },
+    { "bvec3",                    BVEC3 },
+    { "bvec4",                    BVEC4 },
+    { "vec2",                     VEC2 },
+    { "vec3",                     VEC3 },
+    { "vec4",                     VEC4 },
+    { "ivec2",                    IVEC2 },
+    { "ivec3",                    IVEC3 },
+    { "ivec4",                    IVEC4 },
+    { "mat2",                     MAT2 },
+    { "mat3",                     MAT3 },
+    { "mat4",                     MAT4 },
+    { "true",                     BOOLCONSTANT },
+    { "false",                    BOOLCONSTANT },
+    { "attribute",                ATTRIBUTE },
+    { "varying",                  VARYING },
+    { "buffer",                   BUFFER },
+    { "coherent",                 COHERENT },
+    { "restrict",                 RESTRICT },
+    { "readonly",                 READONLY },
+    { "writeonly",                WRITEONLY },
+    { "atomic_uint",              ATOMIC_UINT },
+    { "volatile",                 VOLATILE },
+    { "layout",                   LAYOUT },
+    { "shared",                   SHARED },
+    { "patch",                    PATCH },
+    { "sample",                   SAMPLE },
+    { "subroutine",               SUBROUTINE },
+    { "highp",                    HIGH_PRECISION },
+    { "mediump",                  MEDIUM_PRECISION },
+    { "lowp",                     LOW_PRECISION },
+    { "precision",                PRECISION },
+    { "mat2x2",                   MAT2X2 },
+    { "mat2x3",                   MAT2X3 },
+    { "mat2x4",                   MAT2X4 },
+    { "mat3x2",                   MAT3X2 },
+    { "mat3x3",                   MAT3X3 },
+    { "mat3x4",                   MAT3X4 },
+    { "mat4x2",                   MAT4X2 },
+    { "mat4x3",                   MAT4X3 },
+    { "mat4x4",                   MAT4X4 },
+    { "dmat2",                    DMAT2 },
+    { "dmat3",                    DMAT3 },
+    { "dmat4",                    DMAT4 },
+    { "dmat2x2",                  DMAT2X2 },
+    { "dmat2x3",                  DMAT2X3 },
+    { "dmat2x4",                  DMAT2X4 },
+    { "dmat3x2",                  DMAT3X2 },
+    { "dmat3x3",                  DMAT3X3 },
+    { "dmat3x4",                  DMAT3X4 },
+    { "dmat4x2",                  DMAT4X2 },
+    { "dmat4x3",                  DMAT4X3 },
+    { "dmat4x4",                  DMAT4X4 },
+    { "image1D",                  IMAGE1D },
+    { "iimage1D",                 IIMAGE1D },
+    { "uimage1D",                 UIMAGE1D },
+    { "image2D",                  IMAGE2D },
+    { "iimage2D",                 IIMAGE2D },
+    { "uimage2D",                 UIMAGE2D },
+    { "image3D",                  IMAGE3D },
+    { "iimage3D",                 IIMAGE3D },
+    { "uimage3D",                 UIMAGE3D },
+    { "image2DRect",              IMAGE2DRECT },
+    { "iimage2DRect",             IIMAGE2DRECT },
+    { "uimage2DRect",             UIMAGE2DRECT },
+    { "imageCube",                IMAGECUBE },
+    { "iimageCube",               IIMAGECUBE },
+    { "uimageCube",               UIMAGECUBE },
+    { "imageBuffer",              IMAGEBUFFER },
+    { "iimageBuffer",             IIMAGEBUFFER },
+    { "uimageBuffer",             UIMAGEBUFFER },
+    { "image1DArray",             IMAGE1DARRAY },
+    { "iimage1DArray",            IIMAGE1DARRAY },
+    { "uimage1DArray",            UIMAGE1DARRAY },
+    { "image2DArray",             IMAGE2DARRAY },
+    { "iimage2DArray",            IIMAGE2DARRAY },
+    { "uimage2DArray",            UIMAGE2DARRAY },
+    { "imageCubeArray",           IMAGECUBEARRAY },
+    { "iimageCubeArray",          IIMAGECUBEARRAY },
+    { "uimageCubeArray",          UIMAGECUBEARRAY },
+    { "image2DMS",                IMAGE2DMS },
+    { "iimage2DMS",               IIMAGE2DMS },
+    { "uimage2DMS",               UIMAGE2DMS },
+    { "image2DMSArray",           IMAGE2DMSARRAY },
+    { "iimage2DMSArray",          IIMAGE2DMSARRAY },
+    { "uimage2DMSArray",          UIMAGE2DMSARRAY },
+    { "double",                   DOUBLE },
+    { "dvec2",                    DVEC2 },
+    { "dvec3",                    DVEC3 },
+    { "dvec4",                    DVEC4 },
+    { "uint",                     UINT },
+    { "uvec2",                    UVEC2 },
+    { "uvec3",                    UVEC3 },
+    { "uvec4",                    UVEC4 },
+
+    { "int64_t",                  INT64_T },
+    { "uint64_t",                 UINT64_T },
+    { "i64vec2",                  I64VEC2 },
+    { "i64vec3",                  I64VEC3 },
+    { "i64vec4",                  I64VEC4 },
+    { "u64vec2",                  U64VEC2 },
+    { "u64vec3",                  U64VEC3 },
+    { "u64vec4",                  U64VEC4 },
+
+    { "sampler2D",                SAMPLER2D },
+    { "samplerCube",              SAMPLERCUBE },
+    { "samplerCubeArray",         SAMPLERCUBEARRAY },
+    { "samplerCubeArrayShadow",   SAMPLERCUBEARRAYSHADOW },
+    { "isamplerCubeArray",        ISAMPLERCUBEARRAY },
+    { "usamplerCubeArray",        USAMPLERCUBEARRAY },
+    { "sampler1DArrayShadow",     SAMPLER1DARRAYSHADOW },
+    { "isampler1DArray",          ISAMPLER1DARRAY },
+    { "usampler1D",               USAMPLER1D },
+    { "isampler1D",               ISAMPLER1D },
+    { "usampler1DArray",          USAMPLER1DARRAY },
+    { "samplerBuffer",            SAMPLERBUFFER },
+    { "samplerCubeShadow",        SAMPLERCUBESHADOW },
+    { "sampler2DArray",           SAMPLER2DARRAY },
+    { "sampler2DArrayShadow",     SAMPLER2DARRAYSHADOW },
+    { "isampler2D",               ISAMPLER2D },
+    { "isampler3D",               ISAMPLER3D },
+    { "isamplerCube",             ISAMPLERCUBE },
+    { "isampler2DArray",          ISAMPLER2DARRAY },
+    { "usampler2D",               USAMPLER2D },
+    { "usampler3D",               USAMPLER3D },
+    { "usamplerCube",             USAMPLERCUBE },
+    { "usampler2DArray",          USAMPLER2DARRAY },
+    { "isampler2DRect",           ISAMPLER2DRECT },
+    { "usampler2DRect",           USAMPLER2DRECT },
+    { "isamplerBuffer",           ISAMPLERBUFFER },
+    { "usamplerBuffer",           USAMPLERBUFFER },
+    { "sampler2DMS",              SAMPLER2DMS },
+    { "isampler2DMS",             ISAMPLER2DMS },
+    { "usampler2DMS",             USAMPLER2DMS },
+    { "sampler2DMSArray",         SAMPLER2DMSARRAY },
+    { "isampler2DMSArray",        ISAMPLER2DMSARRAY },
+    { "usampler2DMSArray",        USAMPLER2DMSARRAY },
+    { "sampler1D",                SAMPLER1D },
+    { "sampler1DShadow",          SAMPLER1DSHADOW },
+    { "sampler3D",                SAMPLER3D },
+    { "sampler2DShadow",          SAMPLER2DSHADOW },
+    { "sampler2DRect",            SAMPLER2DRECT },
+    { "sampler2DRectShadow",      SAMPLER2DRECTSHADOW },
+    { "sampler1DArray",           SAMPLER1DARRAY },
+
+    { "samplerExternalOES",       SAMPLEREXTERNALOES },
+
+    { "sampler",                  SAMPLER },
+    { "samplerShadow",            SAMPLERSHADOW },
+
+    { "texture2D",                TEXTURE2D },
+    { "textureCube",              TEXTURECUBE },
+    { "textureCubeArray",         TEXTURECUBEARRAY },
+    { "itextureCubeArray",        ITEXTURECUBEARRAY },
+    { "utextureCubeArray",        UTEXTURECUBEARRAY },
+    { "itexture1DArray",          ITEXTURE1DARRAY },
+    { "utexture1D",               UTEXTURE1D },
+    { "itexture1D",               ITEXTURE1D },
+    { "utexture1DArray",          UTEXTURE1DARRAY },
+    { "textureBuffer",            TEXTUREBUFFER },
+    { "texture2DArray",           TEXTURE2DARRAY },
+    { "itexture2D",               ITEXTURE2D },
+    { "itexture3D",               ITEXTURE3D },
+    { "itextureCube",             ITEXTURECUBE },
+    { "itexture2DArray",          ITEXTURE2DARRAY },
+    { "utexture2D",               UTEXTURE2D },
+    { "utexture3D",               UTEXTURE3D },
+    { "utextureCube",             UTEXTURECUBE },
+    { "utexture2DArray",          UTEXTURE2DARRAY },
+    { "itexture2DRect",           ITEXTURE2DRECT },
+    { "utexture2DRect",           UTEXTURE2DRECT },
+    { "itextureBuffer",           ITEXTUREBUFFER },
+    { "utextureBuffer",           UTEXTUREBUFFER },
+    { "texture2DMS",              TEXTURE2DMS },
+    { "itexture2DMS",             ITEXTURE2DMS },
+    { "utexture2DMS",             UTEXTURE2DMS },
+    { "texture2DMSArray",         TEXTURE2DMSARRAY },
+    { "itexture2DMSArray",        ITEXTURE2DMSARRAY },
+    { "utexture2DMSArray",        UTEXTURE2DMSARRAY },
+    { "texture1D",                TEXTURE1D },
+    { "texture3D",                TEXTURE3D },
+    { "texture2DRect",            TEXTURE2DRECT },
+    { "texture1DArray",           TEXTURE1DARRAY },
+
+    { "subpassInput",             SUBPASSINPUT },
+    { "subpassInputMS",           SUBPASSINPUTMS },
+    { "isubpassInput",            ISUBPASSINPUT },
+    { "isubpassInputMS",          ISUBPASSINPUTMS },
+    { "usubpassInput",            USUBPASSINPUT },
+    { "usubpassInputMS",          USUBPASSINPUTMS },
+
+    { "noperspective",            NOPERSPECTIVE },
+    { "smooth",                   SMOOTH },
+    { "flat",                     FLAT },
+#ifdef AMD_EXTENSIONS
+    { "__explicitInterpAMD",      __EXPLICITINTERPAMD },
+#endif
+    { "centroid",                 CENTROID },
+    { "precise",                  PRECISE },
+    { "invariant",                INVARIANT },
+    { "packed",                   PACKED },
+    { "resource",                 RESOURCE },
+    { "superp",                   SUPERP },
+
+    // reserved words
+    { "common",                   ReservedWord },
+    { "partition",                ReservedWord },
+    { "active",                   ReservedWord },
+    { "asm",                      ReservedWord },
+    { "class",                    ReservedWord },
+    { "union",                    ReservedWord },
+    { "enum",                     ReservedWord },
+    { "typedef",                  ReservedWord },
+    { "template",                 ReservedWord },
+    { "this",                     ReservedWord },
+    { "goto",                     ReservedWord },
+    { "inline",                   ReservedWord },
+    { "noinline",                 ReservedWord },
+    { "public",                   ReservedWord },
+    { "static",                   ReservedWord },
+    { "extern",                   ReservedWord },
+    { "external",                 ReservedWord },
+    { "interface",                ReservedWord },
+    { "long",                     ReservedWord },
+    { "short",                    ReservedWord },
+    { "half",                     ReservedWord },
+    { "fixed",                    ReservedWord },
+    { "unsigned",                 ReservedWord },
+    { "input",                    ReservedWord },
+    { "output",                   ReservedWord },
+    { "hvec2",                    ReservedWord },
+    { "hvec3",                    ReservedWord },
+    { "hvec4",                    ReservedWord },
+    { "fvec2",                    ReservedWord },
+    { "fvec3",                    ReservedWord },
+    { "fvec4",                    ReservedWord },
+    { "sampler3DRect",            ReservedWord },
+    { "filter",                   ReservedWord },
+    { "sizeof",                   ReservedWord },
+    { "cast",                     ReservedWord },
+    { "namespace",                ReservedWord },
+    { "using",                    ReservedWord },
+};
+
+//
+// A perfect hash of Keywords, built by hash and displace: the hash of a name
+// selects a bucket, and that bucket's displacement (found when the table is
+// built) moves its names to slots no other name uses.  So, a lookup costs a
+// single hash of the name and a single string compare, and no allocation.
+//
+class TKeywordTable {
+public:
+    TKeywordTable();
+
+    // Returns the keyword or reserved word with this name, or nullptr if there is none.
+    const TKeyword* find(const char* name) const
     {
-        // djb2
-        unsigned long hash = 5381;
-        int c;
+        const unsigned int hash = hashName(name);
+        const int index = slots[slotOf(hash, displacements[hash % BucketCount])];
+        if (index >= 0 && strcmp(Keywords[index].name, name) == 0)
+            return &Keywords[index];
 
-        while ((c = *str++) != 0)
-            hash = ((hash << 5) + hash) + c;
+        return nullptr;
+    }
+
+private:
+    static const int NumKeywords = sizeof(Keywords) / sizeof(Keywords[0]);
+    static const int BucketCount = 128;
+    static const int SlotCount = 512;  // power of 2, and at least NumKeywords
+
+    // FNV-1a
+    static unsigned int hashName(const char* name)
+    {
+        unsigned int hash = 2166136261u;
+        for (; *name != 0; ++name)
+            hash = (hash ^ (unsigned char)*name) * 16777619u;
 
         return hash;
     }
-};
 
-// A single global usable by all threads, by all versions, by all languages.
-// After a single process-level initialization, this is read only and thread safe
-std::unordered_map<const char*, int, str_hash, str_eq>* KeywordMap = nullptr;
-std::unordered_set<const char*, str_hash, str_eq>* ReservedSet = nullptr;
+    // Mixes the displacement into the hash (with the murmur3 finalizer), so
+    // each displacement moves the names of a bucket to unrelated slots.
+    static unsigned int slotOf(unsigned int hash, unsigned int displacement)
+    {
+        hash ^= displacement * 0x9e3779b9u;
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6bu;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35u;
+        hash ^= hash >> 16;
+
+        return hash & (SlotCount - 1);
+    }
 
+    unsigned int displacements[BucketCount];
+    short slots[SlotCount];  // index into Keywords, or -1 if unused
 };
 
-namespace glslang {
-
-void TScanContext::fillInKeywordMap()
+TKeywordTable::TKeywordTable()
 {
-    if (KeywordMap != nullptr) {
-        // this is really an error, as this should called only once per process
-        // but, the only risk is if two threads called simultaneously
-        return;
+    static_assert(NumKeywords <= SlotCount, "keyword table needs more slots");
+
+    std::vector<unsigned int> hashes[BucketCount];
+    std::vector<int> names[BucketCount];
+    for (int k = 0; k < NumKeywords; ++k) {
+        const unsigned int hash = hashName(Keywords[k].name);
+        hashes[hash % BucketCount].push_back(hash);
+        names[hash % BucketCount].push_back(k);
+    }
+
+    // Place the fullest buckets first, while there are the most free slots to choose from
+    int order[BucketCount];
+    for (int b = 0; b < BucketCount; ++b)
+        order[b] = b;
+    std::stable_sort(order, order + BucketCount, [&names](int a, int b) { return names[a].size() > names[b].size(); });
+
+    for (int s = 0; s < SlotCount; ++s)
+        slots[s] = -1;
+
+    for (int b : order) {
+        const std::vector<unsigned int>& bucket = hashes[b];
+        for (unsigned int displacement = 0; ; ++displacement) {
+            bool placed = true;
+            for (size_t i = 0; i < bucket.size() && placed; ++i) {
+                const unsigned int slot = slotOf(bucket[i], displacement);
+                placed = slots[slot] < 0;
+                for (size_t j = 0; j < i && placed; ++j)
+                    placed = slot != slotOf(bucket[j], displacement);
+            }
+
+            if (placed) {
+                displacements[b] = displacement;
+                for (size_t i = 0; i < bucket.size(); ++i)
+                    slots[slotOf(bucket[i], displacement)] = (short)names[b][i];
+                break;
+            }
+
+            // two names with the same hash could never be placed
+            assert(displacement < 1000000);
+        }
     }
-    KeywordMap = new std::unordered_map<const char*, int, str_hash, str_eq>;
-
-    (*KeywordMap)["const"] =                   CONST;
-    (*KeywordMap)["uniform"] =                 UNIFORM;
-    (*KeywordMap)["in"] =                      IN;
-    (*KeywordMap)["out"] =                     OUT;
-    (*KeywordMap)["inout"] =                   INOUT;
-    (*KeywordMap)["struct"] =                  STRUCT;
-    (*KeywordMap)["break"] =                   BREAK;
-    (*KeywordMap)["continue"] =                CONTINUE;
-    (*KeywordMap)["do"] =                      DO;
-    (*KeywordMap)["for"] =                     FOR;
-    (*KeywordMap)["while"] =                   WHILE;
-    (*KeywordMap)["switch"] =                  SWITCH;
-    (*KeywordMap)["case"] =                    CASE;
-    (*KeywordMap)["default"] =                 DEFAULT;
-    (*KeywordMap)["if"] =                      IF;
-    (*KeywordMap)["else"] =                    ELSE;
-    (*KeywordMap)["discard"] =                 DISCARD;
-    (*KeywordMap)["return"] =                  RETURN;
-    (*KeywordMap)["void"] =                    VOID;
-    (*KeywordMap)["bool"] =                    BOOL;
-    (*KeywordMap)["float"] =                   FLOAT;
-    (*KeywordMap)["int"] =                     INT;
-    (*KeywordMap)["bvec2"] =                   BVEC2;
-    (*KeywordMap)["bvec3"] =                   BVEC3;
-    (*KeywordMap)["bvec4"] =                   BVEC4;
-    (*KeywordMap)["vec2"] =                    VEC2;
-    (*KeywordMap)["vec3"] =                    VEC3;
-    (*KeywordMap)["vec4"] =                    VEC4;
-    (*KeywordMap)["ivec2"] =                   IVEC2;
-    (*KeywordMap)["ivec3"] =                   IVEC3;
-    (*KeywordMap)["ivec4"] =                   IVEC4;
-    (*KeywordMap)["mat2"] =                    MAT2;
-    (*KeywordMap)["mat3"] =                    MAT3;
-    (*KeywordMap)["mat4"] =                    MAT4;
-    (*KeywordMap)["true"] =                    BOOLCONSTANT;
-    (*KeywordMap)["false"] =                   BOOLCONSTANT;
-    (*KeywordMap)["attribute"] =               ATTRIBUTE;
-    (*KeywordMap)["varying"] =                 VARYING;
-    (*KeywordMap)["buffer"] =                  BUFFER;
-    (*KeywordMap)["coherent"] =                COHERENT;
-    (*KeywordMap)["restrict"] =                RESTRICT;
-    (*KeywordMap)["readonly"] =                READONLY;
-    (*KeywordMap)["writeonly"] =               WRITEONLY;
-    (*KeywordMap)["atomic_uint"] =             ATOMIC_UINT;
-    (*KeywordMap)["volatile"] =                VOLATILE;
-    (*KeywordMap)["layout"] =                  LAYOUT;
-    (*KeywordMap)["shared"] =                  SHARED;
-    (*KeywordMap)["patch"] =                   PATCH;
-    (*KeywordMap)["sample"] =                  SAMPLE;
-    (*KeywordMap)["subroutine"] =              SUBROUTINE;
-    (*KeywordMap)["highp"] =                   HIGH_PRECISION;
-    (*KeywordMap)["mediump"] =                 MEDIUM_PRECISION;
-    (*KeywordMap)["lowp"] =                    LOW_PRECISION;
-    (*KeywordMap)["precision"] =               PRECISION;
-    (*KeywordMap)["mat2x2"] =                  MAT2X2;
-    (*KeywordMap)["mat2x3"] =                  MAT2X3;
-    (*KeywordMap)["mat2x4"] =                  MAT2X4;
-    (*KeywordMap)["mat3x2"] =                  MAT3X2;
-    (*KeywordMap)["mat3x3"] =                  MAT3X3;
-    (*KeywordMap)["mat3x4"] =                  MAT3X4;
-    (*KeywordMap)["mat4x2"] =                  MAT4X2;
-    (*KeywordMap)["mat4x3"] =                  MAT4X3;
-    (*KeywordMap)["mat4x4"] =                  MAT4X4;
-    (*KeywordMap)["dmat2"] =                   DMAT2;
-    (*KeywordMap)["dmat3"] =                   DMAT3;
-    (*KeywordMap)["dmat4"] =                   DMAT4;
-    (*KeywordMap)["dmat2x2"] =                 DMAT2X2;
-    (*KeywordMap)["dmat2x3"] =                 DMAT2X3;
-    (*KeywordMap)["dmat2x4"] =                 DMAT2X4;
-    (*KeywordMap)["dmat3x2"] =                 DMAT3X2;
-    (*KeywordMap)["dmat3x3"] =                 DMAT3X3;
-    (*KeywordMap)["dmat3x4"] =                 DMAT3X4;
-    (*KeywordMap)["dmat4x2"] =                 DMAT4X2;
-    (*KeywordMap)["dmat4x3"] =                 DMAT4X3;
-    (*KeywordMap)["dmat4x4"] =                 DMAT4X4;
-    (*KeywordMap)["image1D"] =                 IMAGE1D;
-    (*KeywordMap)["iimage1D"] =                IIMAGE1D;
-    (*KeywordMap)["uimage1D"] =                UIMAGE1D;
-    (*KeywordMap)["image2D"] =                 IMAGE2D;
-    (*KeywordMap)["iimage2D"] =                IIMAGE2D;
-    (*KeywordMap)["uimage2D"] =                UIMAGE2D;
-    (*KeywordMap)["image3D"] =                 IMAGE3D;
-    (*KeywordMap)["iimage3D"] =                IIMAGE3D;
-    (*KeywordMap)["uimage3D"] =                UIMAGE3D;
-    (*KeywordMap)["image2DRect"] =             IMAGE2DRECT;
-    (*KeywordMap)["iimage2DRect"] =            IIMAGE2DRECT;
-    (*KeywordMap)["uimage2DRect"] =            UIMAGE2DRECT;
-    (*KeywordMap)["imageCube"] =               IMAGECUBE;
-    (*KeywordMap)["iimageCube"] =              IIMAGECUBE;
-    (*KeywordMap)["uimageCube"] =              UIMAGECUBE;
-    (*KeywordMap)["imageBuffer"] =             IMAGEBUFFER;
-    (*KeywordMap)["iimageBuffer"] =            IIMAGEBUFFER;
-    (*KeywordMap)["uimageBuffer"] =            UIMAGEBUFFER;
-    (*KeywordMap)["image1DArray"] =            IMAGE1DARRAY;
-    (*KeywordMap)["iimage1DArray"] =           IIMAGE1DARRAY;
-    (*KeywordMap)["uimage1DArray"] =           UIMAGE1DARRAY;
-    (*KeywordMap)["image2DArray"] =            IMAGE2DARRAY;
-    (*KeywordMap)["iimage2DArray"] =           IIMAGE2DARRAY;
-    (*KeywordMap)["uimage2DArray"] =           UIMAGE2DARRAY;
-    (*KeywordMap)["imageCubeArray"] =          IMAGECUBEARRAY;
-    (*KeywordMap)["iimageCubeArray"] =         IIMAGECUBEARRAY;
-    (*KeywordMap)["uimageCubeArray"] =         UIMAGECUBEARRAY;
-    (*KeywordMap)["image2DMS"] =               IMAGE2DMS;
-    (*KeywordMap)["iimage2DMS"] =              IIMAGE2DMS;
-    (*KeywordMap)["uimage2DMS"] =              UIMAGE2DMS;
-    (*KeywordMap)["image2DMSArray"] =          IMAGE2DMSARRAY;
-    (*KeywordMap)["iimage2DMSArray"] =         IIMAGE2DMSARRAY;
-    (*KeywordMap)["uimage2DMSArray"] =         UIMAGE2DMSARRAY;
-    (*KeywordMap)["double"] =                  DOUBLE;
-    (*KeywordMap)["dvec2"] =                   DVEC2;
-    (*KeywordMap)["dvec3"] =                   DVEC3;
-    (*KeywordMap)["dvec4"] =                   DVEC4;
-    (*KeywordMap)["uint"] =                    UINT;
-    (*KeywordMap)["uvec2"] =                   UVEC2;
-    (*KeywordMap)["uvec3"] =                   UVEC3;
-    (*KeywordMap)["uvec4"] =                   UVEC4;
-
-    (*KeywordMap)["int64_t"] =                 INT64_T;
-    (*KeywordMap)["uint64_t"] =                UINT64_T;
-    (*KeywordMap)["i64vec2"] =                 I64VEC2;
-    (*KeywordMap)["i64vec3"] =                 I64VEC3;
-    (*KeywordMap)["i64vec4"] =                 I64VEC4;
-    (*KeywordMap)["u64vec2"] =                 U64VEC2;
-    (*KeywordMap)["u64vec3"] =                 U64VEC3;
-    (*KeywordMap)["u64vec4"] =                 U64VEC4;
-
-    (*KeywordMap)["sampler2D"] =               SAMPLER2D;
-    (*KeywordMap)["samplerCube"] =             SAMPLERCUBE;
-    (*KeywordMap)["samplerCubeArray"] =        SAMPLERCUBEARRAY;
-    (*KeywordMap)["samplerCubeArrayShadow"] =  SAMPLERCUBEARRAYSHADOW;
-    (*KeywordMap)["isamplerCubeArray"] =       ISAMPLERCUBEARRAY;
-    (*KeywordMap)["usamplerCubeArray"] =       USAMPLERCUBEARRAY;
-    (*KeywordMap)["sampler1DArrayShadow"] =    SAMPLER1DARRAYSHADOW;
-    (*KeywordMap)["isampler1DArray"] =         ISAMPLER1DARRAY;
-    (*KeywordMap)["usampler1D"] =              USAMPLER1D;
-    (*KeywordMap)["isampler1D"] =              ISAMPLER1D;
-    (*KeywordMap)["usampler1DArray"] =         USAMPLER1DARRAY;
-    (*KeywordMap)["samplerBuffer"] =           SAMPLERBUFFER;
-    (*KeywordMap)["samplerCubeShadow"] =       SAMPLERCUBESHADOW;
-    (*KeywordMap)["sampler2DArray"] =          SAMPLER2DARRAY;
-    (*KeywordMap)["sampler2DArrayShadow"] =    SAMPLER2DARRAYSHADOW;
-    (*KeywordMap)["isampler2D"] =              ISAMPLER2D;
-    (*KeywordMap)["isampler3D"] =              ISAMPLER3D;
-    (*KeywordMap)["isamplerCube"] =            ISAMPLERCUBE;
-    (*KeywordMap)["isampler2DArray"] =         ISAMPLER2DARRAY;
-    (*KeywordMap)["usampler2D"] =              USAMPLER2D;
-    (*KeywordMap)["usampler3D"] =              USAMPLER3D;
-    (*KeywordMap)["usamplerCube"] =            USAMPLERCUBE;
-    (*KeywordMap)["usampler2DArray"] =         USAMPLER2DARRAY;
-    (*KeywordMap)["isampler2DRect"] =          ISAMPLER2DRECT;
-    (*KeywordMap)["usampler2DRect"] =          USAMPLER2DRECT;
-    (*KeywordMap)["isamplerBuffer"] =          ISAMPLERBUFFER;
-    (*KeywordMap)["usamplerBuffer"] =          USAMPLERBUFFER;
-    (*KeywordMap)["sampler2DMS"] =             SAMPLER2DMS;
-    (*KeywordMap)["isampler2DMS"] =            ISAMPLER2DMS;
-    (*KeywordMap)["usampler2DMS"] =            USAMPLER2DMS;
-    (*KeywordMap)["sampler2DMSArray"] =        SAMPLER2DMSARRAY;
-    (*KeywordMap)["isampler2DMSArray"] =       ISAMPLER2DMSARRAY;
-    (*KeywordMap)["usampler2DMSArray"] =       USAMPLER2DMSARRAY;
-    (*KeywordMap)["sampler1D"] =               SAMPLER1D;
-    (*KeywordMap)["sampler1DShadow"] =         SAMPLER1DSHADOW;
-    (*KeywordMap)["sampler3D"] =               SAMPLER3D;
-    (*KeywordMap)["sampler2DShadow"] =         SAMPLER2DSHADOW;
-    (*KeywordMap)["sampler2DRect"] =           SAMPLER2DRECT;
-    (*KeywordMap)["sampler2DRectShadow"] =     SAMPLER2DRECTSHADOW;
-    (*KeywordMap)["sampler1DArray"] =          SAMPLER1DARRAY;
-
-    (*KeywordMap)["samplerExternalOES"] =      SAMPLEREXTERNALOES; // GL_OES_EGL_image_external
-
-    (*KeywordMap)["sampler"] =                 SAMPLER;
-    (*KeywordMap)["samplerShadow"] =           SAMPLERSHADOW;
-
-    (*KeywordMap)["texture2D"] =               TEXTURE2D;
-    (*KeywordMap)["textureCube"] =             TEXTURECUBE;
-    (*KeywordMap)["textureCubeArray"] =        TEXTURECUBEARRAY;
-    (*KeywordMap)["itextureCubeArray"] =       ITEXTURECUBEARRAY;
-    (*KeywordMap)["utextureCubeArray"] =       UTEXTURECUBEARRAY;
-    (*KeywordMap)["itexture1DArray"] =         ITEXTURE1DARRAY;
-    (*KeywordMap)["utexture1D"] =              UTEXTURE1D;
-    (*KeywordMap)["itexture1D"] =              ITEXTURE1D;
-    (*KeywordMap)["utexture1DArray"] =         UTEXTURE1DARRAY;
-    (*KeywordMap)["textureBuffer"] =           TEXTUREBUFFER;
-    (*KeywordMap)["texture2DArray"] =          TEXTURE2DARRAY;
-    (*KeywordMap)["itexture2D"] =              ITEXTURE2D;
-    (*KeywordMap)["itexture3D"] =              ITEXTURE3D;
-    (*KeywordMap)["itextureCube"] =            ITEXTURECUBE;
-    (*KeywordMap)["itexture2DArray"] =         ITEXTURE2DARRAY;
-    (*KeywordMap)["utexture2D"] =              UTEXTURE2D;
-    (*KeywordMap)["utexture3D"] =              UTEXTURE3D;
-    (*KeywordMap)["utextureCube"] =            UTEXTURECUBE;
-    (*KeywordMap)["utexture2DArray"] =         UTEXTURE2DARRAY;
-    (*KeywordMap)["itexture2DRect"] =          ITEXTURE2DRECT;
-    (*KeywordMap)["utexture2DRect"] =          UTEXTURE2DRECT;
-    (*KeywordMap)["itextureBuffer"] =          ITEXTUREBUFFER;
-    (*KeywordMap)["utextureBuffer"] =          UTEXTUREBUFFER;
-    (*KeywordMap)["texture2DMS"] =             TEXTURE2DMS;
-    (*KeywordMap)["itexture2DMS"] =            ITEXTURE2DMS;
-    (*KeywordMap)["utexture2DMS"] =            UTEXTURE2DMS;
-    (*KeywordMap)["texture2DMSArray"] =        TEXTURE2DMSARRAY;
-    (*KeywordMap)["itexture2DMSArray"] =       ITEXTURE2DMSARRAY;
-    (*KeywordMap)["utexture2DMSArray"] =       UTEXTURE2DMSARRAY;
-    (*KeywordMap)["texture1D"] =               TEXTURE1D;
-    (*KeywordMap)["texture3D"] =               TEXTURE3D;
-    (*KeywordMap)["texture2DRect"] =           TEXTURE2DRECT;
-    (*KeywordMap)["texture1DArray"] =          TEXTURE1DARRAY;
-
-    (*KeywordMap)["subpassInput"] =            SUBPASSINPUT;
-    (*KeywordMap)["subpassInputMS"] =          SUBPASSINPUTMS;
-    (*KeywordMap)["isubpassInput"] =           ISUBPASSINPUT;
-    (*KeywordMap)["isubpassInputMS"] =         ISUBPASSINPUTMS;
-    (*KeywordMap)["usubpassInput"] =           USUBPASSINPUT;
-    (*KeywordMap)["usubpassInputMS"] =         USUBPASSINPUTMS;
-
-    (*KeywordMap)["noperspective"] =           NOPERSPECTIVE;
-    (*KeywordMap)["smooth"] =                  SMOOTH;
-    (*KeywordMap)["flat"] =                    FLAT;
-#ifdef AMD_EXTENSIONS
-    (*KeywordMap)["__explicitInterpAMD"] =     __EXPLICITINTERPAMD;
-#endif
-    (*KeywordMap)["centroid"] =                CENTROID;
-    (*KeywordMap)["precise"] =                 PRECISE;
-    (*KeywordMap)["invariant"] =               INVARIANT;
-    (*KeywordMap)["packed"] =                  PACKED;
-    (*KeywordMap)["resource"] =                RESOURCE;
-    (*KeywordMap)["superp"] =                  SUPERP;
-
-    ReservedSet = new std::unordered_set<const char*, str_hash, str_eq>;
-
-    ReservedSet->insert("common");
-    ReservedSet->insert("partition");
-    ReservedSet->insert("active");
-    ReservedSet->insert("asm");
-    ReservedSet->insert("class");
-    ReservedSet->insert("union");
-    ReservedSet->insert("enum");
-    ReservedSet->insert("typedef");
-    ReservedSet->insert("template");
-    ReservedSet->insert("this");
-    ReservedSet->insert("goto");
-    ReservedSet->insert("inline");
-    ReservedSet->insert("noinline");
-    ReservedSet->insert("public");
-    ReservedSet->insert("static");
-    ReservedSet->insert("extern");
-    ReservedSet->insert("external");
-    ReservedSet->insert("interface");
-    ReservedSet->insert("long");
-    ReservedSet->insert("short");
-    ReservedSet->insert("half");
-    ReservedSet->insert("fixed");
-    ReservedSet->insert("unsigned");
-    ReservedSet->insert("input");
-    ReservedSet->insert("output");
-    ReservedSet->insert("hvec2");
-    ReservedSet->insert("hvec3");
-    ReservedSet->insert("hvec4");
-    ReservedSet->insert("fvec2");
-    ReservedSet->insert("fvec3");
-    ReservedSet->insert("fvec4");
-    ReservedSet->insert("sampler3DRect");
-    ReservedSet->insert("filter");
-    ReservedSet->insert("sizeof");
-    ReservedSet->insert("cast");
-    ReservedSet->insert("namespace");
-    ReservedSet->insert("using");
 }
 
-void TScanContext::deleteKeywordMap()
+// Built on first use (and thread safe), rather than at process initialization.
+const TKeywordTable& GetKeywordTable()
 {
-    delete KeywordMap;
-    KeywordMap = nullptr;
-    delete ReservedSet;
-    ReservedSet = nullptr;
+    static const TKeywordTable table;
+    return table;
 }
 
+};
+
+namespace glslang {
+
 // Called by yylex to get the next token.
 // Returning 0 implies end of input.
 int TScanContext::tokenize(TPpContext* pp, TParserToken& token)
@@ -708,15 +876,16 @@ int TScanContext::tokenize(TPpContext* pp, TParserToken& token)
 
 int TScanContext::tokenizeIdentifier()
 {
-    if (ReservedSet->find(tokenText) != ReservedSet->end())
-        return reservedWord();
-
-    auto it = KeywordMap->find(tokenText);
-    if (it == KeywordMap->end()) {
+    const TKeyword* entry = GetKeywordTable().find(tokenText);
+    if (entry == nullptr) {
         // Should have an identifier of some sort
         return identifierOrType();
     }
-    keyword = it->second;
+
+    if (entry->token == ReservedWord)
+        return reservedWord();
+
+    keyword = entry->token;
 
     switch (keyword) {
     case CONST:
@@ -215,6 +215,13 @@ public:
     // Returns the index (starting from 0) of the most recent valid source string we are reading from.
     int getLastValidSourceIndex() const { return std::min(currentSource, numSources - 1); }
 
+    // Bulk forms of get(), for skipping whitespace and comment bodies: each
+    // advances past a run of characters, within the current string only (it
+    // stops short of the string's last character, leaving crossing to the
+    // next string to get()).  Neither skips a '\n', so only the column moves.
+    void skipSpaceTab();
+    void skipUntil(unsigned char a, unsigned char b);  // stops in front of a, b, or a '\n'
+
     void consumeWhiteSpace(bool& foundNonSpaceTab);
     bool consumeComment();
     void consumeWhitespaceComment(bool& foundNonSpaceTab);
@@ -222,6 +229,22 @@ public:
 
 protected:
 
+    // how many characters skipUntil() and skipSpaceTab() may skip
+    size_t skippable() const
+    {
+        if (currentSource >= numSources || currentChar >= lengths[currentSource])
+            return 0;
+        return lengths[currentSource] - currentChar - 1;
+    }
+
+    // advance past count characters that are all within the current string, and none of which is a '\n'
+    void skip(size_t count)
+    {
+        currentChar += count;
+        loc[currentSource].column += (int)count;
+        logicalSourceLoc.column += (int)count;
+    }
+
     // advance one character
     void advance()
     {
@@ -51,9 +51,6 @@ public:
     explicit TScanContext(TParseContextBase& pc) : parseContext(pc), afterType(false), field(false) { }
     virtual ~TScanContext() { }
 
-    static void fillInKeywordMap();
-    static void deleteKeywordMap();
-
     int tokenize(TPpContext*, TParserToken&);
 
 protected:
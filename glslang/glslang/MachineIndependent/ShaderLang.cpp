@@ -380,7 +380,8 @@ void SetupBuiltinSymbolTable(int version, EProfile profile, const SpvVersion& sp
 
 // Return true if the shader was correctly specified for version/profile/stage.
 bool DeduceVersionProfile(TInfoSink& infoSink, EShLanguage stage, bool versionNotFirst, int defaultVersion,
-                          EShSource source, int& version, EProfile& profile, const SpvVersion& spvVersion)
+                          EShSource source, int& version, EProfile& profile, const SpvVersion& spvVersion,
+                          EShMessages messages)
 {
     const int FirstProfileVersion = 150;
     bool correct = true;
@@ -511,6 +512,9 @@ bool DeduceVersionProfile(TInfoSink& infoSink, EShLanguage stage, bool versionNo
     }
 
     // A meta check on the condition of the compiler itself...
+    if (messages & EShMsgSuppressWarnings)
+        return correct;
+
     switch (version) {
 
     // ES versions
@@ -577,7 +581,11 @@ bool ProcessDeferred(
     TIntermediate& intermediate, // returned tree, etc.
     ProcessingContext& processingContext,
     bool requireNonempty,
-    TShader::Includer& includer
+    TShader::Includer& includer,
+    // if non-null, the trusted #version directive the user's strings open with, so they needn't be scanned for it
+    const TShader::VersionHint* versionHint,
+    // if non-null, gets the directive found, when it can be passed back as a versionHint
+    TShader::VersionHint* sniffedVersion
     )
 {
     if (! InitThread())
@@ -621,12 +629,26 @@ bool ProcessDeferred(
 
     // First, without using the preprocessor or parser, find the #version, so we know what
     // symbol tables, processing rules, etc. to set up.  This does not need the extra strings
-    // outlined above, just the user shader.
+    // outlined above, just the user shader.  A hint stands in for the scan; it can only describe
+    // a directive no tokens come before (or the lack of one), so remember the scan when it does.
     int version;
     EProfile profile;
-    glslang::TInputScanner userInput(numStrings, &strings[numPre], &lengths[numPre]);  // no preamble
     bool versionNotFirstToken;
-    bool versionNotFirst = userInput.scanVersion(version, profile, versionNotFirstToken);
+    bool versionNotFirst;
+    if (versionHint != nullptr) {
+        version = versionHint->version;
+        profile = versionHint->profile;
+        versionNotFirst = versionHint->notFirst;
+        versionNotFirstToken = false;
+    } else {
+        glslang::TInputScanner userInput(numStrings, &strings[numPre], &lengths[numPre]);  // no preamble
+        versionNotFirst = userInput.scanVersion(version, profile, versionNotFirstToken);
+    }
+    if (sniffedVersion != nullptr && (version == 0 || ! versionNotFirstToken)) {
+        sniffedVersion->version = version;
+        sniffedVersion->profile = profile;
+        sniffedVersion->notFirst = versionNotFirst;
+    }
     bool versionNotFound = version == 0;
     if (forceDefaultVersionAndProfile) {
         if (! (messages & EShMsgSuppressWarnings) && ! versionNotFound &&
@@ -653,7 +675,7 @@ bool ProcessDeferred(
         spvVersion.vulkan = 100;     // TODO: eventually have this come from the outside
     else if (spvVersion.spv != 0)
         spvVersion.openGl = 100;     // TODO: eventually have this come from the outside
-    bool goodVersion = DeduceVersionProfile(compiler->infoSink, compiler->getLanguage(), versionNotFirst, defaultVersion, source, version, profile, spvVersion);
+    bool goodVersion = DeduceVersionProfile(compiler->infoSink, compiler->getLanguage(), versionNotFirst, defaultVersion, source, version, profile, spvVersion, messages);
     bool versionWillBeError = (versionNotFound || (profile == EEsProfile && version >= 300 && versionNotFirst));
     bool warnVersionNotFirst = false;
     if (! versionWillBeError && versionNotFirstToken) {
@@ -985,14 +1007,16 @@ bool PreprocessDeferred(
     EShMessages messages,       // warnings/errors/AST; things to print out
     TShader::Includer& includer,
     TIntermediate& intermediate, // returned tree, etc.
-    std::string* outputString)
+    std::string* outputString,
+    const TShader::VersionHint* versionHint,
+    TShader::VersionHint* sniffedVersion)
 {
     DoPreprocessing parser(outputString);
     return ProcessDeferred(compiler, shaderStrings, numStrings, inputLengths, stringNames,
                            preamble, optLevel, resources, defaultVersion,
                            defaultProfile, forceDefaultVersionAndProfile,
                            forwardCompatible, messages, intermediate, parser,
-                           false, includer);
+                           false, includer, versionHint, sniffedVersion);
 }
 
 
@@ -1022,14 +1046,16 @@ bool CompileDeferred(
     bool forwardCompatible,     // give errors for use of deprecated features
     EShMessages messages,       // warnings/errors/AST; things to print out
     TIntermediate& intermediate,// returned tree, etc.
-    TShader::Includer& includer)
+    TShader::Includer& includer,
+    const TShader::VersionHint* versionHint = nullptr,
+    TShader::VersionHint* sniffedVersion = nullptr)
 {
     DoFullParse parser;
     return ProcessDeferred(compiler, shaderStrings, numStrings, inputLengths, stringNames,
                            preamble, optLevel, resources, defaultVersion,
                            defaultProfile, forceDefaultVersionAndProfile,
                            forwardCompatible, messages, intermediate, parser,
-                           true, includer);
+                           true, includer, versionHint, sniffedVersion);
 }
 
 } // end anonymous namespace for local functions
@@ -1048,8 +1074,6 @@ int ShInitialize()
     if (! PerProcessGPA)
         PerProcessGPA = new TPoolAllocator();
 
-    glslang::TScanContext::fillInKeywordMap();
-
     return 1;
 }
 
@@ -1140,8 +1164,6 @@ int __fastcall ShFinalize()
         PerProcessGPA = 0;
     }
 
-    glslang::TScanContext::deleteKeywordMap();
-
     return 1;
 }
 
@@ -1446,8 +1468,11 @@ public:
 };
 
 TShader::TShader(EShLanguage s) 
-    : pool(0), stage(s), lengths(nullptr), stringNames(nullptr), preamble("")
+    : pool(0), stage(s), lengths(nullptr), stringNames(nullptr), preamble(""), hasVersionHint(false)
 {
+    sniffedVersion.version = 0;
+    sniffedVersion.profile = EBadProfile;
+    sniffedVersion.notFirst = false;
     infoSink = new TInfoSink;
     compiler = new TDeferredCompiler(stage, *infoSink);
     intermediate = new TIntermediate(s);
@@ -1508,7 +1533,8 @@ bool TShader::parse(const TBuiltInResource* builtInResources, int defaultVersion
     return CompileDeferred(compiler, strings, numStrings, lengths, stringNames,
                            preamble, EShOptNone, builtInResources, defaultVersion,
                            defaultProfile, forceDefaultVersionAndProfile,
-                           forwardCompatible, messages, *intermediate, includer);
+                           forwardCompatible, messages, *intermediate, includer,
+                           hasVersionHint ? &versionHint : nullptr, &sniffedVersion);
 }
 
 bool TShader::parse(const TBuiltInResource* builtInResources, int defaultVersion, bool forwardCompatible, EShMessages messages)
@@ -1536,7 +1562,17 @@ bool TShader::preprocess(const TBuiltInResource* builtInResources,
     return PreprocessDeferred(compiler, strings, numStrings, lengths, stringNames, preamble,
                               EShOptNone, builtInResources, defaultVersion,
                               defaultProfile, forceDefaultVersionAndProfile,
-                              forwardCompatible, message, includer, *intermediate, output_string);
+                              forwardCompatible, message, includer, *intermediate, output_string,
+                              hasVersionHint ? &versionHint : nullptr, &sniffedVersion);
+}
+
+bool TShader::getVersionHint(VersionHint& hint) const
+{
+    if (sniffedVersion.profile == EBadProfile)
+        return false;
+
+    hint = sniffedVersion;
+    return true;
 }
 
 const char* TShader::getInfoLog()
@@ -1549,6 +1585,11 @@ const char* TShader::getInfoDebugLog()
     return infoSink->debug.c_str();
 }
 
+const std::vector<TDiagnostic>& TShader::getDiagnostics() const
+{
+    return infoSink->info.getDiagnostics();
+}
+
 TProgram::TProgram() : pool(0), reflection(0), linked(false)
 {
     infoSink = new TInfoSink;
@@ -1592,11 +1633,26 @@ bool TProgram::link(EShMessages messages)
             error = true;
     }
 
-    // TODO: Link: cross-stage error checking
+    // Cross-stage error checking, between each stage and the next one present in the pipeline
+    if (! error) {
+        int producer = -1;
+        for (int s = EShLangVertex; s <= EShLangFragment; ++s) {
+            if (intermediate[s] == 0)
+                continue;
+            if (producer >= 0 && ! checkStageInterface(*infoSink, *intermediate[producer], *intermediate[s]))
+                error = true;
+            producer = s;
+        }
+    }
 
     return ! error;
 }
 
+bool TProgram::checkStageInterface(TInfoSink& infoSink, const TIntermediate& producer, const TIntermediate& consumer)
+{
+    return TIntermediate::crossStageCheck(infoSink, producer, consumer);
+}
+
 //
 // Merge the compilation units within the given stage into a single TIntermediate.
 //
@@ -52,6 +52,11 @@ namespace glslang {
 //
 void TType::buildMangledName(TString& mangledName)
 {
+    if (memberStrings) {
+        mangledName += memberStrings->mangledName;
+        return;
+    }
+
     if (isMatrix())
         mangledName += 'm';
     else if (isVector())
@@ -237,6 +242,25 @@ void TSymbolTableLevel::readOnly()
 {
     for (tLevel::iterator it = level.begin(); it != level.end(); ++it)
         (*it).second->makeReadOnly();
+
+    // a shared level is made read-only again by each table adopting it
+    if (indexed)
+        return;
+
+    nameIndex.reserve(level.size());
+    for (tLevel::const_iterator it = level.begin(); it != level.end(); ++it) {
+        nameIndex[it->first] = it->second;
+
+        TFunction* function = it->second->getAsFunction();
+        if (function) {
+            TVector<TVector<TFunction*> >& overloads = overloadIndex[function->getName()];
+            if (function->getParamCount() >= (int)overloads.size())
+                overloads.resize(function->getParamCount() + 1);
+            overloads[function->getParamCount()].push_back(function);
+        }
+    }
+
+    indexed = true;
 }
 
 //
@@ -260,8 +284,9 @@ TVariable::TVariable(const TVariable& copyOf) : TSymbol(copyOf)
 
     if (! copyOf.constArray.empty()) {
         assert(! copyOf.type.isStruct());
-        TConstUnionArray newArray(copyOf.constArray, 0, copyOf.constArray.size());
-        constArray = newArray;
+        // the copy can outlive the pool holding copyOf's components, so it can't share them
+        constArray = copyOf.constArray;
+        constArray.makeUnique();
     }
 
     // don't support specialization-constant subtrees in cloned tables
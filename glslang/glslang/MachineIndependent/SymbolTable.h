@@ -297,7 +297,7 @@ protected:
 class TSymbolTableLevel {
 public:
     POOL_ALLOCATOR_NEW_DELETE(GetThreadPoolAllocator())
-    TSymbolTableLevel() : defaultPrecision(0), anonId(0) { }
+    TSymbolTableLevel() : defaultPrecision(0), anonId(0), indexed(false) { }
     ~TSymbolTableLevel();
 
     bool insert(TSymbol& symbol, bool separateNameSpaces)
@@ -350,6 +350,11 @@ public:
 
     TSymbol* find(const TString& name) const
     {
+        if (indexed) {
+            tNameIndex::const_iterator it = nameIndex.find(name);
+            return it == nameIndex.end() ? 0 : it->second;
+        }
+
         tLevel::const_iterator it = level.find(name);
         if (it == level.end()) 
             return 0;
@@ -357,21 +362,42 @@ public:
             return (*it).second;
     }
 
-    void findFunctionNameList(const TString& name, TVector<TFunction*>& list)
+    // Add to 'list' the functions at this level with the name of the mangled 'name'
+    // that take 'paramCount' parameters.  Return true if there are functions with
+    // that name, even if none take that many parameters.
+    bool findFunctionNameList(const TString& name, int paramCount, TVector<TFunction*>& list) const
     {
         size_t parenAt = name.find_first_of('(');
-        TString base(name, 0, parenAt + 1);
+        TString base(name, 0, parenAt);
+
+        if (indexed) {
+            tOverloadIndex::const_iterator overloads = overloadIndex.find(base);
+            if (overloads == overloadIndex.end())
+                return false;
+            if (paramCount < (int)overloads->second.size())
+                list.insert(list.end(), overloads->second[paramCount].begin(), overloads->second[paramCount].end());
+            return true;
+        }
 
+        base += '(';
         tLevel::const_iterator begin = level.lower_bound(base);
         base[parenAt] = ')';  // assume ')' is lexically after '('
         tLevel::const_iterator end = level.upper_bound(base);
-        for (tLevel::const_iterator it = begin; it != end; ++it)
-            list.push_back(it->second->getAsFunction());
+        for (tLevel::const_iterator it = begin; it != end; ++it) {
+            TFunction* function = it->second->getAsFunction();
+            if (function->getParamCount() == paramCount)
+                list.push_back(function);
+        }
+
+        return begin != end;
     }
 
     // See if there is already a function in the table having the given non-function-style name.
     bool hasFunctionName(const TString& name) const
     {
+        if (indexed)
+            return overloadIndex.find(name) != overloadIndex.end();
+
         tLevel::const_iterator candidate = level.lower_bound(name);
         if (candidate != level.end()) {
             const TString& candidateName = (*candidate).first;
@@ -388,6 +414,19 @@ public:
     // Return true if name is found, and set variable to true if the name was a variable.
     bool findFunctionVariableName(const TString& name, bool& variable) const
     {
+        if (indexed) {
+            // as below, a variable is found before a function of the same name
+            if (nameIndex.find(name) != nameIndex.end()) {
+                variable = true;
+                return true;
+            }
+            if (overloadIndex.find(name) != overloadIndex.end()) {
+                variable = false;
+                return true;
+            }
+            return false;
+        }
+
         tLevel::const_iterator candidate = level.lower_bound(name);
         if (candidate != level.end()) {
             const TString& candidateName = (*candidate).first;
@@ -453,9 +492,18 @@ protected:
     typedef const tLevel::value_type tLevelPair;
     typedef std::pair<tLevel::iterator, bool> tInsertResult;
 
+    // Once a level is read-only, the lookups done for each function call hash into
+    // these instead of searching 'level': all its names, and its functions by base
+    // name, grouped by parameter count, each group in mangled-name order.
+    typedef TUnorderedMap<TString, TSymbol*> tNameIndex;
+    typedef TUnorderedMap<TString, TVector<TVector<TFunction*> > > tOverloadIndex;
+
     tLevel level;  // named mappings
     TPrecisionQualifier *defaultPrecision;
     int anonId;
+    bool indexed;
+    tNameIndex nameIndex;
+    tOverloadIndex overloadIndex;
 };
 
 class TSymbolTable {
@@ -624,23 +672,25 @@ public:
         return false;
     }
 
-    void findFunctionNameList(const TString& name, TVector<TFunction*>& list, bool& builtIn)
+    // Find the functions named by the mangled 'name' that take 'paramCount' parameters.
+    void findFunctionNameList(const TString& name, int paramCount, TVector<TFunction*>& list, bool& builtIn)
     {
         // For user levels, return the set found in the first scope with a match
         builtIn = false;
         int level = currentLevel();
+        bool found;
         do {
-            table[level]->findFunctionNameList(name, list);
+            found = table[level]->findFunctionNameList(name, paramCount, list);
             --level;
-        } while (list.empty() && level >= globalLevel);
+        } while (! found && level >= globalLevel);
 
-        if (! list.empty())
+        if (found)
             return;
 
         // Gather across all built-in levels; they don't hide each other
         builtIn = true;
         do {
-            table[level]->findFunctionNameList(name, list);
+            table[level]->findFunctionNameList(name, paramCount, list);
             --level;
         } while (level >= 0);
     }
@@ -362,6 +362,119 @@ void TIntermediate::mergeErrorCheck(TInfoSink& infoSink, const TIntermSymbol& sy
                                                              unitSymbol.getType().getCompleteString() << "\"\n";
 }
 
+// The name an input or output is matched by across stages: the block name for a block, since
+// instance names needn't match.
+static const TString& interfaceName(const TIntermSymbol& symbol)
+{
+    return symbol.getBasicType() == EbtBlock ? symbol.getType().getTypeName() : symbol.getName();
+}
+
+// Is this linker object a user-declared (not built-in) input or output of the given storage?
+static bool isUserInterface(const TIntermSymbol& symbol, TStorageQualifier storage)
+{
+    return symbol.getQualifier().storage == storage && symbol.getQualifier().builtIn == EbvNone &&
+           interfaceName(symbol).compare(0, 3, "gl_") != 0;
+}
+
+// Do two interfaces match by location?  Both must have one.
+static bool sameLocation(const TQualifier& output, const TQualifier& input)
+{
+    return output.hasLocation() && input.hasLocation() &&
+           output.layoutLocation == input.layoutLocation &&
+           output.layoutComponent == input.layoutComponent;
+}
+
+//
+// Check the outputs of one stage against the inputs of the next stage in the pipeline.
+//
+// Each user-declared input is matched to the output with the same location (and component), when
+// both have a location, and otherwise to the output with the same name (the same block name, for
+// a block).  Matched pairs must have the same type, once the extra per-vertex array level of
+// arrayed stages is stripped off, and an input the consumer accesses must have an output to match.
+//
+// Neither stage is changed, so stages finalized separately can be checked against each other.
+//
+// Return true for success.
+//
+bool TIntermediate::crossStageCheck(TInfoSink& infoSink, const TIntermediate& producer, const TIntermediate& consumer)
+{
+    // HLSL matches its stages by semantic, not by declaration
+    if (producer.treeRoot == nullptr || consumer.treeRoot == nullptr ||
+        producer.source != EShSourceGlsl || consumer.source != EShSourceGlsl)
+        return true;
+
+    const TIntermSequence& outputs = producer.findLinkerObjects();
+    const TIntermSequence& inputs = consumer.findLinkerObjects();
+
+    bool success = true;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const TIntermSymbol& input = *inputs[i]->getAsSymbolNode();
+        if (! isUserInterface(input, EvqVaryingIn))
+            continue;
+
+        // By location first, then by name among those that can't match by location
+        const TIntermSymbol* output = nullptr;
+        for (size_t o = 0; o < outputs.size() && output == nullptr; ++o) {
+            const TIntermSymbol& candidate = *outputs[o]->getAsSymbolNode();
+            if (isUserInterface(candidate, EvqVaryingOut) && sameLocation(candidate.getQualifier(), input.getQualifier()))
+                output = &candidate;
+        }
+        for (size_t o = 0; o < outputs.size() && output == nullptr; ++o) {
+            const TIntermSymbol& candidate = *outputs[o]->getAsSymbolNode();
+            if (isUserInterface(candidate, EvqVaryingOut) &&
+                ! (candidate.getQualifier().hasLocation() && input.getQualifier().hasLocation()) &&
+                interfaceName(candidate) == interfaceName(input))
+                output = &candidate;
+        }
+
+        if (output == nullptr) {
+            // Only an input that's accessed needs something written to it; a block's members can be
+            // accessed without its instance name, if it has none
+            bool accessed = consumer.inIoAccessed(input.getName());
+            if (input.getBasicType() == EbtBlock) {
+                const TTypeList& members = *input.getType().getStruct();
+                for (size_t m = 0; m < members.size() && ! accessed; ++m)
+                    accessed = consumer.inIoAccessed(members[m].type->getFieldName());
+            }
+
+            if (accessed) {
+                infoSink.info.prefix(EPrefixError);
+                infoSink.info << "Linking " << StageName(producer.language) << " and " << StageName(consumer.language) <<
+                                 " stages: Input has no matching output in the previous stage:\n";
+                infoSink.info << "    " << interfaceName(input) << ": \"" << input.getType().getCompleteString() << "\"\n";
+                success = false;
+            }
+            continue;
+        }
+
+        const TType& outputType = output->getType();
+        const TType& inputType = input.getType();
+        bool outputArrayed = outputType.isArray() && outputType.getQualifier().isArrayedIo(producer.language);
+        bool inputArrayed = inputType.isArray() && inputType.getQualifier().isArrayedIo(consumer.language);
+
+        bool match;
+        if (outputArrayed && inputArrayed)
+            match = TType(outputType, 0) == TType(inputType, 0);
+        else if (outputArrayed)
+            match = TType(outputType, 0) == inputType;
+        else if (inputArrayed)
+            match = outputType == TType(inputType, 0);
+        else
+            match = outputType == inputType;
+
+        if (! match) {
+            infoSink.info.prefix(EPrefixError);
+            infoSink.info << "Linking " << StageName(producer.language) << " and " << StageName(consumer.language) <<
+                             " stages: Types of matching output and input must match:\n";
+            infoSink.info << "    " << interfaceName(*output) << ": \"" << outputType.getCompleteString() << "\" versus " <<
+                             interfaceName(input) << ": \"" << inputType.getCompleteString() << "\"\n";
+            success = false;
+        }
+    }
+
+    return success;
+}
+
 //
 // Do final link-time error checking of a complete (merged) intermediate representation.
 // (Much error checking was done during merging).
@@ -326,6 +326,7 @@ public:
     void addToCallGraph(TInfoSink&, const TString& caller, const TString& callee);
     void merge(TInfoSink&, TIntermediate&);
     void finalCheck(TInfoSink&);
+    static bool crossStageCheck(TInfoSink&, const TIntermediate& producer, const TIntermediate& consumer);
 
     void addIoAccessed(const TString& name) { ioAccessed.insert(name); }
     bool inIoAccessed(const TString& name) const { return ioAccessed.find(name) != ioAccessed.end(); }
@@ -0,0 +1,82 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <cfloat>
+#include <cstdlib>
+
+#include "PpNumeric.h"
+
+namespace glslang {
+
+namespace {
+
+// Every power of ten a double holds exactly.
+const double ExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+const int MaxExactPowerOfTen = 22;
+
+};
+
+double TDecimalFloat::getValue(const char* text) const
+{
+    // The fast path relies on the multiply or divide being rounded once, to double; with
+    // x87 extended-precision evaluation it would be rounded twice.
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    if (fastPath) {
+        if (significand == 0)
+            return 0.0;
+
+        int power = exponent + (negativeExponent ? -exponentDigits : exponentDigits);
+        unsigned long long digits = significand;
+
+        // A power too large may still work, if some of it can move into the significand exactly
+        while (power > MaxExactPowerOfTen && digits <= MaxExactSignificand / 10) {
+            digits *= 10;
+            --power;
+        }
+
+        if (power >= 0 && power <= MaxExactPowerOfTen)
+            return (double)digits * ExactPowersOfTen[power];
+        if (power < 0 && power >= -MaxExactPowerOfTen)
+            return (double)digits / ExactPowersOfTen[-power];
+    }
+#endif
+
+    return strtod(text, nullptr);
+}
+
+} // end namespace glslang
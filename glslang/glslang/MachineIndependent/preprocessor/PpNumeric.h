@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef _PP_NUMERIC_INCLUDED_
+#define _PP_NUMERIC_INCLUDED_
+
+namespace glslang {
+
+//
+// Converts a decimal floating-point literal to a double while it is being
+// scanned, from its digits, instead of from its text afterward.
+//
+// The conversion is correctly rounded.  When the significant digits fit in a
+// double's 53 bits, and the power of ten is small enough to be exact too, a
+// single multiply or divide rounds correctly by itself (Clinger's fast path).
+// Otherwise, getValue() falls back to strtod() on the literal's text.
+//
+class TDecimalFloat {
+public:
+    TDecimalFloat() : significand(0), exponent(0), exponentDigits(0), negativeExponent(false), fastPath(true) { }
+
+    void addIntegerDigit(int digit) { addSignificantDigit(digit); }
+    void addFractionDigit(int digit)
+    {
+        addSignificantDigit(digit);
+        --exponent;
+    }
+
+    void setNegativeExponent() { negativeExponent = true; }
+    void addExponentDigit(int digit)
+    {
+        // far beyond any exponent that doesn't over or underflow, but small enough not to overflow itself
+        if (exponentDigits < 100000)
+            exponentDigits = exponentDigits * 10 + digit;
+    }
+
+    // Forces getValue() to convert the text, for when it's not the literal these digits describe.
+    void useText() { fastPath = false; }
+
+    // Returns the value, converting text (the whole literal) if the fast path can't be taken.
+    double getValue(const char* text) const;
+
+protected:
+    static const unsigned long long MaxExactSignificand = 1ull << 53;
+
+    void addSignificantDigit(int digit)
+    {
+        if (significand <= (MaxExactSignificand - digit) / 10)
+            significand = significand * 10 + digit;
+        else
+            fastPath = false;
+    }
+
+    unsigned long long significand;  // the digits, ignoring the decimal point
+    int exponent;                    // the power of ten the decimal point scales significand by
+    int exponentDigits;              // the written exponent, without its sign
+    bool negativeExponent;
+    bool fastPath;                   // whether significand holds every digit
+};
+
+} // end namespace glslang
+
+#endif // _PP_NUMERIC_INCLUDED_
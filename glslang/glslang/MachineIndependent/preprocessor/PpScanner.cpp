@@ -85,6 +85,7 @@ NVIDIA HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstring>
 
 #include "PpContext.h"
+#include "PpNumeric.h"
 #include "PpTokens.h"
 #include "../Scan.h"
 
@@ -122,6 +123,12 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
 
     str_len=len;
     char* str = ppToken->name;
+
+    // convert as the digits go by, rather than from the text afterward
+    TDecimalFloat value;
+    for (int i = 0; i < len; ++i)
+        value.addIntegerDigit(str[i] - '0');
+
     if (ch == '.') {
         HasDecimalOrExponent = true;
         str[len++] = (char)ch;
@@ -134,11 +141,13 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
                     len++;
                     str_len++;
                 }
+                value.addFractionDigit(ch - '0');
                 ch = getChar();
             } else {
                 parseContext.ppError(ppToken->loc, "float literal too long", "", "");
                 len = 1;
                 str_len = 1;
+                value.useText();
             }
         }
     }
@@ -151,6 +160,7 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
             parseContext.ppError(ppToken->loc, "float literal too long", "", "");
             len = 1;
             str_len = 1;
+            value.useText();
         } else {
             str[len++] = (char)ch;
             ch = getChar();
@@ -159,21 +169,25 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
                 ch = getChar();
             } else if (ch == '-') {
                 str[len++] = (char)ch;
+                value.setNegativeExponent();
                 ch = getChar();
             }
             if (ch >= '0' && ch <= '9') {
                 while (ch >= '0' && ch <= '9') {
                     if (len < MaxTokenLength) {
                         str[len++] = (char)ch;
+                        value.addExponentDigit(ch - '0');
                         ch = getChar();
                     } else {
                         parseContext.ppError(ppToken->loc, "float literal too long", "", "");
                         len = 1;
                         str_len = 1;
+                        value.useText();
                     }
                 }
             } else {
                 parseContext.ppError(ppToken->loc, "bad character in float exponent", "", "");
+                value.useText();
             }
         }
     }
@@ -198,6 +212,7 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
                 } else {
                     parseContext.ppError(ppToken->loc, "float literal too long", "", "");
                     len = 1,str_len=1;
+                    value.useText();
                 }
             }
         } else if (ch == 'f' || ch == 'F') {
@@ -211,13 +226,14 @@ int TPpContext::lFloatConst(int len, int ch, TPpToken* ppToken)
             else {
                 parseContext.ppError(ppToken->loc, "float literal too long", "", "");
                 len = 1,str_len=1;
+                value.useText();
             }
         } else 
             ungetChar();
 
         str[len]='\0';
 
-        ppToken->dval = strtod(str, nullptr);
+        ppToken->dval = value.getValue(str);
     }
 
     if (isDouble)
@@ -246,6 +262,7 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
     for (;;) {
         while (ch == ' ' || ch == '\t') {
             ppToken->space = true;
+            input->skipSpaceTab();
             ch = getch();
         }
 
@@ -641,6 +658,8 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
             if (ch == '/') {
                 pp->inComment = true;
                 do {
+                    // getch() only treats escapes and carriage returns specially
+                    input->skipUntil('\\', '\r');
                     ch = getch();
                 } while (ch != '\n' && ch != EndOfInput);
                 ppToken->space = true;
@@ -655,6 +674,7 @@ int TPpContext::tStringInput::scan(TPpToken* ppToken)
                             pp->parseContext.ppError(ppToken->loc, "End of input in comment", "comment", "");
                             return ch;
                         }
+                        input->skipUntil('*', '\\');
                         ch = getch();
                     }
                     ch = getch();
@@ -39,35 +39,38 @@
 
 #include "propagateNoContraction.h"
 
-#include <cstdlib>
-#include <string>
+#include <limits>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "localintermediate.h"
 namespace {
 
-// Use a string to hold the access chain information, as in most cases the
-// access chain is short and may contain only one element, which is the symbol
-// ID.
+// An access chain is the path from a symbol object to one of its nested
+// objects: the symbol, followed by the struct member index at each level.
 // Example: struct {float a; float b;} s;
-//  Object s.a will be represented with: <symbol ID of s>/0
-//  Object s.b will be represented with: <symbol ID of s>/1
-//  Object s will be represented with: <symbol ID of s>
+//  Object s.a will be represented with: <s>, 0
+//  Object s.b will be represented with: <s>, 1
+//  Object s will be represented with: <s>
 // For members of vector, matrix and arrays, they will be represented with the
 // same symbol ID of their container symbol objects. This is because their
 // preciseness is always the same as their container symbol objects.
-typedef std::string ObjectAccessChain;
+//
+// Access chains are interned in an ObjectAccessChainTrie, which numbers each
+// distinct chain, so an ObjectAccessChain is just that number, and comparing,
+// hashing and extending chains is integer work.
+typedef unsigned ObjectAccessChain;
 
-// The delimiter used in the ObjectAccessChain string to separate symbol ID and
-// different level of struct indices.
-const char ObjectAccesschainDelimiter = '/';
+// The access chain with no elements.
+const ObjectAccessChain EmptyAccessChain = 0;
 
 // Mapping from Symbol IDs of symbol nodes, to their defining operation
 // nodes.
 typedef std::unordered_multimap<ObjectAccessChain, glslang::TIntermOperator*> NodeMapping;
-// Mapping from object nodes to their access chain info string.
+// Mapping from object nodes to their access chain info.
 typedef std::unordered_map<glslang::TIntermTyped*, ObjectAccessChain> AccessChainMapping;
 
 // Set of object IDs.
@@ -75,6 +78,127 @@ typedef std::unordered_set<ObjectAccessChain> ObjectAccesschainSet;
 // Set of return branch nodes.
 typedef std::unordered_set<glslang::TIntermBranch*> ReturnBranchNodeSet;
 
+//
+// The trie of all the access chains used while propagating 'precise'. Each
+// node of the trie is an access chain, whose parent is the chain without its
+// last element.
+//
+// Symbols are numbered as they are first seen, and that number is the first
+// element of their access chains. Symbol numbers count down from the largest
+// unsigned value, so they are never mistaken for struct member indices, which
+// is all that is left of an access chain after removing its symbol, or that
+// is built for a member of an object which is not a symbol.
+//
+class ObjectAccessChainTrie {
+public:
+    ObjectAccessChainTrie() : nodes_(1, TrieNode{ EmptyAccessChain, 0, 0 }), symbol_count_(0) {}
+
+    // Returns the access chain of a symbol node, which holds only its symbol.
+    // Symbol IDs are not unique across compilation units, so the name tells
+    // apart the symbols sharing an ID.
+    ObjectAccessChain getSymbolAccessChain(glslang::TIntermSymbol* node)
+    {
+        std::vector<std::pair<const glslang::TString*, ObjectAccessChain>>& symbols = symbols_[node->getId()];
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            if (*symbols[i].first == node->getName())
+                return symbols[i].second;
+        }
+        const unsigned symbol = std::numeric_limits<unsigned>::max() - symbol_count_++;
+        ObjectAccessChain chain = append(EmptyAccessChain, symbol);
+        symbols.push_back(std::make_pair(&node->getName(), chain));
+        return chain;
+    }
+
+    // Returns the access chain extended by one more element.
+    ObjectAccessChain append(ObjectAccessChain chain, unsigned element)
+    {
+        const unsigned long long key = (unsigned long long)chain << 32 | element;
+        auto child = children_.find(key);
+        if (child != children_.end())
+            return child->second;
+
+        ObjectAccessChain extended = (ObjectAccessChain)nodes_.size();
+        nodes_.push_back(TrieNode{ chain, element, nodes_[chain].length + 1 });
+        children_[key] = extended;
+        return extended;
+    }
+
+    // Returns the access chain extended by all the elements of 'suffix'.
+    ObjectAccessChain concatenate(ObjectAccessChain chain, ObjectAccessChain suffix)
+    {
+        std::vector<unsigned> elements;
+        for (; suffix != EmptyAccessChain; suffix = nodes_[suffix].parent)
+            elements.push_back(nodes_[suffix].element);
+        for (auto element = elements.rbegin(); element != elements.rend(); ++element)
+            chain = append(chain, *element);
+        return chain;
+    }
+
+    // Returns the access chain made of the first 'length' elements of 'chain'.
+    ObjectAccessChain getPrefix(ObjectAccessChain chain, unsigned length) const
+    {
+        while (nodes_[chain].length > length)
+            chain = nodes_[chain].parent;
+        return chain;
+    }
+
+    // Returns the access chain holding just the front element of 'chain'.
+    ObjectAccessChain getFrontElement(ObjectAccessChain chain) const { return getPrefix(chain, 1); }
+
+    // Returns the last element of a non-empty access chain.
+    unsigned getBackElement(ObjectAccessChain chain) const { return nodes_[chain].element; }
+
+    // Returns true if 'prefix' is 'chain', or a prefix of it.
+    bool isPrefix(ObjectAccessChain prefix, ObjectAccessChain chain) const
+    {
+        return getPrefix(chain, nodes_[prefix].length) == prefix;
+    }
+
+    // Returns the access chain left after removing a given prefix, or the
+    // whole access chain if it does not start with that prefix.
+    ObjectAccessChain getSubAccessChainAfterPrefix(ObjectAccessChain chain, ObjectAccessChain prefix)
+    {
+        if (!isPrefix(prefix, chain))
+            return chain;
+        std::vector<unsigned> elements;
+        for (; chain != prefix; chain = nodes_[chain].parent)
+            elements.push_back(nodes_[chain].element);
+        ObjectAccessChain sub_chain = EmptyAccessChain;
+        for (auto element = elements.rbegin(); element != elements.rend(); ++element)
+            sub_chain = append(sub_chain, *element);
+        return sub_chain;
+    }
+
+    // Returns the access chain starting from the second element.
+    ObjectAccessChain subAccessChainFromSecondElement(ObjectAccessChain chain)
+    {
+        return getSubAccessChainAfterPrefix(chain, getFrontElement(chain));
+    }
+
+protected:
+    ObjectAccessChainTrie(const ObjectAccessChainTrie&);
+    ObjectAccessChainTrie& operator=(const ObjectAccessChainTrie&);
+
+    struct TrieNode {
+        // The access chain without the last element.
+        ObjectAccessChain parent;
+        // The last element.
+        unsigned element;
+        // The number of elements.
+        unsigned length;
+    };
+
+    // The trie nodes, indexed by the access chains they hold.
+    std::vector<TrieNode> nodes_;
+    // The children of each node, keyed by the parent in the high 32 bits and
+    // the appended element in the low ones.
+    std::unordered_map<unsigned long long, ObjectAccessChain> children_;
+    // The access chains of the symbols seen so far, by symbol ID.
+    std::unordered_map<int, std::vector<std::pair<const glslang::TString*, ObjectAccessChain>>> symbols_;
+    // The number of symbols seen so far.
+    unsigned symbol_count_;
+};
+
 // A helper function to tell whether a node is 'noContraction'. Returns true if
 // the node has 'noContraction' qualifier, otherwise false.
 bool isPreciseObjectNode(glslang::TIntermTyped* node)
@@ -135,14 +259,6 @@ unsigned getStructIndexFromConstantUnion(glslang::TIntermTyped* node)
     return struct_dereference_index;
 }
 
-// A helper function to generate symbol_label.
-ObjectAccessChain generateSymbolLabel(glslang::TIntermSymbol* node)
-{
-    ObjectAccessChain symbol_id =
-        std::to_string(node->getId()) + "(" + node->getName().c_str() + ")";
-    return symbol_id;
-}
-
 // Returns true if the operation is an arithmetic operation and valid for
 // the 'NoContraction' decoration.
 bool isArithmeticOperation(glslang::TOperator op)
@@ -201,30 +317,6 @@ private:
     T previous_state_;
 };
 
-// A helper function to get the front element from a given ObjectAccessChain
-ObjectAccessChain getFrontElement(const ObjectAccessChain& chain)
-{
-    size_t pos_delimiter = chain.find(ObjectAccesschainDelimiter);
-    return pos_delimiter == std::string::npos ? chain : chain.substr(0, pos_delimiter);
-}
-
-// A helper function to get the access chain starting from the second element.
-ObjectAccessChain subAccessChainFromSecondElement(const ObjectAccessChain& chain)
-{
-    size_t pos_delimiter = chain.find(ObjectAccesschainDelimiter);
-    return pos_delimiter == std::string::npos ? "" : chain.substr(pos_delimiter + 1);
-}
-
-// A helper function to get the access chain after removing a given prefix.
-ObjectAccessChain getSubAccessChainAfterPrefix(const ObjectAccessChain& chain,
-                                               const ObjectAccessChain& prefix)
-{
-    size_t pos = chain.find(prefix);
-    if (pos != 0)
-        return chain;
-    return chain.substr(prefix.length() + sizeof(ObjectAccesschainDelimiter));
-}
-
 //
 // A traverser which traverses the whole AST and populates:
 //  1) A mapping from symbol nodes' IDs to their defining operation nodes.
@@ -235,7 +327,8 @@ public:
     TSymbolDefinitionCollectingTraverser(NodeMapping* symbol_definition_mapping,
                                          AccessChainMapping* accesschain_mapping,
                                          ObjectAccesschainSet* precise_objects,
-                                         ReturnBranchNodeSet* precise_return_nodes);
+                                         ReturnBranchNodeSet* precise_return_nodes,
+                                         ObjectAccessChainTrie* accesschain_trie);
 
     bool visitUnary(glslang::TVisit, glslang::TIntermUnary*) override;
     bool visitBinary(glslang::TVisit, glslang::TIntermBinary*) override;
@@ -265,16 +358,19 @@ protected:
     // preciseness of the return expression from it when we traverse the
     // return branch node.
     glslang::TIntermAggregate* current_function_definition_node_;
+    // The trie holding the access chains built.
+    ObjectAccessChainTrie& accesschain_trie_;
 };
 
 TSymbolDefinitionCollectingTraverser::TSymbolDefinitionCollectingTraverser(
     NodeMapping* symbol_definition_mapping, AccessChainMapping* accesschain_mapping,
     ObjectAccesschainSet* precise_objects,
-    std::unordered_set<glslang::TIntermBranch*>* precise_return_nodes)
-    : TIntermTraverser(true, false, false), symbol_definition_mapping_(*symbol_definition_mapping),
-      precise_objects_(*precise_objects), current_object_(),
+    std::unordered_set<glslang::TIntermBranch*>* precise_return_nodes,
+    ObjectAccessChainTrie* accesschain_trie)
+    : TIntermTraverser(true, true, true), symbol_definition_mapping_(*symbol_definition_mapping),
+      precise_objects_(*precise_objects), current_object_(EmptyAccessChain),
       accesschain_mapping_(*accesschain_mapping), current_function_definition_node_(nullptr),
-      precise_return_nodes_(*precise_return_nodes) {}
+      precise_return_nodes_(*precise_return_nodes), accesschain_trie_(*accesschain_trie) {}
 
 // Visits a symbol node, set the current_object_ to the
 // current node symbol ID, and record a mapping from this node to the current
@@ -282,57 +378,58 @@ TSymbolDefinitionCollectingTraverser::TSymbolDefinitionCollectingTraverser(
 // ID.
 void TSymbolDefinitionCollectingTraverser::visitSymbol(glslang::TIntermSymbol* node)
 {
-    current_object_ = generateSymbolLabel(node);
+    current_object_ = accesschain_trie_.getSymbolAccessChain(node);
     accesschain_mapping_[node] = current_object_;
 }
 
-// Visits an aggregate node, traverses all of its children.
-bool TSymbolDefinitionCollectingTraverser::visitAggregate(glslang::TVisit,
+// Visits an aggregate node. Its children are traversed one at a time, each
+// starting with an empty access chain.
+bool TSymbolDefinitionCollectingTraverser::visitAggregate(glslang::TVisit visit,
                                                           glslang::TIntermAggregate* node)
 {
     // This aggregate node might be a function definition node, in which case we need to
     // cache this node, so we can get the preciseness information of the return value
-    // of this function later.
-    StateSettingGuard<glslang::TIntermAggregate*> current_function_definition_node_setting_guard(
-        &current_function_definition_node_);
+    // of this function later. Function definitions do not nest, so there is no
+    // enclosing one to restore once it is left.
     if (node->getOp() == glslang::EOpFunction) {
-        // This is function definition node, we need to cache this node so that we can
-        // get the preciseness of the return value later.
-        current_function_definition_node_setting_guard.setState(node);
-    }
-    // Traverse the items in the sequence.
-    glslang::TIntermSequence& seq = node->getSequence();
-    for (int i = 0; i < (int)seq.size(); ++i) {
-        current_object_.clear();
-        seq[i]->traverse(this);
+        if (visit == glslang::EvPreVisit)
+            current_function_definition_node_ = node;
+        else if (visit == glslang::EvPostVisit)
+            current_function_definition_node_ = nullptr;
     }
-    return false;
+    if (visit != glslang::EvPostVisit)
+        current_object_ = EmptyAccessChain;
+    return true;
 }
 
-bool TSymbolDefinitionCollectingTraverser::visitBranch(glslang::TVisit,
+bool TSymbolDefinitionCollectingTraverser::visitBranch(glslang::TVisit visit,
                                                        glslang::TIntermBranch* node)
 {
-    if (node->getFlowOp() == glslang::EOpReturn && node->getExpression() &&
-        current_function_definition_node_ &&
+    if (visit == glslang::EvPreVisit && node->getFlowOp() == glslang::EOpReturn &&
+        node->getExpression() && current_function_definition_node_ &&
         current_function_definition_node_->getType().getQualifier().noContraction) {
         // This node is a return node with an expression, and its function has a
         // precise return value. We need to find the involved objects in its
         // expression and add them to the set of initial precise objects.
         precise_return_nodes_.insert(node);
-        node->getExpression()->traverse(this);
+        return true;
     }
     return false;
 }
 
 // Visits a unary node. This might be an implicit assignment like i++, i--. etc.
-bool TSymbolDefinitionCollectingTraverser::visitUnary(glslang::TVisit /* visit */,
+bool TSymbolDefinitionCollectingTraverser::visitUnary(glslang::TVisit visit,
                                                       glslang::TIntermUnary* node)
 {
-    current_object_.clear();
-    node->getOperand()->traverse(this);
+    if (visit == glslang::EvPreVisit) {
+        // Traverses the operand node to build its access chain.
+        current_object_ = EmptyAccessChain;
+        return true;
+    }
+
     if (isAssignOperation(node->getOp())) {
         // We should always be able to get an access chain of the operand node.
-        assert(!current_object_.empty());
+        assert(current_object_ != EmptyAccessChain);
 
         // If the operand node object is 'precise', we collect its access chain
         // for the initial set of 'precise' objects.
@@ -343,28 +440,34 @@ bool TSymbolDefinitionCollectingTraverser::visitUnary(glslang::TVisit /* visit *
             precise_objects_.insert(current_object_);
         }
         // Gets the symbol ID from the object's access chain.
-        ObjectAccessChain id_symbol = getFrontElement(current_object_);
+        ObjectAccessChain id_symbol = accesschain_trie_.getFrontElement(current_object_);
         // Add a mapping from the symbol ID to this assignment operation node.
         symbol_definition_mapping_.insert(std::make_pair(id_symbol, node));
     }
     // A unary node is not a dereference node, so we clear the access chain which
     // is under construction.
-    current_object_.clear();
-    return false;
+    current_object_ = EmptyAccessChain;
+    return true;
 }
 
 // Visits a binary node and updates the mapping from symbol IDs to the definition
 // nodes. Also collects the access chains for the initial precise objects.
-bool TSymbolDefinitionCollectingTraverser::visitBinary(glslang::TVisit /* visit */,
+//
+// The work is done in the in-visit, once the left node has been traversed to
+// build the access chain info for the object.
+bool TSymbolDefinitionCollectingTraverser::visitBinary(glslang::TVisit visit,
                                                        glslang::TIntermBinary* node)
 {
-    // Traverses the left node to build the access chain info for the object.
-    current_object_.clear();
-    node->getLeft()->traverse(this);
+    if (visit == glslang::EvPreVisit) {
+        current_object_ = EmptyAccessChain;
+        return true;
+    }
+    if (visit == glslang::EvPostVisit)
+        return true;
 
     if (isAssignOperation(node->getOp())) {
         // We should always be able to get an access chain for the left node.
-        assert(!current_object_.empty());
+        assert(current_object_ != EmptyAccessChain);
 
         // If the left node object is 'precise', it is an initial precise object
         // specified in the shader source. Adds it to the initial work list to
@@ -377,14 +480,14 @@ bool TSymbolDefinitionCollectingTraverser::visitBinary(glslang::TVisit /* visit
         }
         // Gets the symbol ID from the object access chain, which should be the
         // first element recorded in the access chain.
-        ObjectAccessChain id_symbol = getFrontElement(current_object_);
+        ObjectAccessChain id_symbol = accesschain_trie_.getFrontElement(current_object_);
         // Adds a mapping from the symbol ID to this assignment operation node.
         symbol_definition_mapping_.insert(std::make_pair(id_symbol, node));
 
         // Traverses the right node, there may be other 'assignment'
         // operations in the right.
-        current_object_.clear();
-        node->getRight()->traverse(this);
+        current_object_ = EmptyAccessChain;
+        return true;
 
     } else if (isDereferenceOperation(node->getOp())) {
         // The left node (parent node) is a struct type object. We need to
@@ -392,20 +495,19 @@ bool TSymbolDefinitionCollectingTraverser::visitBinary(glslang::TVisit /* visit
         // object id.
         if (node->getOp() == glslang::EOpIndexDirectStruct) {
             unsigned struct_dereference_index = getStructIndexFromConstantUnion(node->getRight());
-            current_object_.push_back(ObjectAccesschainDelimiter);
-            current_object_.append(std::to_string(struct_dereference_index));
+            current_object_ = accesschain_trie_.append(current_object_, struct_dereference_index);
         }
         accesschain_mapping_[node] = current_object_;
 
         // For a dereference node, there is no need to traverse the right child
         // node as the right node should always be an integer type object.
+        return false;
 
     } else {
         // For other binary nodes, still traverse the right node.
-        current_object_.clear();
-        node->getRight()->traverse(this);
+        current_object_ = EmptyAccessChain;
+        return true;
     }
-    return false;
 }
 
 // Traverses the AST and returns a tuple of four members:
@@ -414,7 +516,8 @@ bool TSymbolDefinitionCollectingTraverser::visitBinary(glslang::TVisit /* visit
 // 3) a set of access chains of precise objects.
 // 4) a set of return nodes with precise expressions.
 std::tuple<NodeMapping, AccessChainMapping, ObjectAccesschainSet, ReturnBranchNodeSet>
-getSymbolToDefinitionMappingAndPreciseSymbolIDs(const glslang::TIntermediate& intermediate)
+getSymbolToDefinitionMappingAndPreciseSymbolIDs(const glslang::TIntermediate& intermediate,
+                                                ObjectAccessChainTrie* accesschain_trie)
 {
     auto result_tuple = std::make_tuple(NodeMapping(), AccessChainMapping(), ObjectAccesschainSet(),
                                         ReturnBranchNodeSet());
@@ -430,7 +533,8 @@ getSymbolToDefinitionMappingAndPreciseSymbolIDs(const glslang::TIntermediate& in
 
     // Traverses the AST and populate the results.
     TSymbolDefinitionCollectingTraverser collector(&symbol_definition_mapping, &accesschain_mapping,
-                                                   &precise_objects, &precise_return_nodes);
+                                                   &precise_objects, &precise_return_nodes,
+                                                   accesschain_trie);
     root->traverse(&collector);
 
     return result_tuple;
@@ -462,9 +566,10 @@ class TNoContractionAssigneeCheckingTraverser : public glslang::TIntermTraverser
     };
 
 public:
-    TNoContractionAssigneeCheckingTraverser(const AccessChainMapping& accesschain_mapping)
-        : TIntermTraverser(true, false, false), accesschain_mapping_(accesschain_mapping),
-          precise_object_(nullptr) {}
+    TNoContractionAssigneeCheckingTraverser(const AccessChainMapping& accesschain_mapping,
+                                            ObjectAccessChainTrie* accesschain_trie)
+        : TIntermTraverser(true, true, false), accesschain_mapping_(accesschain_mapping),
+          precise_object_(EmptyAccessChain), accesschain_trie_(*accesschain_trie) {}
 
     // Checks the preciseness of a given assignment node with a precise object
     // represented as access chain. The precise object shares the same symbol
@@ -482,11 +587,11 @@ public:
     //  precise object.
     std::tuple<bool, ObjectAccessChain>
     getPrecisenessAndRemainedAccessChain(glslang::TIntermOperator* node,
-                                         const ObjectAccessChain& precise_object)
+                                         ObjectAccessChain precise_object)
     {
         assert(isAssignOperation(node->getOp()));
-        precise_object_ = &precise_object;
-        ObjectAccessChain assignee_object;
+        precise_object_ = precise_object;
+        ObjectAccessChain assignee_object = EmptyAccessChain;
         if (glslang::TIntermBinary* BN = node->getAsBinaryNode()) {
             // This is a binary assignment node, we need to check the
             // preciseness of the left node.
@@ -498,10 +603,10 @@ public:
             // After traversing the left node, if the left node is 'precise',
             // we can conclude this assignment should propagate 'precise'.
             if (isPreciseObjectNode(BN->getLeft())) {
-                return make_tuple(true, ObjectAccessChain());
+                return std::make_tuple(true, EmptyAccessChain);
             }
             // If the preciseness of the left node (assignee node) can not
-            // be determined by now, we need to compare the access chain string
+            // be determined by now, we need to compare the access chain
             // of the assignee object with the given precise object.
             assignee_object = accesschain_mapping_.at(BN->getLeft());
 
@@ -516,10 +621,10 @@ public:
             // After traversing the operand node, if the operand node is
             // 'precise', this assignment should propagate 'precise'.
             if (isPreciseObjectNode(UN->getOperand())) {
-                return make_tuple(true, ObjectAccessChain());
+                return std::make_tuple(true, EmptyAccessChain);
             }
             // If the preciseness of the operand node (assignee node) can not
-            // be determined by now, we need to compare the access chain string
+            // be determined by now, we need to compare the access chain
             // of the assignee object with the given precise object.
             assignee_object = accesschain_mapping_.at(UN->getOperand());
         } else {
@@ -527,25 +632,26 @@ public:
             assert(false);
         }
 
-        // Compare the access chain string of the assignee node with the given
+        // Compare the access chain of the assignee node with the given
         // precise object to determine if this assignment should propagate
         // 'precise'.
-        if (assignee_object.find(precise_object) == 0) {
-            // The access chain string of the given precise object is a prefix
-            // of assignee's access chain string. The assignee should be
+        if (accesschain_trie_.isPrefix(precise_object, assignee_object)) {
+            // The access chain of the given precise object is a prefix
+            // of assignee's access chain. The assignee should be
             // 'precise'.
-            return make_tuple(true, ObjectAccessChain());
-        } else if (precise_object.find(assignee_object) == 0) {
-            // The assignee's access chain string is a prefix of the given
+            return std::make_tuple(true, EmptyAccessChain);
+        } else if (accesschain_trie_.isPrefix(assignee_object, precise_object)) {
+            // The assignee's access chain is a prefix of the given
             // precise object, the assignee object contains 'precise' object,
             // and we need to pass the remained access chain to the object nodes
             // in the right.
-            return make_tuple(true, getSubAccessChainAfterPrefix(precise_object, assignee_object));
+            return std::make_tuple(true, accesschain_trie_.getSubAccessChainAfterPrefix(
+                                             precise_object, assignee_object));
         } else {
-            // The access chain strings do not match, the assignee object can
+            // The access chains do not match, the assignee object can
             // not be labeled as 'precise' according to the given precise
             // object.
-            return make_tuple(false, ObjectAccessChain());
+            return std::make_tuple(false, EmptyAccessChain);
         }
     }
 
@@ -555,24 +661,27 @@ protected:
     bool visitBinary(glslang::TVisit, glslang::TIntermBinary* node) override;
     void visitSymbol(glslang::TIntermSymbol* node) override;
 
-    // A map from object nodes to their access chain string (used as object ID).
+    // A map from object nodes to their access chain (used as object ID).
     const AccessChainMapping& accesschain_mapping_;
-    // A given precise object, represented in it access chain string. This
+    // A given precise object, represented in it access chain. This
     // precise object is used to be compared with the assignee node to tell if
     // the assignee node is 'precise', contains 'precise' object or not
     // 'precise'.
-    const ObjectAccessChain* precise_object_;
+    ObjectAccessChain precise_object_;
+    // The trie holding the access chains compared.
+    ObjectAccessChainTrie& accesschain_trie_;
 };
 
 // Visits a binary node. If the node is an object node, it must be a dereference
 // node. In such cases, if the left node is 'precise', this node should also be
 // 'precise'.
-bool TNoContractionAssigneeCheckingTraverser::visitBinary(glslang::TVisit,
+bool TNoContractionAssigneeCheckingTraverser::visitBinary(glslang::TVisit visit,
                                                           glslang::TIntermBinary* node)
 {
-    // Traverses the left so that we transfer the 'precise' from nesting object
-    // to its nested object.
-    node->getLeft()->traverse(this);
+    // Traverses the left first, so that we transfer the 'precise' from nesting
+    // object to its nested object in the in-visit.
+    if (visit == glslang::EvPreVisit)
+        return true;
     // If this binary node is an object node, we should have it in the
     // accesschain_mapping_.
     if (accesschain_mapping_.count(node)) {
@@ -584,21 +693,21 @@ bool TNoContractionAssigneeCheckingTraverser::visitBinary(glslang::TVisit,
         // this node should be marked as 'precise'.
         if (isPreciseObjectNode(node->getLeft())) {
             node->getWritableType().getQualifier().noContraction = true;
-        } else if (accesschain_mapping_.at(node) == *precise_object_) {
+        } else if (accesschain_mapping_.at(node) == precise_object_) {
             node->getWritableType().getQualifier().noContraction = true;
         }
     }
     return false;
 }
 
-// Visits a symbol node, if the symbol node ID (its access chain string) matches
+// Visits a symbol node, if the symbol node ID (its access chain) matches
 // with the given precise object, this node should be 'precise'.
 void TNoContractionAssigneeCheckingTraverser::visitSymbol(glslang::TIntermSymbol* node)
 {
     // A symbol node should always be an object node, and should have been added
-    // to the map from object nodes to their access chain strings.
+    // to the map from object nodes to their access chains.
     assert(accesschain_mapping_.count(node));
-    if (accesschain_mapping_.at(node) == *precise_object_) {
+    if (accesschain_mapping_.at(node) == precise_object_) {
         node->getWritableType().getQualifier().noContraction = true;
     }
 }
@@ -615,17 +724,18 @@ void TNoContractionAssigneeCheckingTraverser::visitSymbol(glslang::TIntermSymbol
 class TNoContractionPropagator : public glslang::TIntermTraverser {
 public:
     TNoContractionPropagator(ObjectAccesschainSet* precise_objects,
-                             const AccessChainMapping& accesschain_mapping)
-        : TIntermTraverser(true, false, false), remained_accesschain_(),
+                             const AccessChainMapping& accesschain_mapping,
+                             ObjectAccessChainTrie* accesschain_trie)
+        : TIntermTraverser(true, false, false), remained_accesschain_(EmptyAccessChain),
           precise_objects_(*precise_objects), accesschain_mapping_(accesschain_mapping),
-          added_precise_object_ids_() {}
+          added_precise_object_ids_(), accesschain_trie_(*accesschain_trie) {}
 
     // Propagates 'precise' in the right nodes of a given assignment node with
     // access chain record from the assignee node to a 'precise' object it
     // contains.
     void
     propagateNoContractionInOneExpression(glslang::TIntermTyped* defining_node,
-                                          const ObjectAccessChain& assignee_remained_accesschain)
+                                          ObjectAccessChain assignee_remained_accesschain)
     {
         remained_accesschain_ = assignee_remained_accesschain;
         if (glslang::TIntermBinary* BN = defining_node->getAsBinaryNode()) {
@@ -646,7 +756,7 @@ public:
     // Propagates 'precise' in a given precise return node.
     void propagateNoContractionInReturnNode(glslang::TIntermBranch* return_node)
     {
-        remained_accesschain_ = "";
+        remained_accesschain_ = EmptyAccessChain;
         assert(return_node->getFlowOp() == glslang::EOpReturn && return_node->getExpression());
         return_node->getExpression()->traverse(this);
     }
@@ -660,7 +770,7 @@ protected:
     // the children nodes.
     bool visitAggregate(glslang::TVisit, glslang::TIntermAggregate* node) override
     {
-        if (!remained_accesschain_.empty() && node->getOp() == glslang::EOpConstructStruct) {
+        if (remained_accesschain_ != EmptyAccessChain && node->getOp() == glslang::EOpConstructStruct) {
             // This is a struct initializer node, and the remained
             // access chain is not empty, we need to refer to the
             // assignee_remained_access_chain_ to find the nested
@@ -668,9 +778,8 @@ protected:
             // aggregate node.
 
             // Gets the struct dereference index that leads to 'precise' object.
-            ObjectAccessChain precise_accesschain_index_str =
-                getFrontElement(remained_accesschain_);
-            unsigned precise_accesschain_index = strtoul(precise_accesschain_index_str.c_str(), nullptr, 10);
+            unsigned precise_accesschain_index = accesschain_trie_.getBackElement(
+                accesschain_trie_.getFrontElement(remained_accesschain_));
             // Gets the node pointed by the access chain index extracted before.
             glslang::TIntermTyped* potential_precise_node =
                 node->getSequence()[precise_accesschain_index]->getAsTyped();
@@ -678,7 +787,7 @@ protected:
             // Pop the front access chain index from the path, and visit the nested node.
             {
                 ObjectAccessChain next_level_accesschain =
-                    subAccessChainFromSecondElement(remained_accesschain_);
+                    accesschain_trie_.subAccessChainFromSecondElement(remained_accesschain_);
                 StateSettingGuard<ObjectAccessChain> setup_remained_accesschain_for_next_level(
                     &remained_accesschain_, next_level_accesschain);
                 potential_precise_node->traverse(this);
@@ -701,10 +810,11 @@ protected:
             // object set with the access chain of this node + remained
             // access chain .
             ObjectAccessChain new_precise_accesschain = accesschain_mapping_.at(node);
-            if (remained_accesschain_.empty()) {
+            if (remained_accesschain_ == EmptyAccessChain) {
                 node->getWritableType().getQualifier().noContraction = true;
             } else {
-                new_precise_accesschain += ObjectAccesschainDelimiter + remained_accesschain_;
+                new_precise_accesschain =
+                    accesschain_trie_.concatenate(new_precise_accesschain, remained_accesschain_);
             }
             // Cache the access chain as added precise object, so we won't add the
             // same object to the work list again.
@@ -750,10 +860,11 @@ protected:
         // marked as 'precise'.  Otherwise, the unused access chain should be
         // appended to the symbol ID to build a new access chain which points to
         // the nested 'precise' object in this symbol object.
-        if (remained_accesschain_.empty()) {
+        if (remained_accesschain_ == EmptyAccessChain) {
             node->getWritableType().getQualifier().noContraction = true;
         } else {
-            new_precise_accesschain += ObjectAccesschainDelimiter + remained_accesschain_;
+            new_precise_accesschain =
+                accesschain_trie_.concatenate(new_precise_accesschain, remained_accesschain_);
         }
         // Add the new 'precise' access chain to the work list and make sure we
         // don't visit it again.
@@ -775,6 +886,8 @@ protected:
     ObjectAccessChain remained_accesschain_;
     // A map from node pointers to their access chains.
     const AccessChainMapping& accesschain_mapping_;
+    // The trie holding the access chains built.
+    ObjectAccessChainTrie& accesschain_trie_;
 };
 }
 
@@ -785,8 +898,9 @@ void PropagateNoContraction(const glslang::TIntermediate& intermediate)
     // First, traverses the AST, records symbols with their defining operations
     // and collects the initial set of precise symbols (symbol nodes that marked
     // as 'noContraction') and precise return nodes.
+    ObjectAccessChainTrie accesschain_trie;
     auto mappings_and_precise_objects =
-        getSymbolToDefinitionMappingAndPreciseSymbolIDs(intermediate);
+        getSymbolToDefinitionMappingAndPreciseSymbolIDs(intermediate, &accesschain_trie);
 
     // The mapping of symbol node IDs to their defining nodes. This enables us
     // to get the defining node directly from a given symbol ID without
@@ -813,8 +927,9 @@ void PropagateNoContraction(const glslang::TIntermediate& intermediate)
     //  expression to mark arithmetic operations as 'noContration' and update
     //  'precise' access chain work list with new found object nodes.
     // Repeat above steps until the work list is empty.
-    TNoContractionAssigneeCheckingTraverser checker(accesschain_mapping);
-    TNoContractionPropagator propagator(&precise_object_accesschains, accesschain_mapping);
+    TNoContractionAssigneeCheckingTraverser checker(accesschain_mapping, &accesschain_trie);
+    TNoContractionPropagator propagator(&precise_object_accesschains, accesschain_mapping,
+                                        &accesschain_trie);
 
     // We have two initial precise work lists to handle:
     //  1) precise return nodes
@@ -832,7 +947,7 @@ void PropagateNoContraction(const glslang::TIntermediate& intermediate)
         // Get the access chain of a precise object from the work list.
         ObjectAccessChain precise_object_accesschain = *precise_object_accesschains.begin();
         // Get the symbol id from the access chain.
-        ObjectAccessChain symbol_id = getFrontElement(precise_object_accesschain);
+        ObjectAccessChain symbol_id = accesschain_trie.getFrontElement(precise_object_accesschain);
         // Get all the defining nodes of that symbol ID.
         std::pair<NodeMapping::iterator, NodeMapping::iterator> range =
             symbol_definition_mapping.equal_range(symbol_id);
@@ -348,7 +348,7 @@ public:
     {
         int blockIndex;
         TReflection::TNameToIndex::const_iterator it = reflection.nameToIndex.find(name);
-        if (reflection.nameToIndex.find(name) == reflection.nameToIndex.end()) {
+        if (it == reflection.nameToIndex.end()) {
             blockIndex = (int)reflection.indexToUniformBlock.size();
             reflection.nameToIndex[name] = blockIndex;
             reflection.indexToUniformBlock.push_back(TObjectReflection(name, -1, -1, size, -1));
@@ -43,6 +43,8 @@
 #include <assert.h>
 #include <errno.h>
 #include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
 
 namespace glslang {
 
@@ -165,10 +167,72 @@ bool OS_FreeTLSIndex(OS_TLSIndex nIndex)
 		return false;
 }
 
+// A recursive mutex, like the Windows one, since a thread holding the lock may take it again
+static pthread_mutex_t GlobalLock;
+
+static void CreateGlobalLock()
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&GlobalLock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+
+void InitGlobalLock()
+{
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, CreateGlobalLock);
+}
+
+// Also initializes the lock, for users (e.g., worklists) that may get it before ShInitialize()
+void GetGlobalLock()
+{
+    InitGlobalLock();
+    pthread_mutex_lock(&GlobalLock);
+}
+
+void ReleaseGlobalLock()
+{
+    pthread_mutex_unlock(&GlobalLock);
+}
+
+struct TStackRun {
+    TStackEntrypoint entry;
+    void* data;
+};
+
+static void* EnterStackRun(void* run)
+{
+    static_cast<TStackRun*>(run)->entry(static_cast<TStackRun*>(run)->data);
+    return 0;
+}
+
+bool OS_RunWithStack(TStackEntrypoint entry, void* data, size_t stackSize)
+{
+    // Some systems want a whole number of pages
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    stackSize = (stackSize + pageSize - 1) / pageSize * pageSize;
+    if (stackSize < (size_t)PTHREAD_STACK_MIN)
+        stackSize = PTHREAD_STACK_MIN;
+
+    pthread_attr_t attributes;
+    if (pthread_attr_init(&attributes) != 0)
+        return false;
+
+    TStackRun run = { entry, data };
+    pthread_t thread;
+    bool started = pthread_attr_setstacksize(&attributes, stackSize) == 0 &&
+                   pthread_create(&thread, &attributes, EnterStackRun, &run) == 0;
+    pthread_attr_destroy(&attributes);
+
+    if (started)
+        pthread_join(thread, 0);
+
+    return started;
+}
+
 // TODO: non-windows: if we need these on linux, flesh them out
-void InitGlobalLock() { }
-void GetGlobalLock() { }
-void ReleaseGlobalLock() { }
 
 void* OS_CreateThread(TThreadEntrypoint /*entry*/)
 {
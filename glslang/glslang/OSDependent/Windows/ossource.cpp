@@ -42,6 +42,7 @@
 #include <psapi.h>
 #include <cstdio>
 #include <cstdint>
+#include <climits>
 
 //
 // This file contains the Window-OS-specific functions
@@ -142,6 +143,34 @@ void OS_WaitForAllThreads(void* threads, int numThreads)
     WaitForMultipleObjects(numThreads, (HANDLE*)threads, true, INFINITE);
 }
 
+struct TStackRun {
+    TStackEntrypoint entry;
+    void* data;
+};
+
+unsigned int __stdcall EnterStackRun(void* run)
+{
+    static_cast<TStackRun*>(run)->entry(static_cast<TStackRun*>(run)->data);
+    return 0;
+}
+
+bool OS_RunWithStack(TStackEntrypoint entry, void* data, size_t stackSize)
+{
+    if (stackSize > UINT_MAX)
+        return false;
+
+    // Reserve the stack, rather than commit it, so pages are only used as it grows
+    TStackRun run = { entry, data };
+    HANDLE thread = (HANDLE)_beginthreadex(0, (unsigned int)stackSize, EnterStackRun, &run, STACK_SIZE_PARAM_IS_A_RESERVATION, 0);
+    if (thread == 0)
+        return false;
+
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+
+    return true;
+}
+
 void OS_Sleep(int milliseconds)
 {
     Sleep(milliseconds);
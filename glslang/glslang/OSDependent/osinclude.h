@@ -35,6 +35,8 @@
 #ifndef __OSINCLUDE_H
 #define __OSINCLUDE_H
 
+#include <cstddef>
+
 namespace glslang {
 
 //
@@ -56,6 +58,11 @@ typedef unsigned int (*TThreadEntrypoint)(void*);
 void* OS_CreateThread(TThreadEntrypoint);
 void OS_WaitForAllThreads(void* threads, int numThreads);
 
+// Run entry(data) on a new thread with a stack of at least stackSize bytes, and wait for it to
+// finish.  Returns false, without running entry, if the thread couldn't be created.
+typedef void (*TStackEntrypoint)(void*);
+bool OS_RunWithStack(TStackEntrypoint entry, void* data, size_t stackSize);
+
 void OS_CleanupThreadData(void);
 void OS_Sleep(int milliseconds);
 
@@ -259,6 +259,7 @@ SH_IMPORT_EXPORT int ShGetUniformLocation(const ShHandle uniformMap, const char*
 #include <list>
 #include <string>
 #include <utility>
+#include <vector>
 
 class TCompiler;
 class TInfoSink;
@@ -272,6 +273,7 @@ int GetKhronosToolId();
 class TIntermediate;
 class TProgram;
 class TPoolAllocator;
+struct TDiagnostic;
 
 // Call this exactly once per process before using anything else
 bool InitializeProcess();
@@ -301,6 +303,25 @@ public:
     void setPreamble(const char* s) { preamble = s; }
     void setEntryPoint(const char* entryPoint);
 
+    // The #version directive a shader's strings open with: version is 0 if there is none,
+    // profile is the one written (ENoProfile if the directive doesn't name one), and notFirst
+    // is whether comments or white space come before it (as ES 300 and up forbid).
+    struct VersionHint {
+        int version;
+        EProfile profile;
+        bool notFirst;
+    };
+
+    // Trust that the strings open with the given #version directive, rather than sniffing it out of
+    // them ahead of the real preprocessing pass.  The hint is not checked against the strings, so only
+    // give one that describes them (e.g., one getVersionHint() returned for the same strings).
+    void setVersionHint(const VersionHint& hint) { versionHint = hint; hasVersionHint = true; }
+
+    // After parse() or preprocess(), the #version directive the strings opened with, suitable for a
+    // later setVersionHint().  Returns false if there is no such hint, because other tokens came
+    // before the #version directive, or nothing has been parsed yet.
+    bool getVersionHint(VersionHint& hint) const;
+
     // Interface to #include handlers.
     //
     // To support #include, a client of Glslang does the following:
@@ -403,6 +424,12 @@ public:
     const char* getInfoLog();
     const char* getInfoDebugLog();
 
+    // The parse diagnostics, in structured form (see Include/InfoSink.h).
+    // They are also rendered into the info log when it is asked for, which
+    // caches the text in the shader, so getInfoLog() must not be called on
+    // the same shader from more than one thread at a time.
+    const std::vector<TDiagnostic>& getDiagnostics() const;
+
     EShLanguage getStage() const { return stage; }
 
 protected:
@@ -425,6 +452,10 @@ protected:
     const char* const* stringNames;
     const char* preamble;
     int numStrings;
+    VersionHint versionHint;
+    bool hasVersionHint;
+    // the directive found ahead of parsing; the profile is EBadProfile if it can't be used as a hint
+    VersionHint sniffedVersion;
 
     friend class TProgram;
 
@@ -453,6 +484,11 @@ public:
 
     TIntermediate* getIntermediate(EShLanguage stage) const { return intermediate[stage]; }
 
+    // Check the outputs of a linked stage against the inputs of the next linked stage in the
+    // pipeline, as link() does for its own stages, writing any errors to infoSink.  Neither stage
+    // is changed, so stages linked by different programs can be checked against each other.
+    static bool checkStageInterface(TInfoSink& infoSink, const TIntermediate& producer, const TIntermediate& consumer);
+
     // Reflection Interface
     bool buildReflection();                          // call first, to do liveness analysis, index mapping, etc.; returns false on failure
     int getNumLiveUniformVariables();                // can be used for glGetProgramiv(GL_ACTIVE_UNIFORMS)
@@ -104,6 +104,7 @@ INSTANTIATE_TEST_CASE_P(
         "330comp.frag",
         "constErrors.frag",
         "constFold.frag",
+        "constFoldIntDivMod.frag",
         "errors.frag",
         "forwardRef.frag",
         "uint.frag",
@@ -189,6 +190,7 @@ INSTANTIATE_TEST_CASE_P(
         "negativeArraySize.comp",
         "precise.tesc",
         "precise_struct_block.vert",
+        "precise_struct_member.vert",
         "maxClipDistances.vert",
     })),
     FileNameAsCustomTestSuffix
@@ -0,0 +1,131 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+
+#include "glslang/Include/BaseTypes.h"
+#include "glslang/Include/Common.h"
+#include "glslang/Include/ConstantUnion.h"
+
+#include "TestFixture.h"
+
+namespace glslangtest {
+namespace {
+
+// Builds the arrays of each test in a pool of their own.
+class ConstantUnionTest : public PoolAllocatorTest {
+protected:
+    // An array of the given size whose components are 0, 1, 2, ...
+    static glslang::TConstUnionArray iota(int size)
+    {
+        glslang::TConstUnionArray array(size);
+        for (int i = 0; i < size; ++i)
+            array[i].setIConst(i);
+        return array;
+    }
+};
+
+TEST_F(ConstantUnionTest, ViewSharesComponents)
+{
+    glslang::TConstUnionArray array = iota(16);
+    glslang::TConstUnionArray view(array, 4, 8);
+    glslang::TConstUnionArray inner(view, 2, 3);
+
+    ASSERT_EQ(8, view.size());
+    EXPECT_EQ(&array[4], &view[0]);
+    EXPECT_EQ(11, view[7].getIConst());
+    ASSERT_EQ(3, inner.size());
+    EXPECT_EQ(&array[6], &inner[0]);
+
+    // as with a copy, a write through the view is seen by the array
+    view[0].setIConst(-1);
+    EXPECT_EQ(-1, array[4].getIConst());
+}
+
+TEST_F(ConstantUnionTest, ViewsCompareByComponents)
+{
+    glslang::TConstUnionArray array = iota(8);
+    glslang::TConstUnionArray other = iota(8);
+
+    EXPECT_TRUE(glslang::TConstUnionArray(array, 2, 4) == glslang::TConstUnionArray(other, 2, 4));
+    EXPECT_FALSE(glslang::TConstUnionArray(array, 2, 4) == glslang::TConstUnionArray(array, 3, 4));
+    EXPECT_FALSE(glslang::TConstUnionArray(array, 0, 4) == array);
+    EXPECT_TRUE(glslang::TConstUnionArray() == glslang::TConstUnionArray());
+}
+
+TEST_F(ConstantUnionTest, MakeUniqueDetachesSharedComponents)
+{
+    glslang::TConstUnionArray array = iota(8);
+    glslang::TConstUnionArray copy(array);
+    copy.makeUnique();
+    copy[0].setIConst(-1);
+    EXPECT_EQ(0, array[0].getIConst());
+
+    glslang::TConstUnionArray view(array, 4, 2);
+    view.makeUnique();
+    ASSERT_EQ(2, view.size());
+    EXPECT_NE(&array[4], &view[0]);
+    EXPECT_EQ(5, view[1].getIConst());
+}
+
+TEST_F(ConstantUnionTest, MakeUniqueKeepsUnsharedComponents)
+{
+    glslang::TConstUnionArray array(4);
+    const glslang::TConstUnion* components = &array[0];
+    {
+        glslang::TConstUnionArray copy(array);
+    }
+    array.makeUnique();
+    EXPECT_EQ(components, &array[0]);
+
+    glslang::TConstUnionArray unallocated;
+    unallocated.makeUnique();
+    EXPECT_TRUE(unallocated.empty());
+}
+
+TEST_F(ConstantUnionTest, AccountsSharedBytes)
+{
+    const unsigned long long allocated = glslang::TConstUnionArray::getAllocatedBytes();
+    const unsigned long long shared = glslang::TConstUnionArray::getSharedBytes();
+
+    glslang::TConstUnionArray array(64);
+    for (int i = 0; i < 64; i += 4)
+        glslang::TConstUnionArray view(array, i, 4);
+
+    EXPECT_EQ(allocated + 64 * sizeof(glslang::TConstUnion), glslang::TConstUnionArray::getAllocatedBytes());
+    EXPECT_EQ(shared + 64 * sizeof(glslang::TConstUnion), glslang::TConstUnionArray::getSharedBytes());
+}
+
+}  // anonymous namespace
+}  // namespace glslangtest
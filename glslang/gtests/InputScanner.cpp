@@ -0,0 +1,265 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "StandAlone/ResourceLimits.h"
+#include "glslang/Include/Common.h"
+#include "glslang/Include/PoolAlloc.h"
+#include "glslang/MachineIndependent/Scan.h"
+#include "glslang/Public/ShaderLang.h"
+
+namespace glslangtest {
+namespace {
+
+// Owns the strings a TInputScanner reads, which it only points to.
+class TScannerInput {
+public:
+    explicit TScannerInput(const std::vector<std::string>& strings)
+        : strings(strings)
+    {
+        for (const std::string& s : this->strings) {
+            pointers.push_back(s.c_str());
+            lengths.push_back(s.size());
+        }
+        scanner.reset(new glslang::TInputScanner((int)pointers.size(), pointers.data(), lengths.data()));
+    }
+
+    glslang::TInputScanner& operator*() { return *scanner; }
+    glslang::TInputScanner* operator->() { return scanner.get(); }
+
+private:
+    const std::vector<std::string> strings;
+    std::vector<const char*> pointers;
+    std::vector<size_t> lengths;
+    std::unique_ptr<glslang::TInputScanner> scanner;
+};
+
+// ' ' and '\t', alternating, n of them.
+std::string blanks(size_t n)
+{
+    std::string s;
+    for (size_t i = 0; i < n; ++i)
+        s += (i % 2) ? '\t' : ' ';
+    return s;
+}
+
+// Runs of every length up to a few 16-character blocks, followed by
+// trailing text of every length up to one block, so that each stopping
+// point is met both inside a block and in the tail after the last whole
+// block.
+const size_t MaxRun = 50;
+const size_t MaxTrail = 17;
+
+TEST(InputScanner, SkipSpaceTabStopsAtFirstOther)
+{
+    for (size_t run = 0; run <= MaxRun; ++run) {
+        for (size_t trail = 0; trail <= MaxTrail; ++trail) {
+            TScannerInput input({blanks(run) + "x" + blanks(trail)});
+            input->skipSpaceTab();
+            EXPECT_EQ('x', input->peek()) << "run " << run << ", trail " << trail;
+            EXPECT_EQ((int)run, input->getSourceLoc().column) << "run " << run << ", trail " << trail;
+        }
+    }
+}
+
+TEST(InputScanner, SkipSpaceTabStopsAtNewline)
+{
+    for (size_t run = 0; run <= MaxRun; ++run) {
+        for (size_t trail = 0; trail <= MaxTrail; ++trail) {
+            TScannerInput input({blanks(run) + "\n" + blanks(trail)});
+            input->skipSpaceTab();
+            EXPECT_EQ('\n', input->peek()) << "run " << run << ", trail " << trail;
+            EXPECT_EQ(1, input->getSourceLoc().line) << "run " << run << ", trail " << trail;
+        }
+    }
+}
+
+TEST(InputScanner, SkipSpaceTabLeavesLastCharacterOfString)
+{
+    for (size_t length = 1; length <= MaxRun; ++length) {
+        TScannerInput input({blanks(length), "x"});
+        input->skipSpaceTab();
+        EXPECT_EQ(0, input->getSourceLoc().string) << "length " << length;
+        EXPECT_EQ((int)length - 1, input->getSourceLoc().column) << "length " << length;
+
+        // get() is left to cross into the next string
+        input->get();
+        EXPECT_EQ('x', input->peek()) << "length " << length;
+        EXPECT_EQ(1, input->getSourceLoc().string) << "length " << length;
+    }
+}
+
+TEST(InputScanner, WhiteSpaceRunCrossesStrings)
+{
+    for (size_t run = 0; run <= MaxRun; ++run) {
+        TScannerInput input({blanks(run), blanks(run) + "x"});
+        bool foundNonSpaceTab = false;
+        input->consumeWhiteSpace(foundNonSpaceTab);
+        EXPECT_EQ('x', input->peek()) << "run " << run;
+        EXPECT_FALSE(foundNonSpaceTab) << "run " << run;
+        if (run > 0) {
+            EXPECT_EQ(1, input->getSourceLoc().string) << "run " << run;
+            EXPECT_EQ((int)run, input->getSourceLoc().column) << "run " << run;
+        }
+    }
+}
+
+TEST(InputScanner, SkipUntilStopsAtEachStopCharacter)
+{
+    const char stops[] = {'\\', '\r', '\n', '*'};
+    for (char stop : stops) {
+        for (size_t run = 0; run <= MaxRun; ++run) {
+            for (size_t trail = 0; trail <= MaxTrail; ++trail) {
+                TScannerInput input({std::string(run, 'c') + stop + std::string(trail, 'c')});
+                if (stop == '*')
+                    input->skipUntil('*', '*');
+                else
+                    input->skipUntil('\\', '\r');  // '\n' always stops a run
+                EXPECT_EQ((unsigned char)stop, input->peek())
+                    << "stop " << (int)stop << ", run " << run << ", trail " << trail;
+                EXPECT_EQ((int)run, input->getSourceLoc().column)
+                    << "stop " << (int)stop << ", run " << run << ", trail " << trail;
+            }
+        }
+    }
+}
+
+TEST(InputScanner, SkipUntilPassesOtherStopCharacters)
+{
+    for (size_t run = 0; run <= MaxRun; ++run) {
+        for (size_t trail = 0; trail <= MaxTrail; ++trail) {
+            TScannerInput input({std::string(run, '*') + "\\" + std::string(trail, 'c')});
+            input->skipUntil('\\', '\r');
+            EXPECT_EQ('\\', input->peek()) << "run " << run << ", trail " << trail;
+            EXPECT_EQ((int)run, input->getSourceLoc().column) << "run " << run << ", trail " << trail;
+        }
+    }
+}
+
+TEST(InputScanner, SkipUntilLeavesLastCharacterOfString)
+{
+    for (size_t length = 1; length <= MaxRun; ++length) {
+        TScannerInput input({std::string(length, 'c'), "*"});
+        input->skipUntil('*', '*');
+        EXPECT_EQ(0, input->getSourceLoc().string) << "length " << length;
+        EXPECT_EQ((int)length - 1, input->getSourceLoc().column) << "length " << length;
+    }
+}
+
+TEST(InputScanner, BlockCommentEndsAtEveryOffset)
+{
+    // The "*/" falls inside a block, straddles two blocks, and falls in the tail
+    for (size_t run = 0; run <= MaxRun; ++run) {
+        for (size_t trail = 0; trail <= MaxTrail; ++trail) {
+            TScannerInput input({"/*" + std::string(run, 'c') + "*/x" + std::string(trail, 'c')});
+            EXPECT_TRUE(input->consumeComment()) << "run " << run << ", trail " << trail;
+            EXPECT_EQ('x', input->peek()) << "run " << run << ", trail " << trail;
+            EXPECT_EQ((int)run + 4, input->getSourceLoc().column) << "run " << run << ", trail " << trail;
+        }
+    }
+}
+
+TEST(InputScanner, BlockCommentEndsAcrossStrings)
+{
+    for (size_t run = 0; run <= MaxRun; ++run) {
+        TScannerInput input({"/*" + std::string(run, 'c') + "*", "/x"});
+        EXPECT_TRUE(input->consumeComment()) << "run " << run;
+        EXPECT_EQ('x', input->peek()) << "run " << run;
+        EXPECT_EQ(1, input->getSourceLoc().string) << "run " << run;
+    }
+}
+
+TEST(InputScanner, LineCommentFollowsContinuation)
+{
+    for (size_t run = 0; run <= MaxRun; ++run) {
+        TScannerInput input({"//" + std::string(run, 'c') + "\\\n" + std::string(run, 'c') + "\nx"});
+        EXPECT_TRUE(input->consumeComment()) << "run " << run;
+        EXPECT_EQ('x', input->peek()) << "run " << run;
+        EXPECT_EQ(3, input->getSourceLoc().line) << "run " << run;
+    }
+}
+
+// Preprocesses a version 450 vertex shader (one that has line continuation),
+// returning the output.
+std::string preprocess(const std::string& body)
+{
+    // The shader installs its own pool as the thread's allocator, and that
+    // pool goes with the shader; later tests need the thread's own one back.
+    glslang::TPoolAllocator& threadPool = glslang::GetThreadPoolAllocator();
+
+    std::string output;
+    {
+        const std::string source = "#version 450\n" + body;
+        const char* strings[] = {source.c_str()};
+        glslang::TShader shader(EShLangVertex);
+        shader.setStrings(strings, 1);
+
+        glslang::TShader::ForbidInclude includer;
+        EXPECT_TRUE(shader.preprocess(&glslang::DefaultTBuiltInResource, 100, ENoProfile, false, false,
+                                      EShMsgDefault, &output, includer))
+            << shader.getInfoLog();
+    }
+
+    glslang::SetThreadPoolAllocator(threadPool);
+    return output;
+}
+
+// The preprocessor skips whitespace and comment bodies in bulk; the output
+// must not depend on how long they are.
+TEST(InputScanner, PreprocessorSkipsRunsOfAnyLength)
+{
+    const std::string spaced = preprocess("int a =" + blanks(1) + "1;\n");
+    const std::string blockComment = preprocess("int a = /**/1;\n");
+    const std::string starredComment = preprocess("int a = /***/1;\n");
+    const std::string lineComment = preprocess("int a = 1; //\\\n\nint b;\n");
+    const std::string crComment = preprocess("int a = 1; //\r\nint b;\n");
+
+    for (size_t run = 0; run <= MaxRun; ++run) {
+        const std::string c(run, 'c');
+        EXPECT_EQ(spaced, preprocess("int a =" + blanks(run + 1) + "1;\n")) << "run " << run;
+        EXPECT_EQ(blockComment, preprocess("int a = /*" + c + "*/1;\n")) << "run " << run;
+        EXPECT_EQ(starredComment, preprocess("int a = /*" + c + "*" + c + "*/1;\n")) << "run " << run;
+        EXPECT_EQ(lineComment, preprocess("int a = 1; //" + c + "\\\n" + c + "\nint b;\n")) << "run " << run;
+        EXPECT_EQ(crComment, preprocess("int a = 1; //" + c + "\r\nint b;\n")) << "run " << run;
+    }
+}
+
+}  // anonymous namespace
+}  // namespace glslangtest
@@ -0,0 +1,213 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SPIRV/GlslangToSpv.h"
+#include "SPIRV/spirv.hpp"
+#include "StandAlone/ResourceLimits.h"
+#include "glslang/MachineIndependent/localintermediate.h"
+#include "glslang/Public/ShaderLang.h"
+
+#include "TestFixture.h"
+
+namespace glslangtest {
+namespace {
+
+// Records every visit, naming nodes by their symbol name or by a letter
+// for their kind, in a string such as "<B a ,B b >B".
+class TTraceTraverser : public glslang::TIntermTraverser {
+public:
+    explicit TTraceTraverser(bool rightToLeft)
+        : glslang::TIntermTraverser(true, true, true, rightToLeft) { }
+
+    virtual void visitSymbol(glslang::TIntermSymbol* node) { trace += node->getName().c_str(); trace += ' '; }
+    virtual bool visitBinary(glslang::TVisit visit, glslang::TIntermBinary*) { return record(visit, 'B'); }
+    virtual bool visitUnary(glslang::TVisit visit, glslang::TIntermUnary*) { return record(visit, 'U'); }
+    virtual bool visitAggregate(glslang::TVisit visit, glslang::TIntermAggregate*) { return record(visit, 'A'); }
+    virtual bool visitSelection(glslang::TVisit visit, glslang::TIntermSelection*) { return record(visit, 'S'); }
+    virtual bool visitLoop(glslang::TVisit visit, glslang::TIntermLoop*) { return record(visit, 'L'); }
+    virtual bool visitBranch(glslang::TVisit visit, glslang::TIntermBranch*) { return record(visit, 'R'); }
+
+    std::string trace;
+
+protected:
+    bool record(glslang::TVisit visit, char kind)
+    {
+        trace += visit == glslang::EvPreVisit ? '<' : visit == glslang::EvInVisit ? ',' : '>';
+        trace += kind;
+        trace += ' ';
+        return true;
+    }
+};
+
+// Counts the binary nodes of a tree, while checking each is entered,
+// split, and left exactly once, in that order.
+class TCountTraverser : public glslang::TIntermTraverser {
+public:
+    TCountTraverser() : glslang::TIntermTraverser(true, true, true), open(0), count(0), symbols(0) { }
+
+    virtual void visitSymbol(glslang::TIntermSymbol*) { ++symbols; }
+    virtual bool visitBinary(glslang::TVisit visit, glslang::TIntermBinary*)
+    {
+        if (visit == glslang::EvPreVisit) {
+            ++open;
+            ++count;
+        } else if (visit == glslang::EvPostVisit)
+            --open;
+        return true;
+    }
+
+    int open;
+    int count;
+    int symbols;
+};
+
+// Builds the trees of each test in a pool of their own.
+class IntermTraverseTest : public PoolAllocatorTest {
+protected:
+    static glslang::TIntermSymbol* symbol(const char* name)
+    {
+        return new glslang::TIntermSymbol(0, name, glslang::TType(glslang::EbtFloat));
+    }
+
+    static glslang::TIntermBinary* binary(glslang::TIntermTyped* left, glslang::TIntermTyped* right)
+    {
+        glslang::TIntermBinary* node = new glslang::TIntermBinary(glslang::EOpAdd);
+        node->setLeft(left);
+        node->setRight(right);
+        return node;
+    }
+
+    // A sequence of one node of each kind with children
+    static glslang::TIntermAggregate* everyKind()
+    {
+        glslang::TIntermUnary* unary = new glslang::TIntermUnary(glslang::EOpNegative);
+        unary->setOperand(symbol("c"));
+
+        glslang::TIntermAggregate* root = new glslang::TIntermAggregate(glslang::EOpSequence);
+        root->getSequence().push_back(binary(symbol("a"), symbol("b")));
+        root->getSequence().push_back(unary);
+        root->getSequence().push_back(new glslang::TIntermSelection(symbol("d"), symbol("e"), nullptr));
+        root->getSequence().push_back(new glslang::TIntermLoop(symbol("g"), symbol("f"), nullptr, true));
+        root->getSequence().push_back(new glslang::TIntermBranch(glslang::EOpBreak, nullptr));
+        root->getSequence().push_back(new glslang::TIntermBranch(glslang::EOpReturn, symbol("h")));
+        return root;
+    }
+};
+
+TEST_F(IntermTraverseTest, VisitsLeftToRight)
+{
+    TTraceTraverser it(false);
+    everyKind()->traverse(&it);
+    EXPECT_EQ("<A <B a ,B b >B ,A <U c >U ,A <S d e >S ,A <L f g >L ,A <R >R ,A <R h >R >A ", it.trace);
+    EXPECT_EQ(2, it.getMaxDepth());
+}
+
+TEST_F(IntermTraverseTest, VisitsRightToLeft)
+{
+    TTraceTraverser it(true);
+    everyKind()->traverse(&it);
+    EXPECT_EQ("<A <R h >R ,A <R >R ,A <L g f >L ,A <S e d >S ,A <U c >U ,A <B b ,B a >B >A ", it.trace);
+}
+
+TEST_F(IntermTraverseTest, VisitCanTakeOverChildren)
+{
+    // Takes over traversing the children of binary nodes, visiting the right
+    // side twice, as translators do when they need the children in an order of
+    // their own.
+    class TTakeOverTraverser : public TTraceTraverser {
+    public:
+        TTakeOverTraverser() : TTraceTraverser(false) { }
+        virtual bool visitBinary(glslang::TVisit visit, glslang::TIntermBinary* node)
+        {
+            record(visit, 'B');
+            node->getRight()->traverse(this);
+            node->getRight()->traverse(this);
+            return false;
+        }
+    } it;
+
+    glslang::TIntermAggregate* root = new glslang::TIntermAggregate(glslang::EOpSequence);
+    root->getSequence().push_back(binary(symbol("a"), binary(symbol("b"), symbol("c"))));
+    root->getSequence().push_back(symbol("d"));
+    root->traverse(&it);
+    EXPECT_EQ("<A <B <B c c <B c c ,A d >A ", it.trace);
+}
+
+// Compiling manages its own pools, so this is not an IntermTraverseTest.
+TEST(IntermTraverseCompileTest, DeepExpression)
+{
+    // a + a + ... parses to a left-leaning chain of this many additions,
+    // which is far deeper than a recursive traversal could handle on a
+    // typical thread stack.
+    const int depth = 100000;
+    std::string source = "#version 450\nuniform float a;\nout float o;\nvoid main() { o = a";
+    source.reserve(source.size() + 4 * depth + 32);
+    for (int i = 0; i < depth; ++i)
+        source += " + a";
+    source += "; }\n";
+
+    const char* strings[] = { source.c_str() };
+    glslang::TShader shader(EShLangFragment);
+    shader.setStrings(strings, 1);
+    ASSERT_TRUE(shader.parse(&glslang::DefaultTBuiltInResource, 100, false, EShMsgDefault)) << shader.getInfoLog();
+
+    glslang::TProgram program;
+    program.addShader(&shader);
+    ASSERT_TRUE(program.link(EShMsgDefault)) << program.getInfoLog();
+    ASSERT_TRUE(program.buildReflection());
+    EXPECT_EQ(1, program.getNumLiveUniformVariables());
+
+    TCountTraverser it;
+    program.getIntermediate(EShLangFragment)->getTreeRoot()->traverse(&it);
+    EXPECT_EQ(0, it.open);
+    EXPECT_EQ(depth, it.count - 1);     // and the assignment
+    EXPECT_EQ(depth + 4, it.symbols);   // and o, the first a, and both as linker objects
+    EXPECT_LE(depth, it.getMaxDepth());
+
+    // Translating the tree to SPIR-V has to cope with its depth too
+    std::vector<unsigned int> spirv;
+    spv::SpvBuildLogger logger;
+    glslang::GlslangToSpv(*program.getIntermediate(EShLangFragment), spirv, &logger);
+    ASSERT_FALSE(spirv.empty());
+    EXPECT_EQ(spv::MagicNumber, spirv[0]);
+    EXPECT_EQ("", logger.getAllMessages());
+}
+
+}  // anonymous namespace
+}  // namespace glslangtest
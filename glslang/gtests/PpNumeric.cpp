@@ -0,0 +1,211 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "StandAlone/ResourceLimits.h"
+#include "glslang/Include/Common.h"
+#include "glslang/MachineIndependent/localintermediate.h"
+#include "glslang/Public/ShaderLang.h"
+
+namespace glslangtest {
+namespace {
+
+// Collects the value of every constant in a tree, in the order they appear.
+class TConstantTraverser : public glslang::TIntermTraverser {
+public:
+    virtual void visitConstantUnion(glslang::TIntermConstantUnion* node)
+    {
+        values.push_back(node->getConstArray()[0].getDConst());
+    }
+
+    std::vector<double> values;
+};
+
+// Exposes the tree of a shader, which is there even if parsing reported errors (as long as
+// they didn't end it).
+class TTreeShader : public glslang::TShader {
+public:
+    TTreeShader() : glslang::TShader(EShLangFragment) { }
+    TIntermNode* getTreeRoot() const { return intermediate->getTreeRoot(); }
+};
+
+// Parses a shader assigning each literal in turn (to a double if it has the lf suffix, and to
+// a float otherwise), so the scanner converts them, and returns the values it converted them
+// to.  The info log of the parse, which has no warnings, is returned through log.
+std::vector<double> fold(const std::vector<std::string>& literals, std::string& log)
+{
+    std::string source = "#version 450\nfloat f;\ndouble d;\nvoid main()\n{\n";
+    for (const std::string& literal : literals) {
+        const bool isDouble = literal.size() > 2 && (literal.back() == 'f' || literal.back() == 'F') &&
+                              (literal[literal.size() - 2] == 'l' || literal[literal.size() - 2] == 'L');
+        source += (isDouble ? "    d = " : "    f = ") + literal + ";\n";
+    }
+    source += "}\n";
+
+    const char* strings[] = { source.c_str() };
+    TTreeShader shader;
+    shader.setStrings(strings, 1);
+    // keep going past errors, so that bad literals are converted as well
+    const EShMessages messages = (EShMessages)(EShMsgCascadingErrors | EShMsgSuppressWarnings);
+    shader.parse(&glslang::DefaultTBuiltInResource, 100, false, messages);
+    log = shader.getInfoLog();
+
+    TConstantTraverser it;
+    if (shader.getTreeRoot() != nullptr)
+        shader.getTreeRoot()->traverse(&it);
+    return it.values;
+}
+
+// Checks each literal parses, without complaint, to the value strtod() converts it to.
+void expectStrtod(const std::vector<std::string>& literals)
+{
+    std::string log;
+    const std::vector<double> values = fold(literals, log);
+    ASSERT_EQ("", log);
+    ASSERT_EQ(literals.size(), values.size());
+    for (size_t i = 0; i < literals.size(); ++i)
+        ASSERT_EQ(strtod(literals[i].c_str(), nullptr), values[i]) << literals[i];
+}
+
+std::string randomDigits(std::mt19937& random, int count)
+{
+    std::string digits;
+    for (int i = 0; i < count; ++i)
+        digits += (char)('0' + random() % 10);
+    return digits;
+}
+
+// A random literal, with at most maxDigits digits on each side of the decimal point, and an
+// exponent (if it has one) of at most maxExponent.  The integer part may have leading zeros,
+// which the scanner reads as a would-be octal literal before handing it to the float scanner,
+// and the literal may have an f or lf suffix.
+std::string randomLiteral(std::mt19937& random, int maxDigits, int maxExponent)
+{
+    std::string literal = randomDigits(random, (int)(random() % (maxDigits + 1)));
+    if (! literal.empty() && random() % 8 == 0)
+        literal.insert(0, 1 + random() % 3, '0');
+    const bool hasFraction = literal.empty() || random() % 4 != 0;
+    if (hasFraction)
+        literal += "." + randomDigits(random, 1 + (int)(random() % maxDigits));
+    if (! hasFraction || random() % 2 == 0) {
+        literal += random() % 2 == 0 ? "e" : "E";
+        const int exponent = (int)(random() % (2 * maxExponent + 1)) - maxExponent;
+        if (exponent >= 0 && random() % 2 == 0)
+            literal += "+";
+        literal += std::to_string(exponent);
+    }
+    switch (random() % 4) {
+    case 0: literal += "f";  break;
+    case 1: literal += "lf"; break;
+    default:                 break;
+    }
+    return literal;
+}
+
+// Random literals, a shader's worth at a time.
+void expectStrtodOnRandomLiterals(unsigned seed, int maxDigits, int maxExponent)
+{
+    std::mt19937 random(seed);
+    for (int shader = 0; shader < 100; ++shader) {
+        std::vector<std::string> literals;
+        for (int i = 0; i < 1000; ++i)
+            literals.push_back(randomLiteral(random, maxDigits, maxExponent));
+        expectStrtod(literals);
+    }
+}
+
+TEST(PpNumericTest, MatchesStrtodOnEdgeCases)
+{
+    expectStrtod({
+        "0.0", "0.", ".0", "000.000", "0e0", "0.0e-400", "1.0", "1e0", "1.5", "0.1", "0.3", "1e1", "1e22",
+        "1e23", "1e-22", "1e-23", "123456789012345678e-5", "9007199254740992.0", "9007199254740993.0",
+        "9007199254740994.0", "9007199254740995.0", "4503599627370497.5", "1.7976931348623157e308",
+        "1.7976931348623159e308", "1e400", "2.2250738585072014e-308", "4.9e-324", "2.4703282292062327e-324",
+        "1e-400", "3.14159265358979323846264338327950288", "0.000000000000000000000000000001",
+        "1.00000000000000000000000000000000000001", "5e37", "123e30", "999999999999999e22",
+        // handed over from the integer scanners
+        "0123.5", "0089.5", "09e1", "00e5", "0777e-2", "5e3", "7E+2", "123456789e-9",
+        // suffixed
+        "1.5f", "1.5F", "1e2f", "0.1lf", "0.1LF", "1e23lf", "9007199254740993.0lf", "1e-400lf",
+    });
+}
+
+TEST(PpNumericTest, MatchesStrtodOnShortLiterals)
+{
+    // literals like those in baked data, which mostly take the fast path
+    expectStrtodOnRandomLiterals(1, 9, 40);
+}
+
+TEST(PpNumericTest, MatchesStrtodOnLongLiterals)
+{
+    // literals with more digits than a double holds, or extreme exponents, which need strtod()
+    expectStrtodOnRandomLiterals(2, 25, 340);
+}
+
+// When the scanner complains about a literal, the value is converted from the text it kept of it.
+TEST(PpNumericTest, ConvertsTextKeptOfBadLiterals)
+{
+    // Past glslang::MaxTokenLength characters, the scanner starts the text over after its first
+    // character, so 1.000...00025 is kept as "125".
+    const std::string longFraction = "1." + std::string(glslang::MaxTokenLength - 2, '0') + "25";
+    const std::string longExponent = "1e" + std::string(glslang::MaxTokenLength - 2, '0') + "3";
+    const std::string longNegativeExponent = "1e-" + std::string(glslang::MaxTokenLength - 3, '0') + "4";
+
+    std::string log;
+    std::vector<double> values = fold({ longFraction, "2.5", longExponent, longNegativeExponent }, log);
+    ASSERT_EQ(4u, values.size()) << log;
+    EXPECT_EQ(125.0, values[0]);
+    EXPECT_EQ(2.5, values[1]);
+    EXPECT_EQ(13.0, values[2]);
+    EXPECT_EQ(14.0, values[3]);
+    EXPECT_NE(std::string::npos, log.find("float literal too long")) << log;
+
+    // The text kept of 1.5e, 2e and 3.25E is the text that strtod() would stop converting at
+    // anyway.
+    values = fold({ "1.5e", "2e", "3.25E" }, log);
+    ASSERT_EQ(3u, values.size()) << log;
+    EXPECT_EQ(1.5, values[0]);
+    EXPECT_EQ(2.0, values[1]);
+    EXPECT_EQ(3.25, values[2]);
+    EXPECT_NE(std::string::npos, log.find("bad character in float exponent")) << log;
+}
+
+}  // anonymous namespace
+}  // namespace glslangtest
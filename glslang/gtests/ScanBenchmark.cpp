@@ -0,0 +1,180 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Times preprocessing and parsing of generated shaders that are mostly
+// whitespace or comments, which is where the input scanner's bulk skips
+// (TInputScanner::skipSpaceTab() and skipUntil()) do their work.
+//
+// This is not a test; it is built with the tests and run by hand:
+//
+//     glslangScanBenchmark [repetitions]
+//
+// Each case reports the best of the repetitions (20 by default).  To time
+// the skips without their SSE2 kernels, build with GLSLANG_SCAN_NO_SSE2
+// defined.  The program only uses the public API, so it also builds against
+// a tree from before the bulk skips, for comparison.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "StandAlone/ResourceLimits.h"
+#include "glslang/Public/ShaderLang.h"
+
+namespace {
+
+// Lines of code indented by 4 to 60 blanks, tabs mixed in.
+std::string indentedSource(int lines)
+{
+    std::string body;
+    for (int i = 0; i < lines; ++i) {
+        body.append(4 + (i * 7) % 57, ' ');
+        if (i % 3 == 0)
+            body += "\t\t";
+        body += "x += 1.0;\n";
+    }
+
+    return "#version 450\nvoid main()\n{\n    float x = 0.0;\n" + body + "}\n";
+}
+
+// A /* */ banner of 'width' characters in front of each function.
+std::string blockCommentSource(int functions, int width)
+{
+    std::string source = "#version 450\n";
+    for (int i = 0; i < functions; ++i) {
+        source += "/*";
+        source.append(width, '=');
+        source += "\n * f" + std::to_string(i) + ": a function with a long banner over it\n ";
+        source.append(width, '=');
+        source += "*/\nfloat f" + std::to_string(i) + "(float a) { return a; }\n";
+    }
+
+    return source + "void main() { }\n";
+}
+
+// A // comment of 'width' characters after each line of code.
+std::string lineCommentSource(int lines, int width)
+{
+    std::string body;
+    for (int i = 0; i < lines; ++i) {
+        body += "    x += 1.0;  // ";
+        body.append(width, '-');
+        body += '\n';
+    }
+
+    return "#version 450\nvoid main()\n{\n    float x = 0.0;\n" + body + "}\n";
+}
+
+// Code with typical indentation and the odd comment, where the runs are short.
+std::string typicalSource(int lines)
+{
+    std::string body;
+    for (int i = 0; i < lines; ++i) {
+        body.append(4 * (1 + i % 3), ' ');
+        body += "x = x * 0.5 + float(" + std::to_string(i) + ");";
+        if (i % 4 == 0)
+            body += "  // scale, then offset";
+        body += '\n';
+    }
+
+    return "#version 450\nvoid main()\n{\n    float x = 0.0;\n" + body + "}\n";
+}
+
+// The best time, in milliseconds, of 'repetitions' runs of preprocess()
+// or parse() on 'source'.
+double bestTime(const std::string& source, bool parse, int repetitions)
+{
+    const char* strings[] = { source.c_str() };
+    double best = 0;
+
+    for (int r = 0; r < repetitions; ++r) {
+        glslang::TShader shader(EShLangFragment);
+        shader.setStrings(strings, 1);
+
+        const auto start = std::chrono::steady_clock::now();
+        bool success;
+        if (parse)
+            success = shader.parse(&glslang::DefaultTBuiltInResource, 100, false, EShMsgDefault);
+        else {
+            std::string output;
+            glslang::TShader::ForbidInclude includer;
+            success = shader.preprocess(&glslang::DefaultTBuiltInResource, 100, ENoProfile, false, false,
+                                        EShMsgOnlyPreprocessor, &output, includer);
+        }
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+
+        if (! success) {
+            std::printf("failed:\n%s\n", shader.getInfoLog());
+            std::exit(1);
+        }
+
+        best = r == 0 ? time.count() : std::min(best, time.count());
+    }
+
+    return best;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const int repetitions = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+
+    glslang::InitializeProcess();
+
+    const struct {
+        const char* name;
+        std::string source;
+    } cases[] = {
+        { "indentation",    indentedSource(40000) },
+        { "block comments", blockCommentSource(4000, 200) },
+        { "line comments",  lineCommentSource(20000, 60) },
+        { "typical",        typicalSource(40000) },
+    };
+
+    std::printf("%-16s %8s %12s %12s %12s\n", "case", "KB", "preprocess", "parse", "MB/s (pp)");
+    for (const auto& c : cases) {
+        const double preprocessTime = bestTime(c.source, false, repetitions);
+        const double parseTime = bestTime(c.source, true, repetitions);
+        std::printf("%-16s %8.0f %9.2f ms %9.2f ms %12.1f\n", c.name, c.source.size() / 1024.0,
+                    preprocessTime, parseTime, c.source.size() / (preprocessTime * 1000.0));
+    }
+
+    glslang::FinalizeProcess();
+
+    return 0;
+}
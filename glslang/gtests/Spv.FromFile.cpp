@@ -206,6 +206,7 @@ INSTANTIATE_TEST_CASE_P(
         "spv.subpass.frag",
         "spv.specConstant.vert",
         "spv.specConstant.comp",
+        "spv.constantTable.comp",
         "spv.specConstantComposite.vert",
         "spv.specConstantOperations.vert",
         "spv.precise.tese",
@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "StandAlone/ResourceLimits.h"
+#include "glslang/Public/ShaderLang.h"
+
+namespace glslangtest {
+namespace {
+
+// Parses a shader and returns its info log.
+std::string parse(EShLanguage stage, const char* source, EShMessages messages)
+{
+    const char* strings[] = { source };
+    glslang::TShader shader(stage);
+    shader.setStrings(strings, 1);
+    shader.parse(&glslang::DefaultTBuiltInResource, 100, false, messages);
+    return shader.getInfoLog();
+}
+
+// The lines of a log that start with the given prefix.
+std::vector<std::string> linesStartingWith(const std::string& log, const std::string& prefix)
+{
+    std::vector<std::string> lines;
+    std::istringstream stream(log);
+    for (std::string line; std::getline(stream, line); ) {
+        if (line.compare(0, prefix.size(), prefix) == 0)
+            lines.push_back(line);
+    }
+    return lines;
+}
+
+bool contains(const std::string& log, const char* text)
+{
+    return log.find(text) != std::string::npos;
+}
+
+// Warns about the version, from the preprocessor and the parser, and (as the
+// #extension directive asks) about the extension's use, and then has an error.
+const char* const WarningShader =
+    "#version 450\n"
+    "#extension GL_ARB_gpu_shader_int64 : warn\n"
+    "#define A__B 1\n"
+    "float a__b;\n"
+    "int64_t big;\n"
+    "out vec4 color;\n"
+    "void main()\n"
+    "{\n"
+    "    color = 1;\n"
+    "}\n";
+
+TEST(SuppressWarningsTest, WarningsAreReportedByDefault)
+{
+    const std::string log = parse(EShLangFragment, WarningShader, EShMsgDefault);
+    EXPECT_TRUE(contains(log, "version 450 is not yet complete")) << log;
+    EXPECT_TRUE(contains(log, "WARNING: 0:3: '#define' : names containing consecutive underscores")) << log;
+    EXPECT_TRUE(contains(log, "WARNING: 0:4: 'a__b' : identifiers containing consecutive underscores")) << log;
+    EXPECT_TRUE(contains(log, "WARNING: 0:5: extension GL_ARB_gpu_shader_int64 is being used")) << log;
+    EXPECT_FALSE(linesStartingWith(log, "ERROR: 0:").empty()) << log;
+}
+
+TEST(SuppressWarningsTest, SuppressesOptionalWarnings)
+{
+    const std::string log = parse(EShLangFragment, WarningShader, EShMsgDefault);
+    const std::string suppressed = parse(EShLangFragment, WarningShader, EShMsgSuppressWarnings);
+
+    EXPECT_FALSE(contains(suppressed, "not yet complete")) << suppressed;
+    EXPECT_FALSE(contains(suppressed, "consecutive underscores")) << suppressed;
+
+    // #extension ... : warn asks for these
+    const std::vector<std::string> warnings = linesStartingWith(suppressed, "WARNING:");
+    ASSERT_EQ(1u, warnings.size()) << suppressed;
+    EXPECT_EQ("WARNING: 0:5: extension GL_ARB_gpu_shader_int64 is being used for shader int64", warnings[0]);
+
+    EXPECT_EQ(linesStartingWith(log, "ERROR:"), linesStartingWith(suppressed, "ERROR:"));
+}
+
+TEST(SuppressWarningsTest, SuppressesPreprocessorWarningsForRelaxedErrors)
+{
+    // Relaxed errors turn this preprocessor error into a warning, which is then suppressed.
+    const char* const source =
+        "#version 310 es\n"
+        "#if UNDEFINED\n"
+        "#endif\n"
+        "void main() { }\n";
+
+    const std::string log = parse(EShLangFragment, source, EShMsgRelaxedErrors);
+    EXPECT_TRUE(contains(log, "WARNING: 0:2: 'preprocessor evaluation' : undefined macro in expression")) << log;
+    EXPECT_TRUE(linesStartingWith(log, "ERROR:").empty()) << log;
+
+    const std::string suppressed = parse(EShLangFragment, source,
+                                         (EShMessages)(EShMsgRelaxedErrors | EShMsgSuppressWarnings));
+    EXPECT_EQ("", suppressed);
+}
+
+}  // anonymous namespace
+}  // namespace glslangtest
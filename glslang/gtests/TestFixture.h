@@ -47,6 +47,7 @@
 #include "SPIRV/disassemble.h"
 #include "SPIRV/doc.h"
 #include "StandAlone/ResourceLimits.h"
+#include "glslang/Include/PoolAlloc.h"
 #include "glslang/Public/ShaderLang.h"
 
 #include "Initializer.h"
@@ -209,6 +210,17 @@ public:
             glslang::GlslangToSpv(*program.getIntermediate(kind),
                                   spirv_binary, &logger);
 
+            // Serializing straight into a caller-sized buffer must give the same module.
+            std::vector<uint32_t> spirv_in_place;
+            spv::SpvBuildLogger in_place_logger;
+            glslang::GlslangToSpv(*program.getIntermediate(kind),
+                                  [&spirv_in_place](size_t size) {
+                                      spirv_in_place.resize(size);
+                                      return spirv_in_place.data();
+                                  },
+                                  &in_place_logger);
+            EXPECT_EQ(spirv_binary, spirv_in_place);
+
             std::ostringstream disassembly_stream;
             spv::Parameterize();
             spv::Disassemble(disassembly_stream, spirv_binary);
@@ -332,6 +344,24 @@ private:
     const bool isForwardCompatible;
 };
 
+// Base class for tests that build glslang objects (trees, constant arrays,
+// ...) themselves.  Gives each test a pool of its own, installed as the
+// thread's allocator.  The thread's allocator can't be used directly: a
+// shader compiled by an earlier test leaves it pointing at the shader's
+// pool, which went away with the shader.
+class PoolAllocatorTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        previousPool = &glslang::GetThreadPoolAllocator();
+        glslang::SetThreadPoolAllocator(pool);
+    }
+    void TearDown() override { glslang::SetThreadPoolAllocator(*previousPool); }
+
+    glslang::TPoolAllocator pool;
+    glslang::TPoolAllocator* previousPool;
+};
+
 }  // namespace glslangtest
 
 #endif  // GLSLANG_GTESTS_TEST_FIXTURE_H
@@ -0,0 +1,136 @@
+//
+// Copyright (C) 2016 The node-glsl-compiler authors.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//    Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+//    Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+//    Neither the name of the copyright holders nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "StandAlone/ResourceLimits.h"
+#include "glslang/Public/ShaderLang.h"
+
+namespace glslangtest {
+namespace {
+
+struct ParseResult {
+    bool success;
+    std::string log;
+    bool hinted;
+    glslang::TShader::VersionHint sniffed;
+};
+
+// Parses a fragment shader, with the given version hint if it is non-null.
+ParseResult parse(const std::string& source, const glslang::TShader::VersionHint* hint)
+{
+    const char* strings[] = {source.c_str()};
+    glslang::TShader shader(EShLangFragment);
+    shader.setStrings(strings, 1);
+    if (hint != nullptr)
+        shader.setVersionHint(*hint);
+
+    ParseResult result;
+    result.success = shader.parse(&glslang::DefaultTBuiltInResource, 100, false, EShMsgDefault);
+    result.log = shader.getInfoLog();
+    result.hinted = shader.getVersionHint(result.sniffed);
+    return result;
+}
+
+TEST(VersionHint, NoneBeforeParse)
+{
+    glslang::TShader shader(EShLangFragment);
+    glslang::TShader::VersionHint hint;
+    EXPECT_FALSE(shader.getVersionHint(hint));
+}
+
+TEST(VersionHint, SniffsLeadingDirective)
+{
+    const ParseResult result = parse("#version 310 es\nvoid main() { }\n", nullptr);
+    ASSERT_TRUE(result.success) << result.log;
+    ASSERT_TRUE(result.hinted);
+    EXPECT_EQ(310, result.sniffed.version);
+    EXPECT_EQ(EEsProfile, result.sniffed.profile);
+    EXPECT_FALSE(result.sniffed.notFirst);
+}
+
+TEST(VersionHint, SniffsDirectiveAfterComments)
+{
+    const ParseResult result = parse("// header\n\n#version 450\nvoid main() { }\n", nullptr);
+    ASSERT_TRUE(result.success) << result.log;
+    ASSERT_TRUE(result.hinted);
+    EXPECT_EQ(450, result.sniffed.version);
+    EXPECT_EQ(ENoProfile, result.sniffed.profile);
+    EXPECT_TRUE(result.sniffed.notFirst);
+}
+
+TEST(VersionHint, SniffsMissingDirective)
+{
+    const ParseResult result = parse("void main() { }\n", nullptr);
+    ASSERT_TRUE(result.success) << result.log;
+    ASSERT_TRUE(result.hinted);
+    EXPECT_EQ(0, result.sniffed.version);
+    EXPECT_EQ(ENoProfile, result.sniffed.profile);
+}
+
+TEST(VersionHint, NoHintForLateDirective)
+{
+    const ParseResult result = parse("precision mediump float;\n#version 300 es\nvoid main() { }\n", nullptr);
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.hinted);
+}
+
+TEST(VersionHint, HintedParseMatchesSniffedParse)
+{
+    const char* sources[] = {
+        "#version 310 es\nprecision mediump float;\nout vec4 c;\nvoid main() { c = vec4(1.0); }\n",
+        "#version 450 core\nlayout(location = 0) out vec4 c;\nvoid main() { c = vec4(x); }\n",
+        "// ES 300 and up don't allow anything before the directive\n#version 300 es\nvoid main() { }\n",
+        "#version 130\nvoid main() { gl_FragColor = vec4(1.0); }\n",
+        "void main() { gl_FragColor = vec4(1.0); }\n",
+    };
+
+    for (const char* source : sources) {
+        const ParseResult sniffed = parse(source, nullptr);
+        ASSERT_TRUE(sniffed.hinted) << source;
+
+        const ParseResult hinted = parse(source, &sniffed.sniffed);
+        EXPECT_EQ(sniffed.success, hinted.success) << source;
+        EXPECT_EQ(sniffed.log, hinted.log) << source;
+        ASSERT_TRUE(hinted.hinted) << source;
+        EXPECT_EQ(sniffed.sniffed.version, hinted.sniffed.version) << source;
+        EXPECT_EQ(sniffed.sniffed.profile, hinted.sniffed.profile) << source;
+        EXPECT_EQ(sniffed.sniffed.notFirst, hinted.sniffed.notFirst) << source;
+    }
+}
+
+}  // anonymous namespace
+}  // namespace glslangtest
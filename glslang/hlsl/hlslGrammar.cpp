@@ -1337,9 +1337,10 @@ bool HlslGrammar::acceptStruct(TType& type)
     }
 
     // create the user-defined type
-    if (qualifier.storage == EvqTemporary)
+    if (qualifier.storage == EvqTemporary) {
         new(&type) TType(typeList, structName);
-    else
+        type.buildMemberStrings();
+    } else
         new(&type) TType(typeList, structName, qualifier); // sets EbtBlock
 
     // If it was named, which means the type can be reused later, add
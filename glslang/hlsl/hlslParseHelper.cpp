@@ -244,9 +244,7 @@ void HlslParseContext::outputMessage(const TSourceLoc& loc, const char* szReason
 
     safe_vsprintf(szExtraInfo, maxSize, szExtraInfoFormat, args);
 
-    infoSink.info.prefix(prefix);
-    infoSink.info.location(loc);
-    infoSink.info << "'" << szToken << "' : " << szReason << " " << szExtraInfo << "\n";
+    infoSink.info.diagnostic(prefix, loc, szToken, szReason, szExtraInfo);
 
     if (prefix == EPrefixError) {
         ++numErrors;
@@ -287,6 +285,8 @@ void C_DECL HlslParseContext::ppError(const TSourceLoc& loc, const char* szReaso
 void C_DECL HlslParseContext::ppWarn(const TSourceLoc& loc, const char* szReason, const char* szToken,
     const char* szExtraInfoFormat, ...)
 {
+    if (suppressWarnings())
+        return;
     va_list args;
     va_start(args, szExtraInfoFormat);
     outputMessage(loc, szReason, szToken, szExtraInfoFormat, EPrefixWarning, args);
@@ -3555,15 +3555,12 @@ const TFunction* HlslParseContext::findFunction(const TSourceLoc& loc, const TFu
 
     const TFunction* candidate = nullptr;
     TVector<TFunction*> candidateList;
-    symbolTable.findFunctionNameList(call.getMangledName(), candidateList, builtIn);
+    // to even be a potential match, number of arguments has to match
+    symbolTable.findFunctionNameList(call.getMangledName(), call.getParamCount(), candidateList, builtIn);
 
     for (TVector<TFunction*>::const_iterator it = candidateList.begin(); it != candidateList.end(); ++it) {
         const TFunction& function = *(*it);
 
-        // to even be a potential match, number of arguments has to match
-        if (call.getParamCount() != function.getParamCount())
-            continue;
-
         bool possibleMatch = true;
         for (int i = 0; i < function.getParamCount(); ++i) {
             // same types is easy
@@ -2,12 +2,16 @@
 
 // Core node modules
 const path = require( 'path' );
+const os = require( 'os' );
 
 // Public NPM modules
 const assert = require( 'assert-plus' );
+const Promise = require( 'bluebird' );
 
 // Local modules
 const spawnAsync = require( './lib/spawnProcessAsync.js' );
+const PersistentProcessPool = require( './lib/PersistentProcessPool.js' );
+const ProcessError = require( './lib/ProcessError.js' );
 
 
 /**
@@ -24,6 +28,7 @@ assert.ok( ! module.exports.standalone );
 
 /* istanbul ignore next */
 require( 'async-exit-hook' )( cb => {
+    closePersistentPools();
     module.exports.private_finalizeProcess( () => {
         cb();
     });
@@ -32,6 +37,115 @@ require( 'async-exit-hook' )( cb => {
 
 const kStandAlonePath = path.join( __dirname, 'build', 'glslang', 'StandAlone' );
 
+// Upper bound on the number of persistent standalone processes kept alive per executable
+const kMaxPersistentProcesses = Math.max( 1, Math.min( 4, os.cpus().length ) );
+
+const persistentPools = {};
+
+
+// One pool per executable and set of server arguments
+function getPersistentPool( executable, args ) {
+
+    const serverArgs = ['--server'].concat( args || [] );
+    const key = [ executable ].concat( serverArgs ).join( '\0' );
+
+    if ( ! persistentPools[ key ] ) {
+        persistentPools[ key ] = new PersistentProcessPool(
+            path.join( kStandAlonePath, executable ),
+            serverArgs,
+            kMaxPersistentProcesses );
+    }
+
+    return persistentPools[ key ];
+}
+
+
+function closePersistentPools() {
+    Object.keys( persistentPools ).forEach( key => {
+        persistentPools[ key ].close();
+        delete persistentPools[ key ];
+    });
+}
+
+
+/**
+ * Runs one glslangValidator command line on a persistent glslangValidator (--server mode) process.
+ *
+ * The request frame holds the arguments, each terminated by a NUL byte; the response frame holds the exit code,
+ * followed by the length-prefixed stdout and stderr text (see glslangValidator usage).
+ *
+ * @param {Object} options The glslangValidatorAsync options hash.
+ * @return {Promise} Fulfilled once the command line has run successfully; rejected with a ProcessError otherwise.
+ */
+function glslangValidatorPersistentAsync( options ) {
+
+    let args = options.args || [];
+    if ( ! Array.isArray( args ) ) {
+        args = [ args ];
+    }
+    assert.arrayOfString( args, 'If the optional "args" key is provided in the options hash, the value must be a string or an array-of-strings value.' );
+    assert.ok( args.length > 0, 'At least one argument is required in persistent mode.' );
+    assert.optionalFunc( options.stdout, '"options.stdout" must be a function' );
+    assert.optionalFunc( options.stderr, '"options.stderr" must be a function' );
+
+    const payload = Buffer.concat( args.map( arg => Buffer.from( `${arg}\0` ) ) );
+
+    return getPersistentPool( 'glslangValidator' ).requestAsync( payload )
+    .then( response => {
+
+        const code = response.readUInt32LE( 0 );
+        const stdoutLength = response.readUInt32LE( 4 );
+        const stdout = response.slice( 8, 8 + stdoutLength );
+        const stderrLength = response.readUInt32LE( 8 + stdoutLength );
+        const stderr = response.slice( 12 + stdoutLength, 12 + stdoutLength + stderrLength );
+
+        /* istanbul ignore next */
+        if ( ! options.quiet ) {
+            process.stdout.write( stdout );
+            process.stderr.write( stderr );
+        }
+
+        if ( options.stdout && stdout.length > 0 ) {
+            options.stdout( stdout );
+        }
+
+        if ( options.stderr && stderr.length > 0 ) {
+            options.stderr( stderr );
+        }
+
+        if ( code !== 0 ) {
+            throw new ProcessError( code, undefined, `Process glslangValidator exited with code ${code}` );
+        }
+    });
+}
+
+
+/**
+ * Remaps one in-memory SPIR-V module on a persistent spirv-remap (--server mode) process.
+ *
+ * The request frame holds the module; the response frame holds a status word (0 on success) followed by either the
+ * remapped module or the error text (see spirv-remap usage).
+ *
+ * @param {Buffer} spirv The SPIR-V module.
+ * @param {Array} args The spirv-remap options.
+ * @return {Promise} Fulfilled with the remapped module (a Buffer); rejected if remapping fails.
+ */
+function spirvRemapPersistentAsync( spirv, args ) {
+
+    return getPersistentPool( 'spirv-remap', args ).requestAsync( spirv )
+    .then( response => {
+
+        const status = response.readUInt32LE( 0 );
+        const payload = response.slice( 4 );
+
+        if ( status !== 0 ) {
+            throw new Error( `spirv-remap failed: ${payload.toString()}` );
+        }
+
+        return payload;
+    });
+}
+
 
 /**
  * @exports node-glsl-compiler.standalone
@@ -49,6 +163,7 @@ module.exports.standalone = {
      * * `quiet` __(optional)__ _Boolean_ -- if true, the child process stdout and stderr will NOT be written to the parent process streams (_default: false_).
      * * `stdout` __(optional)__ _Function_ -- a callback that receives a {@linkcode Buffer} parameter whenever the child process writes data to stdout.
      * * `stderr` __(optional)__ _Function_ -- a callback that receives a {@linkcode Buffer} parameter whenever the child process writes data to stderr.
+     * * `persistent` __(optional)__ _Boolean_ -- if true, the arguments are run by one of a small pool of long-running glslangValidator processes rather than a freshly spawned one, saving process start-up and glslang initialization on every call. The child process output is delivered in one piece once the run completes (_default: false_).
      * @param {Function} cb A node-style callback function in the form `cb( error )`.
      * @example <caption>Basic example:</caption>
      * // terminal equivalent (create SPIR-V binary under GL semantics, output to vert.spv, input pass.vert):
@@ -87,6 +202,13 @@ module.exports.standalone = {
      *             // success
      *         }
      *     });
+     * @example <caption>Reuse a persistent process for many compiles:</caption>
+     * const compiler = require( 'node-glsl-compiler' );
+     * shaders.forEach( shader => {
+     *     compiler.standalone.glslangValidatorAsync( { args: ['-V', '-o', `${shader}.spv`, shader], persistent: true }, err => {
+     *         // ...
+     *     });
+     * });
      * @see {@link https://www.khronos.org/opengles/sdk/tools/Reference-Compiler/}
      * @see {@link https://github.com/KhronosGroup/glslang}
      * @public
@@ -97,7 +219,11 @@ module.exports.standalone = {
         assert.object( options, 'The first argument is expected to be an options hash.' );
         assert.func( cb, 'The second argument is expected to be a callback function.' );
 
-        spawnAsync( path.join( kStandAlonePath, 'glslangValidator' ), options )
+        const promise = options.persistent ?
+            Promise.try( () => glslangValidatorPersistentAsync( options ) ) :
+            spawnAsync( path.join( kStandAlonePath, 'glslangValidator' ), options );
+
+        promise
         .then( () => cb() )
         .catch( err => cb( err ) );
     },
@@ -164,5 +290,49 @@ module.exports.standalone = {
         spawnAsync( path.join( kStandAlonePath, 'spirv-remap' ), options )
         .then( () => cb() )
         .catch( err => cb( err ) );
+    },
+
+
+    /**
+     * Asynchronously remaps an in-memory SPIR-V module using a persistent spirv-remap process.
+     *
+     * The module is streamed to one of a small pool of long-running spirv-remap processes and the result streamed
+     * back, so nothing is read from or written to disk, and process start-up is paid once per pooled process rather
+     * than once per module.
+     * @param {Buffer|Uint32Array} spirv The SPIR-V module.
+     * @param {Object} options Options hash containing the following keys:
+     * * `args` __(optional)__ _String or Array-of-strings_ -- The spirv-remap options to apply, as on the command line (_default: '--do-everything'_). Input and output options are not allowed.
+     * @param {Function} cb A node-style callback function in the form `cb( error, remapped )`, where `remapped` is a {@linkcode Buffer} holding the remapped module.
+     * @example
+     * const compiler = require( 'node-glsl-compiler' );
+     * compiler.standalone.spirvRemapModuleAsync( fs.readFileSync( 'vert.spv' ), { args: ['--strip', 'all', '--dce', 'all'] }, (err, remapped) => {
+     *     if ( err ) {
+     *         // failure
+     *     } else {
+     *         // success
+     *     }
+     * });
+     * @see {@link https://github.com/KhronosGroup/glslang/blob/master/README-spirv-remap.txt}
+     * @public
+     */
+    spirvRemapModuleAsync( spirv, options, cb ) {
+
+        if ( spirv instanceof Uint32Array ) {
+            spirv = Buffer.from( spirv.buffer, spirv.byteOffset, spirv.byteLength );
+        }
+
+        assert.buffer( spirv, 'The first argument is expected to be a Buffer or Uint32Array holding a SPIR-V module.' );
+        assert.object( options, 'The second argument is expected to be an options hash.' );
+        assert.func( cb, 'The third argument is expected to be a callback function.' );
+
+        let args = options.args || ['--do-everything'];
+        if ( ! Array.isArray( args ) ) {
+            args = [ args ];
+        }
+        assert.arrayOfString( args, 'If the optional "args" key is provided in the options hash, the value must be a string or an array-of-strings value.' );
+
+        Promise.try( () => spirvRemapPersistentAsync( spirv, args ) )
+        .then( remapped => cb( null, remapped ) )
+        .catch( err => cb( err ) );
     }
 };
@@ -7,12 +7,21 @@ jest.autoMockOff();
 jest.mock( './lib/spawnProcessAsync.js' );
 jest.mock( 'node-cmake' );
 jest.mock( 'async-exit-hook' );
+jest.mock( './lib/PersistentProcessPool.js', () => {
+    const requestAsync = jest.fn();
+    const PersistentProcessPool = jest.fn( () => { return { requestAsync, close: jest.fn() }; } );
+    PersistentProcessPool.requestAsync = requestAsync;
+    return PersistentProcessPool;
+});
 
 
 require( 'node-cmake' ).mockImplementation( () => { return {}; } );
 
 const compiler = require( './index.js' );
 const spawnProcessAsyncMock = require( './lib/spawnProcessAsync.js' );
+const PersistentProcessPoolMock = require( './lib/PersistentProcessPool.js' );
+const ProcessError = require( './lib/ProcessError.js' );
+const Promise = require( 'bluebird' );
 
 
 function installSpawnMockForSuccess( cb ) {
@@ -119,6 +128,58 @@ describe( 'node-glsl-compiler.standalone.glslangValidatorAsync', () => {
 });
 
 
+describe( 'node-glsl-compiler.standalone.glslangValidatorAsync (persistent)', () => {
+
+    function validatorResponse( code, stdout, stderr ) {
+        const out = Buffer.from( stdout );
+        const err = Buffer.from( stderr );
+        const response = Buffer.alloc( 12 + out.length + err.length );
+        response.writeUInt32LE( code, 0 );
+        response.writeUInt32LE( out.length, 4 );
+        out.copy( response, 8 );
+        response.writeUInt32LE( err.length, 8 + out.length );
+        err.copy( response, 12 + out.length );
+        return response;
+    }
+
+    it( 'sends the arguments to a persistent glslangValidator process', cb => {
+
+        PersistentProcessPoolMock.requestAsync.mockImplementationOnce( () => Promise.resolve( validatorResponse( 0, 'out', '' ) ) );
+
+        const stdout = jest.fn();
+
+        compiler.standalone.glslangValidatorAsync( { args: ['-V', 'pass.vert'], persistent: true, quiet: true, stdout }, err => {
+            expect( err ).toBeFalsy();
+            expect( PersistentProcessPoolMock ).toHaveBeenCalledWith( jasmine.stringMatching( /glslangValidator/ ), ['--server'], jasmine.any( Number ) );
+            expect( PersistentProcessPoolMock.requestAsync ).toHaveBeenCalledWith( Buffer.from( '-V\0pass.vert\0' ) );
+            expect( stdout ).toHaveBeenCalledWith( Buffer.from( 'out' ) );
+            cb();
+        });
+    });
+
+    it( 'calls the callback with a ProcessError for a non-zero exit code', cb => {
+
+        PersistentProcessPoolMock.requestAsync.mockImplementationOnce( () => Promise.resolve( validatorResponse( 2, '', 'errors' ) ) );
+
+        const stderr = jest.fn();
+
+        compiler.standalone.glslangValidatorAsync( { args: 'fail.frag', persistent: true, quiet: true, stderr }, err => {
+            expect( err ).toEqual( jasmine.any( ProcessError ) );
+            expect( err.code ).toEqual( 2 );
+            expect( stderr ).toHaveBeenCalledWith( Buffer.from( 'errors' ) );
+            cb();
+        });
+    });
+
+    it( 'calls the callback with an error when no arguments are provided', cb => {
+        compiler.standalone.glslangValidatorAsync( { persistent: true, quiet: true }, err => {
+            expect( err ).toEqual( jasmine.any( Error ) );
+            cb();
+        });
+    });
+});
+
+
 describe( 'node-glsl-compiler.standalone.spirvRemapAsync', () => {
 
     it( 'is a function', () => {
@@ -176,3 +237,52 @@ describe( 'node-glsl-compiler.standalone.spirvRemapAsync', () => {
         expect( cbMock.mock.calls[1] ).toEqual( [err] );
     });
 });
+
+
+describe( 'node-glsl-compiler.standalone.spirvRemapModuleAsync', () => {
+
+    function remapResponse( status, payload ) {
+        const response = Buffer.alloc( 4 + payload.length );
+        response.writeUInt32LE( status, 0 );
+        payload.copy( response, 4 );
+        return response;
+    }
+
+    it( 'is a function', () => {
+        expect( compiler.standalone.spirvRemapModuleAsync ).toEqual( jasmine.any( Function ) );
+    });
+
+    it( 'validates its arguments', () => {
+        const cb = () => {};
+        expect( () => compiler.standalone.spirvRemapModuleAsync( 'not a module', {}, cb ) ).toThrow();
+        expect( () => compiler.standalone.spirvRemapModuleAsync( Buffer.alloc( 4 ), undefined, cb ) ).toThrow();
+        expect( () => compiler.standalone.spirvRemapModuleAsync( Buffer.alloc( 4 ), {} ) ).toThrow();
+    });
+
+    it( 'sends the module to a persistent spirv-remap process and returns the remapped module', cb => {
+
+        const module = new Uint32Array( [0x07230203, 0x00010000, 0, 1, 0] );
+        const remapped = Buffer.from( [1, 2, 3, 4] );
+
+        PersistentProcessPoolMock.requestAsync.mockImplementationOnce( () => Promise.resolve( remapResponse( 0, remapped ) ) );
+
+        compiler.standalone.spirvRemapModuleAsync( module, { args: ['--strip', 'all'] }, (err, result) => {
+            expect( err ).toBeFalsy();
+            expect( result ).toEqual( remapped );
+            expect( PersistentProcessPoolMock ).toHaveBeenCalledWith( jasmine.stringMatching( /spirv-remap/ ), ['--server', '--strip', 'all'], jasmine.any( Number ) );
+            expect( PersistentProcessPoolMock.requestAsync ).toHaveBeenCalledWith( Buffer.from( module.buffer ) );
+            cb();
+        });
+    });
+
+    it( 'calls the callback with an error when remapping fails', cb => {
+
+        PersistentProcessPoolMock.requestAsync.mockImplementationOnce( () => Promise.resolve( remapResponse( 5, Buffer.from( 'bad magic number' ) ) ) );
+
+        compiler.standalone.spirvRemapModuleAsync( Buffer.alloc( 20 ), {}, err => {
+            expect( err ).toEqual( jasmine.any( Error ) );
+            expect( err.message ).toEqual( jasmine.stringMatching( /bad magic number/ ) );
+            cb();
+        });
+    });
+});
@@ -0,0 +1,237 @@
+'use strict';
+
+// Core node modules
+const spawn = require( 'child_process' ).spawn;
+
+// Public NPM modules
+const assert = require( 'assert-plus' );
+const Promise = require( 'bluebird' );
+
+// Local modules
+const ProcessError = require( './ProcessError.js' );
+
+require( './polyfill.js' );
+
+
+const kFrameHeaderLength = 4; // 32-bit little-endian byte count
+
+
+/**
+ * A pool of long-running child processes that exchange length-prefixed frames over stdin/stdout.
+ *
+ * Each frame is a 32-bit little-endian byte count followed by that many bytes of payload. Every request frame
+ * written to a process is answered by exactly one response frame; a process handles one request at a time, and
+ * requests beyond the pool size are queued until a process becomes free. Writing an empty frame (or closing stdin)
+ * asks a process to exit.
+ *
+ * Idle processes don't keep the node event loop alive.
+ */
+class PersistentProcessPool {
+
+    /**
+     * Constructs a new instance of the {@link PersistentProcessPool} class. No processes are spawned until the
+     * first request.
+     *
+     * @param {String} pathToBinary The executable to spawn.
+     * @param {Array} args The arguments that put the executable into its persistent (server) mode.
+     * @param {Number} maxProcesses The maximum number of processes to keep alive.
+     */
+    constructor( pathToBinary, args, maxProcesses ) {
+
+        assert.string( pathToBinary, 'The first argument must be a string path to the executable to spawn' );
+        assert.arrayOfString( args, 'The second argument must be an array-of-strings' );
+        assert.number( maxProcesses, 'The third argument must be a number' );
+        assert( maxProcesses >= 1, 'The pool must allow at least one process' );
+
+        this._pathToBinary = pathToBinary;
+        this._args = args;
+        this._maxProcesses = maxProcesses;
+
+        this._processes = [];
+        this._idle = [];
+        this._queue = [];
+        this._closed = false;
+    }
+
+
+    /**
+     * Sends a request frame to a pooled process.
+     *
+     * @param {Buffer} payload The request payload (without the length prefix).
+     * @return {Promise} A promise fulfilled with the response payload (a {@linkcode Buffer}, without the length
+     *                   prefix), or rejected with a {@link ProcessError} if the process dies before responding.
+     */
+    requestAsync( payload ) {
+
+        return new Promise( (resolve, reject) => {
+
+            assert.buffer( payload, 'The request payload must be a Buffer' );
+            assert( ! this._closed, 'The pool has been closed' );
+            assert( payload.length > 0, 'The request payload must not be empty (an empty frame stops the process)' );
+
+            const request = { payload, resolve, reject };
+
+            if ( this._idle.length > 0 ) {
+                this._send( this._idle.pop(), request );
+            } else if ( this._processes.length < this._maxProcesses ) {
+                this._send( this._spawn(), request );
+            } else {
+                this._queue.push( request );
+            }
+        });
+    }
+
+
+    /**
+     * Asks every pooled process to exit, and rejects any queued requests. Requests already in flight still
+     * complete. The pool can't be used afterwards.
+     */
+    close() {
+
+        this._closed = true;
+
+        const queue = this._queue;
+        this._queue = [];
+        queue.forEach( request => request.reject( new Error( 'The process pool was closed' ) ) );
+
+        this._processes.forEach( worker => worker.proc.stdin.end() );
+        this._idle = [];
+    }
+
+
+    _spawn() {
+
+        const proc = spawn( this._pathToBinary, this._args );
+
+        const worker = {
+            proc,
+            received: Buffer.alloc( 0 ),
+            request: null,
+            error: null
+        };
+
+        this._processes.push( worker );
+
+        proc.stdout.on( 'data', buffer => this._receive( worker, buffer ) );
+
+        // the server reports per-request output inside its responses; anything else on stderr is a crash report
+        /* istanbul ignore next */
+        proc.stderr.on( 'data', buffer => process.stderr.write( buffer ) );
+
+        // writes to a process that has died are reported through 'close'
+        proc.stdin.on( 'error', () => {} );
+
+        proc.on( 'error', err => {
+            worker.error = err;
+        });
+
+        proc.on( 'close', (code, signal) => this._retire( worker, code, signal ) );
+
+        return worker;
+    }
+
+
+    _send( worker, request ) {
+
+        worker.request = request;
+
+        // keep the event loop alive while a response is outstanding
+        this._setRef( worker, true );
+
+        const header = Buffer.alloc( kFrameHeaderLength );
+        header.writeUInt32LE( request.payload.length, 0 );
+
+        worker.proc.stdin.write( header );
+        worker.proc.stdin.write( request.payload );
+    }
+
+
+    _receive( worker, buffer ) {
+
+        worker.received = Buffer.concat( [worker.received, buffer] );
+
+        while ( worker.received.length >= kFrameHeaderLength ) {
+
+            const length = worker.received.readUInt32LE( 0 );
+            if ( worker.received.length < kFrameHeaderLength + length ) {
+                break;
+            }
+
+            const response = worker.received.slice( kFrameHeaderLength, kFrameHeaderLength + length );
+            worker.received = worker.received.slice( kFrameHeaderLength + length );
+
+            const request = worker.request;
+            worker.request = null;
+
+            if ( request ) {
+                request.resolve( response );
+            }
+
+            this._release( worker );
+        }
+    }
+
+
+    _release( worker ) {
+
+        if ( this._queue.length > 0 ) {
+            this._send( worker, this._queue.shift() );
+            return;
+        }
+
+        this._setRef( worker, false );
+
+        if ( this._closed ) {
+            worker.proc.stdin.end();
+        } else {
+            this._idle.push( worker );
+        }
+    }
+
+
+    _retire( worker, code, signal ) {
+
+        this._processes = this._processes.filter( w => w !== worker );
+        this._idle = this._idle.filter( w => w !== worker );
+
+        const request = worker.request;
+        worker.request = null;
+
+        if ( request ) {
+
+            // a clean exit with a request outstanding is still a failure
+            if ( ! code && ! signal ) {
+                code = 1;
+            }
+
+            if ( worker.error ) {
+                request.reject( new ProcessError( code, signal, `Failure spawning or terminating ${this._pathToBinary}: ${worker.error.message}\n${worker.error.stack}` ) );
+            } else if ( signal ) {
+                request.reject( new ProcessError( code, signal, `Process ${this._pathToBinary} terminated by signal ${signal}` ) );
+            } else {
+                request.reject( new ProcessError( code, signal, `Process ${this._pathToBinary} exited with code ${code}` ) );
+            }
+        }
+
+        // hand queued work to a replacement process
+        if ( this._queue.length > 0 && ! this._closed ) {
+            this._send( this._spawn(), this._queue.shift() );
+        }
+    }
+
+
+    _setRef( worker, ref ) {
+
+        const method = ref ? 'ref' : 'unref';
+
+        [ worker.proc, worker.proc.stdin, worker.proc.stdout, worker.proc.stderr ].forEach( handle => {
+            /* istanbul ignore else */
+            if ( handle && typeof handle[ method ] === 'function' ) {
+                handle[ method ]();
+            }
+        });
+    }
+}
+
+
+module.exports = PersistentProcessPool;
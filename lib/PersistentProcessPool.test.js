@@ -0,0 +1,177 @@
+'use strict';
+
+/* eslint-disable require-jsdoc */
+
+jest.autoMockOff();
+
+jest.mock( 'child_process' );
+const spawn = require( 'child_process' ).spawn;
+
+const EventEmitter = require( 'events' ).EventEmitter;
+const Promise = require( 'bluebird' );
+const ProcessError = require( './ProcessError.js' );
+const PersistentProcessPool = require( './PersistentProcessPool.js' );
+
+
+function frame( payload ) {
+    const header = Buffer.alloc( 4 );
+    header.writeUInt32LE( payload.length, 0 );
+    return Buffer.concat( [header, payload] );
+}
+
+
+describe( 'PersistentProcessPool', () => {
+
+    let procs;
+
+    beforeEach( () => {
+        procs = [];
+
+        spawn.mockReset();
+        spawn.mockImplementation( () => {
+            const proc = new EventEmitter();
+            proc.written = [];
+            proc.stdin = new EventEmitter();
+            proc.stdin.write = jest.fn( buffer => proc.written.push( buffer ) );
+            proc.stdin.end = jest.fn();
+            proc.stdout = new EventEmitter();
+            proc.stderr = new EventEmitter();
+            procs.push( proc );
+            return proc;
+        });
+    });
+
+    it( 'is a class', () => {
+        expect( PersistentProcessPool ).toEqual( jasmine.any( Function ) );
+        expect( new PersistentProcessPool( 'test', ['--server'], 1 ) ).toEqual( jasmine.any( PersistentProcessPool ) );
+    });
+
+    it( 'validates its constructor arguments', () => {
+        expect( () => new PersistentProcessPool( undefined, [], 1 ) ).toThrow();
+        expect( () => new PersistentProcessPool( 'test', 'not an array', 1 ) ).toThrow();
+        expect( () => new PersistentProcessPool( 'test', [], 0 ) ).toThrow();
+    });
+
+    it( 'does not spawn until the first request', () => {
+        new PersistentProcessPool( 'test', ['--server'], 2 );
+        expect( spawn ).not.toHaveBeenCalled();
+    });
+
+    it( 'rejects an empty request payload', () => {
+        const pool = new PersistentProcessPool( 'test', ['--server'], 1 );
+        return pool.requestAsync( Buffer.alloc( 0 ) )
+        .then( () => fail( 'should not have been called' ) )
+        .catch( err => {
+            expect( err ).toEqual( jasmine.any( Error ) );
+            expect( spawn ).not.toHaveBeenCalled();
+        });
+    });
+
+    it( 'writes the request as a length-prefixed frame and resolves with the response payload', () => {
+        const pool = new PersistentProcessPool( 'test', ['--server'], 1 );
+        const promise = pool.requestAsync( Buffer.from( 'abc' ) );
+
+        expect( spawn ).toHaveBeenCalledWith( 'test', ['--server'] );
+        expect( Buffer.concat( procs[0].written ) ).toEqual( frame( Buffer.from( 'abc' ) ) );
+
+        // deliver the response split across chunks
+        const response = frame( Buffer.from( 'response' ) );
+        procs[0].stdout.emit( 'data', response.slice( 0, 3 ) );
+        procs[0].stdout.emit( 'data', response.slice( 3 ) );
+
+        return promise.then( payload => {
+            expect( payload.toString() ).toEqual( 'response' );
+        });
+    });
+
+    it( 'reuses an idle process', () => {
+        const pool = new PersistentProcessPool( 'test', ['--server'], 2 );
+
+        const first = pool.requestAsync( Buffer.from( '1' ) );
+        procs[0].stdout.emit( 'data', frame( Buffer.from( 'a' ) ) );
+
+        return first.then( () => {
+            const second = pool.requestAsync( Buffer.from( '2' ) );
+            expect( procs.length ).toBe( 1 );
+            procs[0].stdout.emit( 'data', frame( Buffer.from( 'b' ) ) );
+            return second;
+        })
+        .then( payload => {
+            expect( payload.toString() ).toEqual( 'b' );
+        });
+    });
+
+    it( 'spawns up to the maximum number of processes, then queues', () => {
+        const pool = new PersistentProcessPool( 'test', ['--server'], 2 );
+
+        const promises = [ '1', '2', '3' ].map( s => pool.requestAsync( Buffer.from( s ) ) );
+        expect( procs.length ).toBe( 2 );
+        expect( procs[0].written.length ).toBe( 2 );
+        expect( procs[1].written.length ).toBe( 2 );
+
+        // the queued request goes to the first process to respond
+        procs[1].stdout.emit( 'data', frame( Buffer.from( 'b' ) ) );
+        expect( Buffer.concat( procs[1].written.slice( 2 ) ) ).toEqual( frame( Buffer.from( '3' ) ) );
+
+        procs[0].stdout.emit( 'data', frame( Buffer.from( 'a' ) ) );
+        procs[1].stdout.emit( 'data', frame( Buffer.from( 'c' ) ) );
+
+        return Promise.all( promises ).then( payloads => {
+            expect( payloads.map( p => p.toString() ) ).toEqual( ['a', 'b', 'c'] );
+        });
+    });
+
+    it( 'rejects the in-flight request with a ProcessError if the process exits', () => {
+        const pool = new PersistentProcessPool( 'test', ['--server'], 1 );
+        const promise = pool.requestAsync( Buffer.from( '1' ) );
+
+        procs[0].emit( 'close', null, 'SIGSEGV' );
+
+        return promise
+        .then( () => fail( 'should not have been called' ) )
+        .catch( err => {
+            expect( err ).toEqual( jasmine.any( ProcessError ) );
+            expect( err.signal ).toEqual( 'SIGSEGV' );
+        });
+    });
+
+    it( 'replaces a process that exits while requests are queued', () => {
+        const pool = new PersistentProcessPool( 'test', ['--server'], 1 );
+        const first = pool.requestAsync( Buffer.from( '1' ) );
+        const second = pool.requestAsync( Buffer.from( '2' ) );
+
+        procs[0].emit( 'close', 1, null );
+        expect( procs.length ).toBe( 2 );
+        procs[1].stdout.emit( 'data', frame( Buffer.from( 'b' ) ) );
+
+        return first
+        .then( () => fail( 'should not have been called' ) )
+        .catch( err => {
+            expect( err ).toEqual( jasmine.any( ProcessError ) );
+            expect( err.code ).toEqual( 1 );
+            return second;
+        })
+        .then( payload => {
+            expect( payload.toString() ).toEqual( 'b' );
+        });
+    });
+
+    it( 'closes idle processes and rejects queued requests on close()', () => {
+        const pool = new PersistentProcessPool( 'test', ['--server'], 1 );
+        const first = pool.requestAsync( Buffer.from( '1' ) );
+        const second = pool.requestAsync( Buffer.from( '2' ) )
+        .then( () => fail( 'should not have been called' ) )
+        .catch( err => {
+            expect( err ).toEqual( jasmine.any( Error ) );
+            expect( err.message ).toEqual( jasmine.stringMatching( /closed/ ) );
+        });
+
+        pool.close();
+        expect( procs[0].stdin.end ).toHaveBeenCalled();
+        procs[0].stdout.emit( 'data', frame( Buffer.from( 'a' ) ) );
+
+        return Promise.all( [first, second] ).then( results => {
+            expect( results[0].toString() ).toEqual( 'a' );
+        });
+    });
+});
@@ -1,21 +1,51 @@
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include <nan.h>
 
+#include "glslang/OGLCompilersDLL/InitializeDll.h"
+#include "glslang/SPIRV/SPVRemapper.h"
+
 #include "NanUtils.h"
 #include "GLSLangUtils.h"
+#include "SpirvUtils.h"
+#include "RemapWorker.h"
+#include "BatchRemapWorker.h"
+#include "CompileTarget.h"
+#include "DiagnosticUtils.h"
+#include "Options.h"
+#include "ProgramCompiler.h"
+#include "ReflectionUtils.h"
+#include "ShaderCompiler.h"
+#include "TypedArrayUtils.h"
+#include "VersionHintUtils.h"
 #include "TaskWorker.h"
 #include "TaskQueueThread.h"
 #include "Trampoline.h"
 #include "WorkItem.h"
 #include "WorkList.h"
+#include "WorkerPool.h"
 
 namespace NodeGLSLCompiler {
 
     static TaskQueueThread g_taskQueue;
     static WorkList g_workList;
 
+    // Parses and links for compileProgramsAsync alongside the glslang thread, which takes a share of the work; the
+    // threads are set up for glslang once, and release their glslang state as they exit
+    static WorkerPool g_compilePool(
+        Options().maxProgramThreads - 1,
+        [] { glslang::InitThread(); },
+        [] { glslang::DetachThread(); } );
+
+    // Shared by every remapBatchAsync call, so batches reuse threads rather than each starting its own; the libuv
+    // thread running a batch takes a share of the work, hence one fewer than maxRemapThreads
+    static WorkerPool g_remapPool( Options().maxRemapThreads - 1 );
+
 
     // Exported, but not intended for use outside the node-glslang module
     NAN_METHOD( private_finalizeProcess ) {
@@ -34,7 +64,10 @@ namespace NodeGLSLCompiler {
         // Cancel work and run finalization on the glslang thread
         auto future = g_taskQueue.signalExit(
             true, // remove existing tasks
-            [] { glslang::FinalizeProcess(); } );
+            [] {
+                g_compilePool.shutdown();
+                glslang::FinalizeProcess();
+            } );
 
         // Spin off a sync wait on the future, and trigger (on the v8 thread) the callback we were provided when the
         // promise connected to the future is fulfilled
@@ -45,6 +78,464 @@ namespace NodeGLSLCompiler {
     }
 
 
+    /**
+     * Compiles a shader for one or more targets on the glslang thread:
+     * compileAsync( source, stage, targets, [options,] callback ).
+     *
+     * The source is parsed once per distinct target, and every result for that target is emitted from the same
+     * intermediate.
+     *
+     * @param source The GLSL source string.
+     * @param stage One of the STAGE values.
+     * @param targets An array of TARGET values; if undefined, [ TARGET.VULKAN ].
+     * @param options (optional) { suppressWarnings: Boolean, versionHint: Object }, or undefined for the defaults.
+     *                suppressWarnings skips the optional warnings without formatting them (only those the specification
+     *                requires are still reported). versionHint is the { version, profile, notFirst } #version directive
+     *                the source opens with, when the caller already knows it (e.g., the versionHint of an earlier
+     *                result for the same source); the source then isn't scanned for it ahead of parsing. The hint is
+     *                trusted, not checked against the source (see Utils::getVersionHint).
+     * @param callback Invoked with (err, results), where results holds one
+     *                 { target: Number, success: Boolean, log: String, diagnostics: Array, versionHint: Object,
+     *                 spirv: Uint32Array, reflection: Object } per requested target, in order; err is only set if the
+     *                 compile couldn't be attempted (a shader that fails to compile has success === false, and no
+     *                 spirv or reflection; VALIDATION results never have spirv). diagnostics holds the compile errors
+     *                 and warnings that log has as text; versionHint is absent if tokens came before the #version
+     *                 directive. See Utils::newDiagnosticsArray, Utils::newVersionHintObject, and
+     *                 Utils::newReflectionObject for the shapes of diagnostics, versionHint, and reflection.
+     */
+    NAN_METHOD( compileAsync ) {
+
+        if ( info.Length() != 4 && info.Length() != 5 ) {
+            Nan::ThrowTypeError( "Expected four or five arguments" );
+            return;
+        }
+
+        const int callbackIndex = info.Length() - 1;
+
+        if ( ! info[ 0 ]->IsString() ) {
+            Nan::ThrowTypeError( "Expected first argument to be a source string" );
+            return;
+        }
+
+        if ( ! info[ 1 ]->IsUint32() || Nan::To<std::uint32_t>( info[ 1 ] ).FromJust() >= EShLangCount ) {
+            Nan::ThrowTypeError( "Expected second argument to be a STAGE value" );
+            return;
+        }
+
+        if ( ! info[ 2 ]->IsUndefined() && ! info[ 2 ]->IsArray() ) {
+            Nan::ThrowTypeError( "Expected third argument to be an array of TARGET values, or undefined" );
+            return;
+        }
+
+        if ( callbackIndex == 4 && ! info[ 3 ]->IsUndefined() && ! info[ 3 ]->IsObject() ) {
+            Nan::ThrowTypeError( "Expected fourth argument to be an options object, or undefined" );
+            return;
+        }
+
+        if ( ! info[ callbackIndex ]->IsFunction() ) {
+            Nan::ThrowTypeError( "Expected last argument to be a callback function" );
+            return;
+        }
+
+        std::string source( *Nan::Utf8String( info[ 0 ] ) );
+        const auto stage = (EShLanguage) Nan::To<std::uint32_t>( info[ 1 ] ).FromJust();
+
+        bool suppressWarnings = false;
+        bool hasVersionHint = false;
+        glslang::TShader::VersionHint versionHint = {};
+
+        if ( callbackIndex == 4 && ! info[ 3 ]->IsUndefined() ) {
+            auto value = Nan::Get( info[ 3 ].As<v8::Object>(), _V8S("suppressWarnings") ).ToLocalChecked();
+
+            if ( ! value->IsUndefined() && ! value->IsBoolean() ) {
+                Nan::ThrowTypeError( "Expected options.suppressWarnings to be a boolean, or undefined" );
+                return;
+            }
+
+            suppressWarnings = value->IsTrue();
+
+            auto hint = Nan::Get( info[ 3 ].As<v8::Object>(), _V8S("versionHint") ).ToLocalChecked();
+
+            if ( ! hint->IsUndefined() ) {
+                if ( ! Utils::getVersionHint( hint, versionHint ) ) {
+                    Nan::ThrowTypeError( "Expected options.versionHint to be a { version, profile, notFirst } hint, or undefined" );
+                    return;
+                }
+
+                hasVersionHint = true;
+            }
+        }
+
+        std::vector<CompileTarget> targets;
+
+        if ( info[ 2 ]->IsUndefined() ) {
+            targets.push_back( CompileTarget::Vulkan );
+        } else {
+            auto array = info[ 2 ].As<v8::Array>();
+
+            for ( uint32_t i = 0; i < array->Length(); i++ ) {
+                auto element = Nan::Get( array, i ).ToLocalChecked();
+
+                if ( ! element->IsUint32() || Nan::To<std::uint32_t>( element ).FromJust() > (std::uint32_t) CompileTarget::Validation ) {
+                    Nan::ThrowTypeError( "Expected every target to be a TARGET value" );
+                    return;
+                }
+
+                targets.push_back( (CompileTarget) Nan::To<std::uint32_t>( element ).FromJust() );
+            }
+        }
+
+        // Deleted by the bounced task, as it must only be touched on the v8 thread
+        auto callback = new Nan::Callback( info[ callbackIndex ].As<v8::Function>() );
+
+        // Pins the event loop until the result is delivered
+        auto trampoline = std::make_shared<Trampoline>( uv_default_loop() );
+
+        g_taskQueue.performOnThread( [source, stage, targets, suppressWarnings, hasVersionHint, versionHint, callback, trampoline] {
+
+            auto results = std::make_shared< std::vector<CompileResult> >();
+            ShaderCompiler( Options( Options::kDefaultESShaderVersion, suppressWarnings ) )
+                .compile( source, stage, targets, hasVersionHint ? &versionHint : nullptr, *results );
+
+            trampoline->bounce( [callback, results] {
+                Nan::HandleScope scope;
+
+                auto array = Nan::New<v8::Array>( (int) results->size() );
+
+                for ( std::size_t i = 0; i < results->size(); i++ ) {
+                    CompileResult& result = ( *results )[ i ];
+
+                    auto object = Nan::New<v8::Object>();
+                    Nan::Set( object, _V8S("target"), Nan::New<v8::Number>( (int) result.target ) );
+                    Nan::Set( object, _V8S("success"), Nan::New<v8::Boolean>( result.success ) );
+                    Nan::Set( object, _V8S("log"), _V8S( result.log ) );
+                    Nan::Set( object, _V8S("diagnostics"), Utils::newDiagnosticsArray( *result.diagnostics ) );
+
+                    if ( result.hasVersionHint ) {
+                        Nan::Set( object, _V8S("versionHint"), Utils::newVersionHintObject( result.versionHint ) );
+                    }
+
+                    if ( result.spirv ) {
+                        Nan::Set( object, _V8S("spirv"),
+                            Utils::newUint32Array( std::move( result.spirv ), result.spirvSizeInWords ) );
+                    }
+
+                    if ( result.reflection ) {
+                        Nan::Set( object, _V8S("reflection"), Utils::newReflectionObject( *result.reflection ) );
+                    }
+
+                    Nan::Set( array, (uint32_t) i, object );
+                }
+
+                v8::Local<v8::Value> argv[] = { Nan::Null(), array };
+                callback->Call( 2, argv );
+
+                delete callback;
+            });
+        });
+    }
+
+
+    /**
+     * Compiles and links a batch of programs: compileProgramsAsync( programs, target, [options,] callback ).
+     *
+     * Each distinct stage is parsed and linked once and shared by the programs that use it, and the programs are
+     * linked concurrently (see ProgramCompiler). Linking checks each stage's outputs against the inputs of the next
+     * stage in the pipeline: they're matched by location, or else by name, and must have the same type, and every
+     * input a stage reads must be written by the stage before it.
+     *
+     * @param programs An array of programs, each an array of { source: String, stage: Number, preamble: String,
+     *                 defaultVersion: Number, versionHint: Object } stages (preamble, defaultVersion, and versionHint
+     *                 are optional). Stages with equal source, stage, preamble, defaultVersion, and versionHint are
+     *                 only compiled once. versionHint is the trusted #version directive the source opens with, as for compileAsync;
+     *                 without one, each distinct source text is scanned for it once per batch.
+     * @param target A TARGET value; if undefined, TARGET.VULKAN.
+     * @param options (optional) { suppressWarnings: Boolean }, or undefined for the defaults; suppressWarnings is as
+     *                for compileAsync, and applies to every stage and link.
+     * @param callback Invoked with (err, results), where results holds one { success: Boolean, log: String } per
+     *                 program, in order.
+     */
+    NAN_METHOD( compileProgramsAsync ) {
+
+        if ( info.Length() != 3 && info.Length() != 4 ) {
+            Nan::ThrowTypeError( "Expected three or four arguments" );
+            return;
+        }
+
+        const int callbackIndex = info.Length() - 1;
+
+        if ( ! info[ 0 ]->IsArray() ) {
+            Nan::ThrowTypeError( "Expected first argument to be an array of programs" );
+            return;
+        }
+
+        if ( ! info[ 1 ]->IsUndefined() &&
+             ( ! info[ 1 ]->IsUint32() || Nan::To<std::uint32_t>( info[ 1 ] ).FromJust() > (std::uint32_t) CompileTarget::Validation ) ) {
+            Nan::ThrowTypeError( "Expected second argument to be a TARGET value, or undefined" );
+            return;
+        }
+
+        if ( callbackIndex == 3 && ! info[ 2 ]->IsUndefined() && ! info[ 2 ]->IsObject() ) {
+            Nan::ThrowTypeError( "Expected third argument to be an options object, or undefined" );
+            return;
+        }
+
+        if ( ! info[ callbackIndex ]->IsFunction() ) {
+            Nan::ThrowTypeError( "Expected last argument to be a callback function" );
+            return;
+        }
+
+        bool suppressWarnings = false;
+
+        if ( callbackIndex == 3 && ! info[ 2 ]->IsUndefined() ) {
+            auto value = Nan::Get( info[ 2 ].As<v8::Object>(), _V8S("suppressWarnings") ).ToLocalChecked();
+
+            if ( ! value->IsUndefined() && ! value->IsBoolean() ) {
+                Nan::ThrowTypeError( "Expected options.suppressWarnings to be a boolean, or undefined" );
+                return;
+            }
+
+            suppressWarnings = value->IsTrue();
+        }
+
+
+        auto array = info[ 0 ].As<v8::Array>();
+        auto programs = std::make_shared< std::vector< std::vector<StageSource> > >( array->Length() );
+
+        for ( uint32_t p = 0; p < array->Length(); p++ ) {
+            auto program = Nan::Get( array, p ).ToLocalChecked();
+
+            if ( ! program->IsArray() ) {
+                Nan::ThrowTypeError( "Expected every program to be an array of stages" );
+                return;
+            }
+
+            auto stages = program.As<v8::Array>();
+
+            for ( uint32_t s = 0; s < stages->Length(); s++ ) {
+                auto stage = Nan::Get( stages, s ).ToLocalChecked();
+
+                if ( ! stage->IsObject() ) {
+                    Nan::ThrowTypeError( "Expected every stage to be a { source, stage } object" );
+                    return;
+                }
+
+                auto source = Nan::Get( stage.As<v8::Object>(), _V8S("source") ).ToLocalChecked();
+                auto language = Nan::Get( stage.As<v8::Object>(), _V8S("stage") ).ToLocalChecked();
+                auto preamble = Nan::Get( stage.As<v8::Object>(), _V8S("preamble") ).ToLocalChecked();
+                auto defaultVersion = Nan::Get( stage.As<v8::Object>(), _V8S("defaultVersion") ).ToLocalChecked();
+                auto hint = Nan::Get( stage.As<v8::Object>(), _V8S("versionHint") ).ToLocalChecked();
+
+                if ( ! source->IsString() ) {
+                    Nan::ThrowTypeError( "Expected stage.source to be a string" );
+                    return;
+                }
+
+                if ( ! language->IsUint32() || Nan::To<std::uint32_t>( language ).FromJust() >= EShLangCount ) {
+                    Nan::ThrowTypeError( "Expected stage.stage to be a STAGE value" );
+                    return;
+                }
+
+                if ( ! preamble->IsUndefined() && ! preamble->IsString() ) {
+                    Nan::ThrowTypeError( "Expected stage.preamble to be a string, or undefined" );
+                    return;
+                }
+
+                if ( ! defaultVersion->IsUndefined() && ! defaultVersion->IsUint32() ) {
+                    Nan::ThrowTypeError( "Expected stage.defaultVersion to be a version number, or undefined" );
+                    return;
+                }
+
+                glslang::TShader::VersionHint versionHint = {};
+
+                if ( ! hint->IsUndefined() && ! Utils::getVersionHint( hint, versionHint ) ) {
+                    Nan::ThrowTypeError( "Expected stage.versionHint to be a { version, profile, notFirst } hint, or undefined" );
+                    return;
+                }
+
+                ( *programs )[ p ].push_back( StageSource {
+                    std::string( *Nan::Utf8String( source ) ),
+                    (EShLanguage) Nan::To<std::uint32_t>( language ).FromJust(),
+                    preamble->IsUndefined() ? std::string() : std::string( *Nan::Utf8String( preamble ) ),
+                    defaultVersion->IsUndefined()
+                        ? Options().defaultShaderVersion
+                        : (int) Nan::To<std::uint32_t>( defaultVersion ).FromJust(),
+                    ! hint->IsUndefined(),
+                    versionHint } );
+            }
+        }
+
+        const auto target = info[ 1 ]->IsUndefined()
+            ? CompileTarget::Vulkan
+            : (CompileTarget) Nan::To<std::uint32_t>( info[ 1 ] ).FromJust();
+
+        // Deleted by the bounced task, as it must only be touched on the v8 thread
+        auto callback = new Nan::Callback( info[ callbackIndex ].As<v8::Function>() );
+
+        // Pins the event loop until the result is delivered
+        auto trampoline = std::make_shared<Trampoline>( uv_default_loop() );
+
+        g_taskQueue.performOnThread( [programs, target, suppressWarnings, callback, trampoline] {
+
+            auto results = std::make_shared< std::vector<ProgramResult> >();
+            ProgramCompiler( Options( Options::kDefaultESShaderVersion, suppressWarnings ), target, g_compilePool )
+                .compile( *programs, *results );
+
+            trampoline->bounce( [callback, results] {
+                Nan::HandleScope scope;
+
+                auto array = Nan::New<v8::Array>( (int) results->size() );
+
+                for ( std::size_t i = 0; i < results->size(); i++ ) {
+                    const ProgramResult& result = ( *results )[ i ];
+
+                    auto object = Nan::New<v8::Object>();
+                    Nan::Set( object, _V8S("success"), Nan::New<v8::Boolean>( result.success ) );
+                    Nan::Set( object, _V8S("log"), _V8S( result.log ) );
+                    Nan::Set( array, (uint32_t) i, object );
+                }
+
+                v8::Local<v8::Value> argv[] = { Nan::Null(), array };
+                callback->Call( 2, argv );
+
+                delete callback;
+            });
+        });
+    }
+
+
+    /**
+     * Remaps a SPIR-V module on a libuv worker thread: remapAsync( spirv, options, callback ).
+     *
+     * @param spirv A Uint32Array holding the SPIR-V module (the words are copied; the array isn't retained).
+     * @param options A combination of REMAP flags; if undefined, REMAP.DO_EVERYTHING.
+     * @param callback Invoked with (err, { spirv: Uint32Array, sizeDelta: Number }), where sizeDelta is the change in
+     *                 module size in bytes (negative when the module shrank).
+     */
+    NAN_METHOD( remapAsync ) {
+
+        if ( info.Length() != 3 ) {
+            Nan::ThrowTypeError( "Expected three arguments" );
+            return;
+        }
+
+        if ( ! info[ 0 ]->IsUint32Array() || info[ 0 ].As<v8::Uint32Array>()->Length() == 0 ) {
+            Nan::ThrowTypeError( "Expected first argument to be a non-empty Uint32Array holding a SPIR-V module" );
+            return;
+        }
+
+        if ( ! info[ 1 ]->IsUndefined() && ! info[ 1 ]->IsUint32() ) {
+            Nan::ThrowTypeError( "Expected second argument to be a combination of REMAP flags, or undefined" );
+            return;
+        }
+
+        if ( ! info[ 2 ]->IsFunction() ) {
+            Nan::ThrowTypeError( "Expected third argument to be a callback function" );
+            return;
+        }
+
+        const std::uint32_t options = info[ 1 ]->IsUndefined()
+            ? spv::spirvbin_t::DO_EVERYTHING
+            : Nan::To<std::uint32_t>( info[ 1 ] ).FromJust();
+
+        RemapWorker::start( info[ 2 ].As<v8::Function>(), info[ 0 ], options );
+    }
+
+
+    /**
+     * Remaps a batch of SPIR-V modules across several threads: remapBatchAsync( modules, options, batchOptions,
+     * callback ).
+     *
+     * @param modules An array of Uint32Arrays, each holding a SPIR-V module (the words are copied).
+     * @param options A combination of REMAP flags applied to every module; if undefined, REMAP.DO_EVERYTHING.
+     * @param batchOptions undefined, or an object:
+     *                      {
+     *                          shareTypes: Boolean,    // give equal types/constants equal IDs across the batch
+     *                          maxThreads: Number      // defaults to (and is capped at) the number of hardware threads
+     *                      }
+     *                     The results don't depend on maxThreads.
+     * @param callback Invoked with (err, results), where results holds, in module order, either
+     *                 { spirv: Uint32Array, sizeDelta: Number } or { error: Error } for each module.
+     */
+    NAN_METHOD( remapBatchAsync ) {
+
+        if ( info.Length() != 4 ) {
+            Nan::ThrowTypeError( "Expected four arguments" );
+            return;
+        }
+
+        if ( ! info[ 0 ]->IsArray() ) {
+            Nan::ThrowTypeError( "Expected first argument to be an array of Uint32Arrays holding SPIR-V modules" );
+            return;
+        }
+
+        if ( ! info[ 1 ]->IsUndefined() && ! info[ 1 ]->IsUint32() ) {
+            Nan::ThrowTypeError( "Expected second argument to be a combination of REMAP flags, or undefined" );
+            return;
+        }
+
+        if ( ! info[ 2 ]->IsUndefined() && ! info[ 2 ]->IsObject() ) {
+            Nan::ThrowTypeError( "Expected third argument to be a batch options object, or undefined" );
+            return;
+        }
+
+        if ( ! info[ 3 ]->IsFunction() ) {
+            Nan::ThrowTypeError( "Expected fourth argument to be a callback function" );
+            return;
+        }
+
+
+        auto array = info[ 0 ].As<v8::Array>();
+        std::vector< std::vector<std::uint32_t> > modules( array->Length() );
+
+        for ( uint32_t i = 0; i < array->Length(); i++ ) {
+            auto element = Nan::Get( array, i ).ToLocalChecked();
+
+            if ( ! element->IsUint32Array() || element.As<v8::Uint32Array>()->Length() == 0 ) {
+                Nan::ThrowTypeError( "Expected every module to be a non-empty Uint32Array" );
+                return;
+            }
+
+            Nan::TypedArrayContents<std::uint32_t> contents( element );
+            modules[ i ].assign( *contents, *contents + contents.length() );
+        }
+
+        const std::uint32_t options = info[ 1 ]->IsUndefined()
+            ? spv::spirvbin_t::DO_EVERYTHING
+            : Nan::To<std::uint32_t>( info[ 1 ] ).FromJust();
+
+        bool shareTypes = false;
+        int maxThreads = Options().maxRemapThreads;
+
+        if ( info[ 2 ]->IsObject() ) {
+            auto batchOptions = info[ 2 ].As<v8::Object>();
+
+            auto value = Nan::Get( batchOptions, _V8S("shareTypes") ).ToLocalChecked();
+            if ( ! value->IsUndefined() ) {
+                shareTypes = Nan::To<bool>( value ).FromJust();
+            }
+
+            value = Nan::Get( batchOptions, _V8S("maxThreads") ).ToLocalChecked();
+            if ( ! value->IsUndefined() ) {
+                if ( ! value->IsUint32() || Nan::To<std::uint32_t>( value ).FromJust() == 0 ) {
+                    Nan::ThrowTypeError( "Expected batchOptions.maxThreads to be a positive integer" );
+                    return;
+                }
+                maxThreads = (int) Nan::To<std::uint32_t>( value ).FromJust();
+            }
+        }
+
+        // AsyncQueueWorker takes ownership of allocated memory
+        Nan::AsyncQueueWorker( new BatchRemapWorker(
+            new Nan::Callback( info[ 3 ].As<v8::Function>() ),
+            std::move( modules ),
+            options,
+            shareTypes,
+            g_remapPool,
+            maxThreads ) );
+    }
+
+
     NAN_MODULE_INIT( initializeModule ) {
 
         auto stages = Nan::New<v8::Object>();
@@ -59,7 +550,64 @@ namespace NodeGLSLCompiler {
         Nan::Set( target, _V8S("STAGE"), stages );
 
 
+        auto targets = Nan::New<v8::Object>();
+
+        _NAN_EXPORT_NUMBER( targets, "VULKAN", (int) CompileTarget::Vulkan );
+        _NAN_EXPORT_NUMBER( targets, "OPENGL", (int) CompileTarget::OpenGL );
+        _NAN_EXPORT_NUMBER( targets, "VALIDATION", (int) CompileTarget::Validation );
+
+        Nan::Set( target, _V8S("TARGET"), targets );
+
+
+        auto severities = Nan::New<v8::Object>();
+
+        _NAN_EXPORT_NUMBER( severities, "WARNING", (int) glslang::EPrefixWarning );
+        _NAN_EXPORT_NUMBER( severities, "ERROR", (int) glslang::EPrefixError );
+        _NAN_EXPORT_NUMBER( severities, "INTERNAL_ERROR", (int) glslang::EPrefixInternalError );
+        _NAN_EXPORT_NUMBER( severities, "UNIMPLEMENTED", (int) glslang::EPrefixUnimplemented );
+        _NAN_EXPORT_NUMBER( severities, "NOTE", (int) glslang::EPrefixNote );
+
+        Nan::Set( target, _V8S("SEVERITY"), severities );
+
+
+        auto profiles = Nan::New<v8::Object>();
+
+        _NAN_EXPORT_NUMBER( profiles, "NONE", (int) ENoProfile );
+        _NAN_EXPORT_NUMBER( profiles, "CORE", (int) ECoreProfile );
+        _NAN_EXPORT_NUMBER( profiles, "COMPATIBILITY", (int) ECompatibilityProfile );
+        _NAN_EXPORT_NUMBER( profiles, "ES", (int) EEsProfile );
+
+        Nan::Set( target, _V8S("PROFILE"), profiles );
+
+
+        auto remap = Nan::New<v8::Object>();
+
+        _NAN_EXPORT_NUMBER( remap, "STRIP", spv::spirvbin_t::STRIP );
+        _NAN_EXPORT_NUMBER( remap, "MAP_TYPES", spv::spirvbin_t::MAP_TYPES );
+        _NAN_EXPORT_NUMBER( remap, "MAP_NAMES", spv::spirvbin_t::MAP_NAMES );
+        _NAN_EXPORT_NUMBER( remap, "MAP_FUNCS", spv::spirvbin_t::MAP_FUNCS );
+        _NAN_EXPORT_NUMBER( remap, "DCE_FUNCS", spv::spirvbin_t::DCE_FUNCS );
+        _NAN_EXPORT_NUMBER( remap, "DCE_VARS", spv::spirvbin_t::DCE_VARS );
+        _NAN_EXPORT_NUMBER( remap, "DCE_TYPES", spv::spirvbin_t::DCE_TYPES );
+        _NAN_EXPORT_NUMBER( remap, "OPT_LOADSTORE", spv::spirvbin_t::OPT_LOADSTORE );
+        _NAN_EXPORT_NUMBER( remap, "OPT_FWD_LS", spv::spirvbin_t::OPT_FWD_LS );
+        _NAN_EXPORT_NUMBER( remap, "MAP_ALL", spv::spirvbin_t::MAP_ALL );
+        _NAN_EXPORT_NUMBER( remap, "DCE_ALL", spv::spirvbin_t::DCE_ALL );
+        _NAN_EXPORT_NUMBER( remap, "OPT_ALL", spv::spirvbin_t::OPT_ALL );
+        _NAN_EXPORT_NUMBER( remap, "DO_EVERYTHING", spv::spirvbin_t::DO_EVERYTHING );
+
+        Nan::Set( target, _V8S("REMAP"), remap );
+
+
         NAN_EXPORT( target, private_finalizeProcess );
+        NAN_EXPORT( target, compileAsync );
+        NAN_EXPORT( target, compileProgramsAsync );
+        NAN_EXPORT( target, remapAsync );
+        NAN_EXPORT( target, remapBatchAsync );
+
+
+        // remaps run directly on libuv worker threads, so the remapper's shared state must be set up first
+        Utils::initializeSpirvRemapper();
 
 
         g_taskQueue.start();
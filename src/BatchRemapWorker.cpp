@@ -0,0 +1,74 @@
+#include "BatchRemapWorker.h"
+
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nan.h>
+
+#include "NanUtils.h"
+#include "TypedArrayUtils.h"
+
+namespace NodeGLSLCompiler {
+
+    BatchRemapWorker::BatchRemapWorker(
+            Nan::Callback* callback,
+            std::vector< std::vector<std::uint32_t> >&& modules,
+            std::uint32_t remapOptions,
+            bool shareTypes,
+            WorkerPool& pool,
+            int maxThreads )
+            :   Nan::AsyncWorker( callback ),
+                _modules( std::move( modules ) ),
+                _remapper( remapOptions, shareTypes, pool, maxThreads ) {
+
+        for ( const auto& module : _modules ) {
+            _originalSizesInWords.push_back( module.size() );
+        }
+    }
+
+
+    /**
+     * Executed inside a libuv worker thread -- you must *NOT* access V8 here!
+     */
+    void BatchRemapWorker::Execute() {
+        try {
+            _remapper.remap( _modules, _errors );
+        } catch ( const std::exception& e ) {
+            SetErrorMessage( e.what() ); // the callback receives the error instead of partial results
+        } catch ( ... ) {
+            SetErrorMessage( "Unknown error while remapping the batch" );
+        }
+    }
+
+
+    void BatchRemapWorker::HandleOKCallback() {
+
+        Nan::HandleScope scope;
+
+        auto results = Nan::New<v8::Array>( (int) _modules.size() );
+
+        for ( std::size_t i = 0; i < _modules.size(); i++ ) {
+
+            auto result = Nan::New<v8::Object>();
+
+            if ( _errors[ i ].empty() ) {
+                const double sizeDelta =
+                    ( (double) _modules[ i ].size() - (double) _originalSizesInWords[ i ] ) * sizeof( std::uint32_t );
+
+                Nan::Set( result, _V8S("spirv"), Utils::newUint32Array( std::move( _modules[ i ] ) ) );
+                Nan::Set( result, _V8S("sizeDelta"), Nan::New<v8::Number>( sizeDelta ) );
+            } else {
+                Nan::Set( result, _V8S("error"), Nan::Error( _errors[ i ].c_str() ) );
+            }
+
+            Nan::Set( results, (uint32_t) i, result );
+        }
+
+        v8::Local<v8::Value> argv[] = { Nan::Null(), results };
+        callback->Call( 2, argv );
+    }
+
+} // namespace
@@ -0,0 +1,59 @@
+#ifndef _NodeGLSLCompiler_src_BatchRemapWorker_h_
+#define _NodeGLSLCompiler_src_BatchRemapWorker_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <nan.h>
+
+#include "BatchRemapper.h"
+#include "WorkerPool.h"
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * libuv async worker that remaps a batch of SPIR-V modules with a BatchRemapper.
+     *
+     * The callback is invoked with (err, results), where results holds one object per module, in the same order as
+     * the modules:
+     *  {
+     *      spirv: Uint32Array,     // the remapped module (absent if this module failed)
+     *      sizeDelta: Number,      // change in module size, in bytes (absent if this module failed)
+     *      error: Error            // (only present if this module failed)
+     *  }
+     */
+    class BatchRemapWorker : public Nan::AsyncWorker {
+    public:
+        /**
+         * Initializes a new instance of the BatchRemapWorker class.
+         * @param callback The callback to execute upon completion of the batch.
+         * @param modules The SPIR-V modules to remap (the worker takes ownership).
+         * @param remapOptions A combination of spv::spirvbin_t::Options flags.
+         * @param shareTypes If true, type/constant IDs are made consistent across the batch.
+         * @param pool The pool whose threads share the work.
+         * @param maxThreads The maximum number of threads to remap on.
+         */
+        BatchRemapWorker(
+            Nan::Callback* callback,
+            std::vector< std::vector<std::uint32_t> >&& modules,
+            std::uint32_t remapOptions,
+            bool shareTypes,
+            WorkerPool& pool,
+            int maxThreads );
+
+        virtual void Execute() override;
+
+    protected:
+        virtual void HandleOKCallback() override;
+
+    private:
+        std::vector< std::vector<std::uint32_t> > _modules;
+        std::vector<std::size_t> _originalSizesInWords;
+        std::vector<std::string> _errors;
+        BatchRemapper _remapper;
+    };
+
+} // namespace
+
+#endif // header guard
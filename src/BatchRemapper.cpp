@@ -0,0 +1,79 @@
+#include "BatchRemapper.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SpirvUtils.h"
+#include "WorkerPool.h"
+
+#include "glslang/SPIRV/SPVRemapper.h"
+
+namespace NodeGLSLCompiler {
+
+    BatchRemapper::BatchRemapper( std::uint32_t remapOptions, bool shareTypes, WorkerPool& pool, int maxThreads )
+            :   _remapOptions( remapOptions ),
+                _shareTypes( shareTypes ),
+                _pool( pool ),
+                _maxThreads( maxThreads ) {
+    }
+
+
+    void BatchRemapper::remap(
+            std::vector< std::vector<std::uint32_t> >& modules,
+            std::vector<std::string>& outErrors ) {
+
+        outErrors.assign( modules.size(), std::string() );
+
+        if ( ! _shareTypes ) {
+            _pool.parallelFor( modules.size(), _maxThreads, [&]( std::size_t i ) {
+                Utils::remapSpirv( modules[ i ], _remapOptions, outErrors[ i ] );
+            });
+            return;
+        }
+
+
+        // Pass 1 (parallel): strip and DCE each module, collecting its type/constant hashes. Each module keeps its
+        // own remapper instance, which carries state through to pass 2.
+
+        std::vector<spv::spirvbin_t> remappers( modules.size() );
+        std::vector< std::vector<std::uint32_t> > hashes( modules.size() );
+
+        _pool.parallelFor( modules.size(), _maxThreads, [&]( std::size_t i ) {
+            try {
+                hashes[ i ] = remappers[ i ].reduce( modules[ i ], _remapOptions );
+            } catch ( const std::exception& e ) {
+                outErrors[ i ] = e.what();
+            }
+        });
+
+
+        // Canonical IDs are assigned serially, in module order, which is what makes the output independent of the
+        // thread count
+
+        spv::spirvbin_t::canonicaltypes_t canonicalTypes;
+
+        for ( std::size_t i = 0; i < modules.size(); i++ ) {
+            if ( outErrors[ i ].empty() ) {
+                canonicalTypes.add( hashes[ i ] );
+            }
+        }
+
+
+        // Pass 2 (parallel): map IDs; the canonical table is only read from here on
+
+        _pool.parallelFor( modules.size(), _maxThreads, [&]( std::size_t i ) {
+            if ( ! outErrors[ i ].empty() ) {
+                return;
+            }
+
+            try {
+                remappers[ i ].remap( modules[ i ], canonicalTypes );
+            } catch ( const std::exception& e ) {
+                outErrors[ i ] = e.what();
+            }
+        });
+    }
+
+} // namespace
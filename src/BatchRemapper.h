@@ -0,0 +1,61 @@
+#ifndef _NodeGLSLCompiler_src_BatchRemapper_h_
+#define _NodeGLSLCompiler_src_BatchRemapper_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "WorkerPool.h"
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * Multi-threaded SPIR-V remapper for a batch of modules.
+     *
+     * Each module is remapped independently, except that (optionally) a canonical type/constant table is shared
+     * across the batch, so that equal types and constants receive equal IDs in every module; this makes the remapped
+     * modules compress better as a set. The shared table is built in module order between the two parallel passes,
+     * so results are identical whatever the number of threads.
+     *
+     * Utils::initializeSpirvRemapper() must have been called before using this class.
+     *
+     * THREAD-SAFETY: This class is NOT thread-safe!
+     */
+    class BatchRemapper final {
+    public:
+        /**
+         * Initializes a new instance of the BatchRemapper class.
+         *
+         * @param remapOptions A combination of spv::spirvbin_t::Options flags, applied to every module.
+         * @param shareTypes If true, type/constant IDs are made consistent across the batch.
+         * @param pool The pool whose threads share the work (the calling thread takes a share too).
+         * @param maxThreads The maximum number of threads to remap on, including the calling thread.
+         */
+        BatchRemapper( std::uint32_t remapOptions, bool shareTypes, WorkerPool& pool, int maxThreads );
+
+
+        BatchRemapper( const BatchRemapper& ) = delete;
+        BatchRemapper& operator=( const BatchRemapper& ) = delete;
+
+
+        /**
+         * Remaps the modules in place.
+         *
+         * @param modules The SPIR-V modules; each one that is successfully remapped is replaced with the result.
+         * @param outErrors Out-parameter that receives one entry per module: an empty string if the module was
+         *                  remapped, otherwise the error message (and the contents of that module are unspecified).
+         * @throws Any exception that escapes a module's remapping (such as std::bad_alloc); no further modules are
+         *         started once one has thrown.
+         */
+        void remap( std::vector< std::vector<std::uint32_t> >& modules, std::vector<std::string>& outErrors );
+
+    private:
+        const std::uint32_t _remapOptions;
+        const bool _shareTypes;
+        WorkerPool& _pool;
+        const int _maxThreads;
+    };
+
+} // namespace
+
+#endif // header guard
@@ -0,0 +1,19 @@
+#ifndef _NodeGLSLCompiler_src_CompileTarget_h_
+#define _NodeGLSLCompiler_src_CompileTarget_h_
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * What a shader is compiled for. Each target parses under its own rules (the rules select glslang's built-in
+     * symbols and semantic checks), so it is the unit of front-end work: everything emitted for one target comes from
+     * a single parse.
+     */
+    enum class CompileTarget {
+        Vulkan,     // SPIR-V for Vulkan (glslangValidator -V)
+        OpenGL,     // SPIR-V for OpenGL (glslangValidator -G)
+        Validation  // GLSL validation only, with no SPIR-V (glslangValidator)
+    };
+
+} // namespace
+
+#endif // header guard
@@ -0,0 +1,38 @@
+#include "DiagnosticUtils.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include <nan.h>
+
+#include "NanUtils.h"
+
+#include "glslang/glslang/Include/InfoSink.h"
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    v8::Local<v8::Array> newDiagnosticsArray( const std::vector<glslang::TDiagnostic>& diagnostics ) {
+
+        Nan::EscapableHandleScope scope;
+
+        auto array = Nan::New<v8::Array>( (int) diagnostics.size() );
+        for ( std::size_t i = 0; i < diagnostics.size(); i++ ) {
+            const glslang::TDiagnostic& diagnostic = diagnostics[ i ];
+
+            auto object = Nan::New<v8::Object>();
+            Nan::Set( object, _V8S("severity"), Nan::New<v8::Number>( (int) diagnostic.severity ) );
+            Nan::Set( object, _V8S("file"), _V8S( diagnostic.name ) );
+            Nan::Set( object, _V8S("string"), Nan::New<v8::Number>( diagnostic.string ) );
+            Nan::Set( object, _V8S("line"), Nan::New<v8::Number>( diagnostic.line ) );
+            Nan::Set( object, _V8S("column"), Nan::New<v8::Number>( diagnostic.column ) );
+            Nan::Set( object, _V8S("reason"), _V8S( diagnostic.reason ) );
+            Nan::Set( object, _V8S("token"), _V8S( diagnostic.token ) );
+            Nan::Set( object, _V8S("extraInfo"), _V8S( diagnostic.extraInfo ) );
+            Nan::Set( array, (std::uint32_t) i, object );
+        }
+
+        return scope.Escape( array );
+    }
+
+}} // namespace
@@ -0,0 +1,25 @@
+#ifndef _NodeGLSLCompiler_src_DiagnosticUtils_h_
+#define _NodeGLSLCompiler_src_DiagnosticUtils_h_
+
+#include <vector>
+
+#include <nan.h>
+
+#include "glslang/glslang/Include/InfoSink.h"
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    /**
+     * Converts compile diagnostics to a JS array of { severity, file, string, line, column, reason, token, extraInfo }
+     * objects, where severity is a SEVERITY value, and file is the empty string if the source string has no name.
+     *
+     * Must be called on the V8 thread, inside a HandleScope.
+     *
+     * @param diagnostics The diagnostics.
+     * @return The new array.
+     */
+    v8::Local<v8::Array> newDiagnosticsArray( const std::vector<glslang::TDiagnostic>& diagnostics );
+
+}} // namespace
+
+#endif // header guard
@@ -4,6 +4,9 @@
 
 #include "glslang/glslang/Public/ShaderLang.h"
 
+#include "CompileTarget.h"
+#include "Options.h"
+
 
 namespace NodeGLSLCompiler { namespace Utils {
 
@@ -35,4 +38,32 @@ namespace NodeGLSLCompiler { namespace Utils {
         return true;
     }
 
+
+    EShMessages getTargetRules( CompileTarget target ) {
+
+        switch ( target ) {
+            case CompileTarget::Vulkan:
+                return (EShMessages)( EShMsgSpvRules | EShMsgVulkanRules );
+
+            case CompileTarget::OpenGL:
+                return EShMsgSpvRules;
+
+            case CompileTarget::Validation:
+            default:
+                return EShMsgDefault;
+        }
+    }
+
+
+    EShMessages getMessages( CompileTarget target, const Options& options ) {
+
+        EShMessages messages = getTargetRules( target );
+
+        if ( options.suppressWarnings ) {
+            messages = (EShMessages)( messages | EShMsgSuppressWarnings );
+        }
+
+        return messages;
+    }
+
 }} // namespace
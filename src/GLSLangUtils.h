@@ -5,6 +5,9 @@
 
 #include "glslang/glslang/Public/ShaderLang.h"
 
+#include "CompileTarget.h"
+#include "Options.h"
+
 namespace NodeGLSLCompiler { namespace Utils {
 
     /**
@@ -17,6 +20,23 @@ namespace NodeGLSLCompiler { namespace Utils {
      */
     bool getStageFromFileExtension( const std::string& filePath, ::EShLanguage& outStage );
 
+    /**
+     * Gets the rules a target parses and links under (matching glslangValidator -V, -G, and plain validation).
+     *
+     * @param target The target.
+     * @return The glslang message flags that select the target's rules.
+     */
+    ::EShMessages getTargetRules( CompileTarget target );
+
+    /**
+     * Gets the message flags to compile under: the target's rules, plus any that the options select.
+     *
+     * @param target The target.
+     * @param options Compiler options.
+     * @return The glslang message flags.
+     */
+    ::EShMessages getMessages( CompileTarget target, const Options& options );
+
 }} // namespace
 
 #endif // header guard
@@ -11,13 +11,19 @@ namespace NodeGLSLCompiler {
 
         const int defaultShaderVersion;
         const int maxWorkerThreads;
+        const int maxProgramThreads; // ProgramCompiler's TShader/TProgram path runs on threads set up with glslang::InitThread
+        const int maxRemapThreads; // SPIR-V remapping doesn't touch glslang's global state, so it isn't limited like compilation
+        const bool suppressWarnings; // skip optional warnings entirely, rather than formatting them into the log
 
-        Options( int theDefaultShaderVersion = kDefaultESShaderVersion )
+        Options( int theDefaultShaderVersion = kDefaultESShaderVersion, bool theSuppressWarnings = false )
                 :   defaultShaderVersion( theDefaultShaderVersion ),
                     maxWorkerThreads(
                         1 // TODO: currently glslang only supports multi-threaded compilation on Windows (see TODO notes in IndependentCompiler)
                         // std::thread::hardware_concurrency() != 0 ? std::thread::hardware_concurrency() : 1
-                    ) {
+                    ),
+                    maxProgramThreads( std::thread::hardware_concurrency() != 0 ? std::thread::hardware_concurrency() : 1 ),
+                    maxRemapThreads( std::thread::hardware_concurrency() != 0 ? std::thread::hardware_concurrency() : 1 ),
+                    suppressWarnings( theSuppressWarnings ) {
         }
     };
 
@@ -0,0 +1,355 @@
+#include "ProgramCompiler.h"
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "GLSLangUtils.h"
+#include "WorkerPool.h"
+
+#include "glslang/glslang/Include/InfoSink.h"
+#include "glslang/glslang/Include/PoolAlloc.h"
+#include "glslang/glslang/Public/ShaderLang.h"
+#include "glslang/StandAlone/ResourceLimits.h"
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * Hashes the parts of a stage source that affect its compilation (a trusted version hint is one of them, as it
+     * replaces the scan of the source for its #version directive).
+     */
+    struct StageSourceHash final {
+        std::size_t operator()( const StageSource* stage ) const {
+            std::size_t hash = std::hash<std::string>()( stage->source );
+            hash = hash * 31 + std::hash<std::string>()( stage->preamble );
+            hash = hash * 31 + (std::size_t) stage->stage;
+            hash = hash * 31 + (std::size_t) stage->defaultVersion;
+            hash = hash * 31 + (std::size_t) stage->hasVersionHint;
+
+            if ( stage->hasVersionHint ) {
+                hash = hash * 31 + (std::size_t) stage->versionHint.version;
+                hash = hash * 31 + (std::size_t) stage->versionHint.profile;
+                hash = hash * 31 + (std::size_t) stage->versionHint.notFirst;
+            }
+
+            return hash;
+        }
+    };
+
+
+    /**
+     * Whether two stage sources compile identically (the same source, stage, and options).
+     */
+    struct StageSourceEqual final {
+        bool operator()( const StageSource* a, const StageSource* b ) const {
+            return a->stage == b->stage &&
+                   a->defaultVersion == b->defaultVersion &&
+                   a->hasVersionHint == b->hasVersionHint &&
+                   ( ! a->hasVersionHint || ( a->versionHint.version == b->versionHint.version &&
+                                              a->versionHint.profile == b->versionHint.profile &&
+                                              a->versionHint.notFirst == b->versionHint.notFirst ) ) &&
+                   a->preamble == b->preamble &&
+                   a->source == b->source;
+        }
+    };
+
+
+    /**
+     * Hashes a source string (rather than its address).
+     */
+    struct SourceTextHash final {
+        std::size_t operator()( const std::string* text ) const {
+            return std::hash<std::string>()( *text );
+        }
+    };
+
+
+    /**
+     * Whether two source strings are equal (rather than the same string).
+     */
+    struct SourceTextEqual final {
+        bool operator()( const std::string* a, const std::string* b ) const {
+            return *a == *b;
+        }
+    };
+
+
+    /**
+     * The #version directive sniffed out of a distinct source text, shared by the stages compiled from it.
+     */
+    struct SniffedVersion final {
+        bool known = false;
+        glslang::TShader::VersionHint hint = {};
+    };
+
+
+    /**
+     * A distinct stage of a program (its shaders of one EShLanguage), parsed and linked once and shared by the
+     * programs that use it.
+     */
+    struct SharedStage final {
+
+        EShLanguage language = EShLangVertex;
+
+        /**
+         * The stage's shaders, as indexes into the batch's distinct stage sources, in the order the programs list
+         * them.
+         */
+        std::vector<std::size_t> sources;
+
+        std::vector< std::unique_ptr<glslang::TShader> > shaders;
+        std::vector<std::string> logs;
+        bool parsed = false;
+
+        /**
+         * Links the stage on its own; declared after the shaders, so that it's destroyed before them.
+         */
+        std::unique_ptr<glslang::TProgram> program;
+        bool linked = false;
+        std::string linkLog;
+    };
+
+
+    /**
+     * TShader and TProgram install their own pools as the thread's allocator, and don't put the previous one back.
+     * Each task restores the thread's allocator when it's done: the pool a shader installs is released with the
+     * shader, and glslang::DetachThread releases whichever allocator is current when a worker thread exits.
+     */
+    class ThreadPoolAllocatorGuard final {
+    public:
+        ThreadPoolAllocatorGuard() : _threadPool( glslang::GetThreadPoolAllocator() ) {}
+        ~ThreadPoolAllocatorGuard() { glslang::SetThreadPoolAllocator( _threadPool ); }
+
+        ThreadPoolAllocatorGuard( const ThreadPoolAllocatorGuard& ) = delete;
+        ThreadPoolAllocatorGuard& operator=( const ThreadPoolAllocatorGuard& ) = delete;
+
+    private:
+        glslang::TPoolAllocator& _threadPool;
+    };
+
+
+    ProgramCompiler::ProgramCompiler( const Options& options, CompileTarget target, WorkerPool& pool )
+            :   _resources( glslang::DefaultTBuiltInResource ),
+                _options( options ),
+                _target( target ),
+                _pool( pool ) {
+    }
+
+
+    void ProgramCompiler::compile(
+            const std::vector< std::vector<StageSource> >& programs,
+            std::vector<ProgramResult>& outResults ) {
+
+        outResults.clear();
+        outResults.resize( programs.size() );
+
+        const EShMessages messages = Utils::getMessages( _target, _options );
+
+
+        // Find the distinct stage sources
+
+        std::unordered_map<const StageSource*, std::size_t, StageSourceHash, StageSourceEqual> sourceIndexes;
+        std::vector<const StageSource*> sources;
+        std::vector< std::vector<std::size_t> > programSources( programs.size() );
+
+        for ( std::size_t p = 0; p < programs.size(); p++ ) {
+            for ( const auto& source : programs[ p ] ) {
+
+                auto inserted = sourceIndexes.insert( std::make_pair( &source, sources.size() ) );
+
+                if ( inserted.second ) {
+                    sources.push_back( &source );
+                }
+
+                programSources[ p ].push_back( inserted.first->second );
+            }
+        }
+
+
+        // Find the distinct stages (the shaders of each EShLanguage a program has), and which of them each program
+        // uses. Linking several shaders of one stage merges them into the first one's tree, so a source that is
+        // part of more than one distinct stage is parsed once for each.
+
+        std::map<std::vector<std::size_t>, std::size_t> stageIndexes;
+        std::vector< std::unique_ptr<SharedStage> > stages;
+
+        // The stages of each program, in pipeline order
+        std::vector< std::vector<std::size_t> > programStages( programs.size() );
+
+        // The stage and shader each of a program's sources was compiled as, in the order the program lists them
+        std::vector< std::vector< std::pair<std::size_t, std::size_t> > > programShaders( programs.size() );
+
+        for ( std::size_t p = 0; p < programs.size(); p++ ) {
+
+            std::vector<std::size_t> languageSources[ EShLangCount ];
+            std::size_t languageStages[ EShLangCount ];
+
+            for ( auto source : programSources[ p ] ) {
+                languageSources[ sources[ source ]->stage ].push_back( source );
+            }
+
+            for ( int language = 0; language < EShLangCount; language++ ) {
+                if ( languageSources[ language ].empty() ) {
+                    continue;
+                }
+
+                auto inserted = stageIndexes.insert( std::make_pair( languageSources[ language ], stages.size() ) );
+
+                if ( inserted.second ) {
+                    stages.emplace_back( new SharedStage() );
+                    stages.back()->language = (EShLanguage) language;
+                    stages.back()->sources = languageSources[ language ];
+                }
+
+                languageStages[ language ] = inserted.first->second;
+                programStages[ p ].push_back( inserted.first->second );
+            }
+
+            std::size_t shaderCounts[ EShLangCount ] = {};
+
+            for ( auto source : programSources[ p ] ) {
+                const EShLanguage language = sources[ source ]->stage;
+                programShaders[ p ].emplace_back( languageStages[ language ], shaderCounts[ language ]++ );
+            }
+        }
+
+
+        // Find the distinct source texts (which sources under different options can share), so that each is only
+        // scanned for its #version once; the preamble isn't part of the scan, so it doesn't matter here
+
+        std::unordered_map<const std::string*, std::size_t, SourceTextHash, SourceTextEqual> textIndexes;
+        std::vector<std::size_t> sourceTexts( sources.size() );
+
+        for ( std::size_t i = 0; i < sources.size(); i++ ) {
+            if ( ! sources[ i ]->hasVersionHint ) {
+                auto inserted = textIndexes.insert( std::make_pair( &sources[ i ]->source, textIndexes.size() ) );
+                sourceTexts[ i ] = inserted.first->second;
+            }
+        }
+
+        std::vector<SniffedVersion> sniffedVersions( textIndexes.size() );
+        std::mutex sniffedVersionsMutex;
+
+
+        // Parse each distinct stage once, and link it on its own right away, which finalizes it; from then on the
+        // programs that share it only read it
+
+        _pool.parallelFor( stages.size(), _options.maxProgramThreads, [&]( std::size_t s ) {
+
+            ThreadPoolAllocatorGuard allocatorGuard;
+
+            SharedStage& stage = *stages[ s ];
+            stage.parsed = true;
+
+            for ( auto i : stage.sources ) {
+
+                const StageSource& source = *sources[ i ];
+                const std::size_t text = sourceTexts[ i ];
+
+                const char* strings[ 1 ] = { source.source.c_str() };
+                const int lengths[ 1 ] = { (int) source.source.size() };
+
+                stage.shaders.emplace_back( new glslang::TShader( source.stage ) );
+                glslang::TShader& shader = *stage.shaders.back();
+
+                shader.setStringsWithLengths( strings, lengths, 1 );
+                shader.setPreamble( source.preamble.c_str() );
+
+                if ( source.hasVersionHint ) {
+                    shader.setVersionHint( source.versionHint );
+                } else {
+                    // A stage with the same text that's still being parsed hasn't sniffed it yet; this one sniffs too
+                    std::lock_guard<std::mutex> lock( sniffedVersionsMutex );
+                    if ( sniffedVersions[ text ].known ) {
+                        shader.setVersionHint( sniffedVersions[ text ].hint );
+                    }
+                }
+
+                stage.parsed = shader.parse( &_resources, source.defaultVersion, false, messages ) && stage.parsed;
+                stage.logs.push_back( shader.getInfoLog() );
+
+                if ( ! source.hasVersionHint ) {
+                    glslang::TShader::VersionHint hint;
+                    if ( shader.getVersionHint( hint ) ) {
+                        std::lock_guard<std::mutex> lock( sniffedVersionsMutex );
+                        sniffedVersions[ text ].known = true;
+                        sniffedVersions[ text ].hint = hint;
+                    }
+                }
+            }
+
+            if ( stage.parsed ) {
+                stage.program.reset( new glslang::TProgram() );
+
+                for ( auto& shader : stage.shaders ) {
+                    stage.program->addShader( shader.get() );
+                }
+
+                stage.linked = stage.program->link( messages );
+                stage.linkLog = stage.program->getInfoLog();
+            }
+        });
+
+
+        // Link the programs, which leaves only the check between each stage and the next (which only reads them)
+
+        _pool.parallelFor( programs.size(), _options.maxProgramThreads, [&]( std::size_t p ) {
+
+            ProgramResult& result = outResults[ p ];
+            result.success = true;
+
+            for ( const auto& shader : programShaders[ p ] ) {
+                result.log += stages[ shader.first ]->logs[ shader.second ];
+                result.success = result.success && stages[ shader.first ]->parsed;
+            }
+
+            if ( ! result.success ) {
+                return;
+            }
+
+            for ( auto s : programStages[ p ] ) {
+                result.log += stages[ s ]->linkLog;
+                result.success = result.success && stages[ s ]->linked;
+            }
+
+            if ( ! result.success ) {
+                return;
+            }
+
+            // The check's temporaries go in a pool of its own, released when it's done
+            glslang::TPoolAllocator pool;
+            ThreadPoolAllocatorGuard allocatorGuard;
+            glslang::SetThreadPoolAllocator( pool );
+
+            TInfoSink infoSink;
+            const SharedStage* producer = nullptr;
+
+            for ( auto s : programStages[ p ] ) {
+                const SharedStage& consumer = *stages[ s ];
+
+                if ( consumer.language > EShLangFragment ) {
+                    break;
+                }
+
+                if ( producer != nullptr ) {
+                    result.success = glslang::TProgram::checkStageInterface(
+                            infoSink,
+                            *producer->program->getIntermediate( producer->language ),
+                            *consumer.program->getIntermediate( consumer.language ) ) && result.success;
+                }
+
+                producer = &consumer;
+            }
+
+            result.log += infoSink.info.c_str();
+        });
+
+    }
+
+} // namespace
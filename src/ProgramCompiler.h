@@ -0,0 +1,106 @@
+#ifndef _NodeGLSLCompiler_src_ProgramCompiler_h_
+#define _NodeGLSLCompiler_src_ProgramCompiler_h_
+
+#include <string>
+#include <vector>
+
+#include "CompileTarget.h"
+#include "Options.h"
+#include "WorkerPool.h"
+
+#include "glslang/glslang/Public/ShaderLang.h"
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * The source of one stage of a program, and the options it is compiled with.
+     */
+    struct StageSource final {
+        std::string source;
+        EShLanguage stage;
+
+        /**
+         * Text (typically #defines) that is compiled ahead of the source.
+         */
+        std::string preamble;
+
+        /**
+         * The version assumed if the source has no #version directive.
+         */
+        int defaultVersion;
+
+        /**
+         * The #version directive the source opens with, if the caller knows it (only used if hasVersionHint). It's
+         * trusted, not checked against the source; see glslang::TShader::setVersionHint.
+         */
+        bool hasVersionHint;
+        glslang::TShader::VersionHint versionHint;
+    };
+
+
+    /**
+     * The outcome of compiling and linking one program.
+     */
+    struct ProgramResult final {
+
+        bool success = false;
+
+        /**
+         * The compile log of each stage (in the order the program lists them), followed by the link log.
+         */
+        std::string log;
+    };
+
+
+    /**
+     * Multi-threaded compiler for a batch of programs (the counterpart of IndependentCompiler for when stages need
+     * to be linked).
+     *
+     * Stages are identical when their shaders' sources, stages, and options all match; each distinct one is parsed
+     * and linked on its own only once, and the result (the shaders' intermediates, finalized) is shared by every
+     * program that uses it. This is what makes a batch in which one vertex shader is paired with hundreds of
+     * fragment shaders cheap. Stages that differ only in their options (say, one source under several preambles)
+     * still share the #version directive sniffed out of the source, so it's only scanned for once per batch.
+     *
+     * The distinct stages are parsed and linked across the pool's threads. Linking a program then only checks each
+     * of its stages' outputs against the inputs of the next stage in the pipeline (see
+     * glslang::TProgram::checkStageInterface), which reads the shared stages without changing them, so all of the
+     * programs are linked in parallel.
+     *
+     * THREAD-SAFETY: This class is NOT thread-safe! compile() must be called on the glslang task queue thread, and
+     *                the pool's threads must have called glslang::InitThread.
+     */
+    class ProgramCompiler final {
+    public:
+        /**
+         * Initializes a new instance of the ProgramCompiler class.
+         *
+         * @param options Compiler options.
+         * @param target The target every program is compiled and linked for.
+         * @param pool The pool whose threads share the work (the calling thread takes a share too).
+         */
+        ProgramCompiler( const Options& options, CompileTarget target, WorkerPool& pool );
+
+
+        ProgramCompiler( const ProgramCompiler& ) = delete;
+        ProgramCompiler& operator=( const ProgramCompiler& ) = delete;
+
+
+        /**
+         * Compiles and links the programs.
+         *
+         * @param programs The programs, each given as the sources of its stages.
+         * @param outResults Out-parameter that receives one result per program, in the same order.
+         */
+        void compile( const std::vector< std::vector<StageSource> >& programs, std::vector<ProgramResult>& outResults );
+
+    private:
+        const TBuiltInResource _resources;
+        const Options _options;
+        const CompileTarget _target;
+        WorkerPool& _pool;
+    };
+
+} // namespace
+
+#endif // header guard
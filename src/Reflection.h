@@ -0,0 +1,40 @@
+#ifndef _NodeGLSLCompiler_src_Reflection_h_
+#define _NodeGLSLCompiler_src_Reflection_h_
+
+#include <string>
+#include <vector>
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * The reflection tables of a linked program, consistent with the OpenGL reflection queries (the same data as
+     * glslangValidator -q). Types are GL type enums (e.g. 0x8B52 for GL_FLOAT_VEC4).
+     */
+    struct Reflection final {
+
+        struct Uniform final {
+            std::string name;
+            int type;
+            int offset;     // byte offset within its block, or -1
+            int arraySize;
+            int blockIndex; // index into blocks, or -1
+        };
+
+        struct Block final {
+            std::string name;
+            int size;       // data size in bytes
+        };
+
+        struct Attribute final {
+            std::string name;
+            int type;
+        };
+
+        std::vector<Uniform> uniforms;
+        std::vector<Block> blocks;
+        std::vector<Attribute> attributes;
+    };
+
+} // namespace
+
+#endif // header guard
@@ -0,0 +1,58 @@
+#include "ReflectionUtils.h"
+
+#include <cstdint>
+#include <cstddef>
+
+#include <nan.h>
+
+#include "NanUtils.h"
+#include "Reflection.h"
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    v8::Local<v8::Object> newReflectionObject( const Reflection& reflection ) {
+
+        Nan::EscapableHandleScope scope;
+
+        auto uniforms = Nan::New<v8::Array>( (int) reflection.uniforms.size() );
+        for ( std::size_t i = 0; i < reflection.uniforms.size(); i++ ) {
+            const Reflection::Uniform& uniform = reflection.uniforms[ i ];
+
+            auto object = Nan::New<v8::Object>();
+            Nan::Set( object, _V8S("name"), _V8S( uniform.name ) );
+            Nan::Set( object, _V8S("type"), Nan::New<v8::Number>( uniform.type ) );
+            Nan::Set( object, _V8S("offset"), Nan::New<v8::Number>( uniform.offset ) );
+            Nan::Set( object, _V8S("arraySize"), Nan::New<v8::Number>( uniform.arraySize ) );
+            Nan::Set( object, _V8S("blockIndex"), Nan::New<v8::Number>( uniform.blockIndex ) );
+            Nan::Set( uniforms, (std::uint32_t) i, object );
+        }
+
+        auto blocks = Nan::New<v8::Array>( (int) reflection.blocks.size() );
+        for ( std::size_t i = 0; i < reflection.blocks.size(); i++ ) {
+            const Reflection::Block& block = reflection.blocks[ i ];
+
+            auto object = Nan::New<v8::Object>();
+            Nan::Set( object, _V8S("name"), _V8S( block.name ) );
+            Nan::Set( object, _V8S("size"), Nan::New<v8::Number>( block.size ) );
+            Nan::Set( blocks, (std::uint32_t) i, object );
+        }
+
+        auto attributes = Nan::New<v8::Array>( (int) reflection.attributes.size() );
+        for ( std::size_t i = 0; i < reflection.attributes.size(); i++ ) {
+            const Reflection::Attribute& attribute = reflection.attributes[ i ];
+
+            auto object = Nan::New<v8::Object>();
+            Nan::Set( object, _V8S("name"), _V8S( attribute.name ) );
+            Nan::Set( object, _V8S("type"), Nan::New<v8::Number>( attribute.type ) );
+            Nan::Set( attributes, (std::uint32_t) i, object );
+        }
+
+        auto object = Nan::New<v8::Object>();
+        Nan::Set( object, _V8S("uniforms"), uniforms );
+        Nan::Set( object, _V8S("blocks"), blocks );
+        Nan::Set( object, _V8S("attributes"), attributes );
+
+        return scope.Escape( object );
+    }
+
+}} // namespace
@@ -0,0 +1,23 @@
+#ifndef _NodeGLSLCompiler_src_ReflectionUtils_h_
+#define _NodeGLSLCompiler_src_ReflectionUtils_h_
+
+#include <nan.h>
+
+#include "Reflection.h"
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    /**
+     * Converts reflection tables to a JS object: { uniforms: [ { name, type, offset, arraySize, blockIndex } ],
+     * blocks: [ { name, size } ], attributes: [ { name, type } ] }.
+     *
+     * Must be called on the V8 thread, inside a HandleScope.
+     *
+     * @param reflection The reflection tables.
+     * @return The new object.
+     */
+    v8::Local<v8::Object> newReflectionObject( const Reflection& reflection );
+
+}} // namespace
+
+#endif // header guard
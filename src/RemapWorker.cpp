@@ -0,0 +1,64 @@
+#include "RemapWorker.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nan.h>
+
+#include "NanUtils.h"
+#include "SpirvUtils.h"
+#include "TypedArrayUtils.h"
+
+namespace NodeGLSLCompiler {
+
+    RemapWorker::RemapWorker( Nan::Callback* callback, std::vector<std::uint32_t>&& spirv, std::uint32_t options )
+            :   Nan::AsyncWorker( callback ),
+                _spirv( std::move( spirv ) ),
+                _options( options ),
+                _originalSizeInWords( _spirv.size() ) {
+    }
+
+
+    /**
+     * Executed inside a libuv worker thread -- you must *NOT* access V8 here!
+     */
+    void RemapWorker::Execute() {
+
+        std::string errorMessage;
+
+        if ( ! Utils::remapSpirv( _spirv, _options, errorMessage ) ) {
+            SetErrorMessage( errorMessage.c_str() );
+        }
+    }
+
+
+    void RemapWorker::HandleOKCallback() {
+
+        Nan::HandleScope scope;
+
+        const double sizeDelta = ( (double) _spirv.size() - (double) _originalSizeInWords ) * sizeof( std::uint32_t );
+
+        auto result = Nan::New<v8::Object>();
+        Nan::Set( result, _V8S("spirv"), Utils::newUint32Array( std::move( _spirv ) ) );
+        Nan::Set( result, _V8S("sizeDelta"), Nan::New<v8::Number>( sizeDelta ) );
+
+        v8::Local<v8::Value> argv[] = { Nan::Null(), result };
+        callback->Call( 2, argv );
+    }
+
+
+    //static
+    void RemapWorker::start( v8::Local<v8::Function> callback, v8::Local<v8::Value> spirv, std::uint32_t options ) {
+
+        Nan::HandleScope scope;
+
+        Nan::TypedArrayContents<std::uint32_t> contents( spirv );
+        std::vector<std::uint32_t> words( *contents, *contents + contents.length() );
+
+        // AsyncQueueWorker takes ownership of allocated memory
+        Nan::AsyncQueueWorker( new RemapWorker( new Nan::Callback( callback ), std::move( words ), options ) );
+    }
+
+} // namespace
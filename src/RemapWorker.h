@@ -0,0 +1,52 @@
+#ifndef _NodeGLSLCompiler_src_RemapWorker_h_
+#define _NodeGLSLCompiler_src_RemapWorker_h_
+
+#include <cstdint>
+#include <vector>
+
+#include <nan.h>
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * libuv async worker that remaps (strips, canonicalizes, dead-code-eliminates) a SPIR-V module.
+     *
+     * The callback is invoked with (err, result), where result is an object:
+     *  {
+     *      spirv: Uint32Array,     // the remapped module
+     *      sizeDelta: Number       // change in module size, in bytes (negative when the module shrank)
+     *  }
+     */
+    class RemapWorker : public Nan::AsyncWorker {
+    public:
+        /**
+         * Initializes a new instance of the RemapWorker class.
+         * @param callback The callback to execute upon completion of the remap.
+         * @param spirv The SPIR-V module to remap (the worker takes ownership).
+         * @param options A combination of spv::spirvbin_t::Options flags.
+         */
+        RemapWorker( Nan::Callback* callback, std::vector<std::uint32_t>&& spirv, std::uint32_t options );
+
+        virtual void Execute() override;
+
+        /**
+         * Static helper to spin off a remap of the module in a JS Uint32Array. The words are copied before this
+         * returns, so the caller is free to modify the array while the remap runs.
+         * @param callback The callback to execute upon completion of the remap.
+         * @param spirv The SPIR-V module to remap.
+         * @param options A combination of spv::spirvbin_t::Options flags.
+         */
+        static void start( v8::Local<v8::Function> callback, v8::Local<v8::Value> spirv, std::uint32_t options );
+
+    protected:
+        virtual void HandleOKCallback() override;
+
+    private:
+        std::vector<std::uint32_t> _spirv;
+        std::uint32_t _options;
+        std::size_t _originalSizeInWords;
+    };
+
+} // namespace
+
+#endif // header guard
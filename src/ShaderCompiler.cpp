@@ -0,0 +1,162 @@
+#include "ShaderCompiler.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "GLSLangUtils.h"
+
+#include "glslang/glslang/Include/PoolAlloc.h"
+#include "glslang/glslang/Public/ShaderLang.h"
+#include "glslang/SPIRV/GlslangToSpv.h"
+#include "glslang/StandAlone/ResourceLimits.h"
+
+namespace NodeGLSLCompiler {
+
+    static_assert( std::is_same<unsigned int, std::uint32_t>::value, "glslang emits SPIR-V words as unsigned int" );
+
+
+    ShaderCompiler::ShaderCompiler( const Options& options )
+            :   _resources( glslang::DefaultTBuiltInResource ),
+                _options( options ) {
+    }
+
+
+    void ShaderCompiler::compile( const std::string& source,
+                                  EShLanguage stage,
+                                  const std::vector<CompileTarget>& targets,
+                                  const glslang::TShader::VersionHint* versionHint,
+                                  std::vector<CompileResult>& outResults ) const {
+
+        outResults.clear();
+        outResults.resize( targets.size() );
+
+        // TShader and TProgram install their own pools as the thread's allocator, and don't put the previous one
+        // back; restore it once they're gone so that later work on this thread doesn't use a deleted pool
+        glslang::TPoolAllocator& threadPool = glslang::GetThreadPoolAllocator();
+
+        const char* strings[ 1 ] = { source.c_str() };
+        const int lengths[ 1 ] = { (int) source.size() };
+
+        glslang::TShader::VersionHint hint = {};
+        bool hasHint = ( versionHint != nullptr );
+
+        if ( hasHint ) {
+            hint = *versionHint;
+        }
+
+        for ( std::size_t first = 0; first < targets.size(); first++ ) {
+
+            const CompileTarget target = targets[ first ];
+
+            // Each distinct target is parsed (by the first request for it) only once
+            bool seen = false;
+            for ( std::size_t i = 0; i < first && ! seen; i++ ) {
+                seen = ( targets[ i ] == target );
+            }
+
+            if ( seen ) {
+                continue;
+            }
+
+            const EShMessages messages = Utils::getMessages( target, _options );
+
+            glslang::TShader shader( stage );
+            shader.setStringsWithLengths( strings, lengths, 1 );
+
+            if ( hasHint ) {
+                shader.setVersionHint( hint );
+            }
+
+            bool success = shader.parse( &_resources, _options.defaultShaderVersion, false, messages );
+
+            // Later targets reuse what this parse sniffed, rather than scanning the source for it again
+            hasHint = shader.getVersionHint( hint );
+            std::string log = shader.getInfoLog();
+            const auto diagnostics = std::make_shared< const std::vector<glslang::TDiagnostic> >( shader.getDiagnostics() );
+
+            glslang::TProgram program;
+
+            if ( success ) {
+                program.addShader( &shader );
+                success = program.link( messages );
+
+                if ( ! success ) {
+                    log += program.getInfoLog();
+                }
+            }
+
+            const std::shared_ptr<const Reflection> reflection = success ? reflect( program ) : nullptr;
+
+            // Emit every result for this target from the one intermediate
+            for ( std::size_t i = first; i < targets.size(); i++ ) {
+
+                if ( targets[ i ] != target ) {
+                    continue;
+                }
+
+                CompileResult& result = outResults[ i ];
+                result.target = target;
+                result.success = success;
+                result.log = log;
+                result.diagnostics = diagnostics;
+                result.hasVersionHint = hasHint;
+                result.versionHint = hint;
+                result.reflection = reflection;
+
+                if ( success && target != CompileTarget::Validation ) {
+                    spv::SpvBuildLogger logger;
+
+                    // Size the module, then have the builder write it straight into its final allocation
+                    result.success = glslang::GlslangToSpv( *program.getIntermediate( stage ), [&result]( size_t size ) {
+                        result.spirv.reset( new std::uint32_t[ size ] );
+                        result.spirvSizeInWords = size;
+                        return result.spirv.get();
+                    }, &logger );
+
+                    result.log += logger.getAllMessages();
+                }
+            }
+        }
+
+        glslang::SetThreadPoolAllocator( threadPool );
+    }
+
+
+    //static
+    std::shared_ptr<const Reflection> ShaderCompiler::reflect( glslang::TProgram& program ) {
+
+        auto reflection = std::make_shared<Reflection>();
+
+        if ( ! program.buildReflection() ) {
+            return reflection;
+        }
+
+        for ( int i = 0; i < program.getNumLiveUniformVariables(); i++ ) {
+            reflection->uniforms.push_back( Reflection::Uniform {
+                program.getUniformName( i ),
+                program.getUniformType( i ),
+                program.getUniformBufferOffset( i ),
+                program.getUniformArraySize( i ),
+                program.getUniformBlockIndex( i ) } );
+        }
+
+        for ( int i = 0; i < program.getNumLiveUniformBlocks(); i++ ) {
+            reflection->blocks.push_back( Reflection::Block {
+                program.getUniformBlockName( i ),
+                program.getUniformBlockSize( i ) } );
+        }
+
+        for ( int i = 0; i < program.getNumLiveAttributes(); i++ ) {
+            reflection->attributes.push_back( Reflection::Attribute {
+                program.getAttributeName( i ),
+                program.getAttributeType( i ) } );
+        }
+
+        return reflection;
+    }
+
+} // namespace
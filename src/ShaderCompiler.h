@@ -0,0 +1,114 @@
+#ifndef _NodeGLSLCompiler_src_ShaderCompiler_h_
+#define _NodeGLSLCompiler_src_ShaderCompiler_h_
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CompileTarget.h"
+#include "Options.h"
+#include "Reflection.h"
+
+#include "glslang/glslang/Include/InfoSink.h"
+#include "glslang/glslang/Public/ShaderLang.h"
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * The outcome of compiling a single shader for one target.
+     */
+    struct CompileResult final {
+
+        CompileTarget target = CompileTarget::Vulkan;
+
+        bool success = false;
+
+        /**
+         * The compile log (errors and warnings), followed by the link log if linking failed.
+         */
+        std::string log;
+
+        /**
+         * The compile diagnostics in structured form (the same ones log has as text). They're shared by every result
+         * for the target.
+         */
+        std::shared_ptr<const std::vector<glslang::TDiagnostic>> diagnostics;
+
+        /**
+         * The #version directive the source opens with, which can be handed back to compile() as a hint when the
+         * same source is compiled again (only set if hasVersionHint; see glslang::TShader::getVersionHint).
+         */
+        bool hasVersionHint = false;
+        glslang::TShader::VersionHint versionHint = {};
+
+        /**
+         * The SPIR-V module (null if compilation failed, or the target is Validation). The builder serializes
+         * directly into this allocation, so it can be handed to JS as an external buffer without a copy.
+         */
+        std::unique_ptr<std::uint32_t[]> spirv;
+        std::size_t spirvSizeInWords = 0;
+
+        /**
+         * The program's reflection tables (null if compilation failed). They're built once per target during the
+         * compile, and shared by every result for that target.
+         */
+        std::shared_ptr<const Reflection> reflection;
+    };
+
+
+    /**
+     * Compiles GLSL source for a single stage to SPIR-V (or just validates it) for one or more targets.
+     *
+     * THREAD-SAFETY: glslang can only be used from a single thread on most platforms, so compile() must only be
+     *                called on the glslang task queue thread.
+     */
+    class ShaderCompiler final {
+    public:
+        /**
+         * Initializes a new instance of the ShaderCompiler class.
+         *
+         * @param options Compiler options.
+         */
+        explicit ShaderCompiler( const Options& options );
+
+
+        ShaderCompiler( const ShaderCompiler& ) = delete;
+        ShaderCompiler& operator=( const ShaderCompiler& ) = delete;
+
+
+        /**
+         * Compiles and links a shader as a single-stage program once per distinct target, and emits a result for
+         * every requested target from that program (so listing a target twice doesn't parse it twice).
+         *
+         * The #version directive is sniffed out of the source by the first parse only; the other targets are parsed
+         * with it as a hint.
+         *
+         * @param source The GLSL source.
+         * @param stage The shader stage.
+         * @param targets The targets to compile for.
+         * @param versionHint The #version directive the source opens with, if the caller knows it (e.g., from an
+         *                    earlier result for the same source); if null, it's sniffed out of the source. The hint
+         *                    is trusted, not checked against the source.
+         * @param outResults Out-parameter that receives one result per element of targets, in the same order.
+         */
+        void compile( const std::string& source,
+                      EShLanguage stage,
+                      const std::vector<CompileTarget>& targets,
+                      const glslang::TShader::VersionHint* versionHint,
+                      std::vector<CompileResult>& outResults ) const;
+
+    private:
+        /**
+         * Builds the reflection tables of a linked program.
+         */
+        static std::shared_ptr<const Reflection> reflect( glslang::TProgram& program );
+
+        const TBuiltInResource _resources;
+        const Options _options;
+    };
+
+} // namespace
+
+#endif // header guard
@@ -0,0 +1,39 @@
+#include "SpirvUtils.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "glslang/SPIRV/SPVRemapper.h"
+#include "glslang/SPIRV/doc.h"
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    void initializeSpirvRemapper() {
+
+        // Parameterize() guards itself with a plain static flag; run it before any worker thread can race it
+        spv::Parameterize();
+
+        // The default handler calls exit(), which would take down the node process
+        spv::spirvbin_t::registerErrorHandler( []( const std::string& message ) {
+            throw std::runtime_error( message );
+        });
+
+        spv::spirvbin_t::registerLogHandler( []( const std::string& ) {} );
+    }
+
+
+    bool remapSpirv( std::vector<std::uint32_t>& spirv, std::uint32_t options, std::string& outErrorMessage ) {
+
+        try {
+            spv::spirvbin_t().remap( spirv, options );
+        } catch ( const std::exception& e ) {
+            outErrorMessage = e.what();
+            return false;
+        }
+
+        return true;
+    }
+
+}} // namespace
@@ -0,0 +1,34 @@
+#ifndef _NodeGLSLCompiler_src_SpirvUtils_h_
+#define _NodeGLSLCompiler_src_SpirvUtils_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    /**
+     * Prepares the SPIR-V remapper for use from any thread: builds the shared SPIR-V opcode tables, and replaces the
+     * remapper's default error handler (which exits the process) with one that throws.
+     *
+     * Must be called once, on the main thread, before any call to remapSpirv().
+     */
+    void initializeSpirvRemapper();
+
+    /**
+     * Remaps a SPIR-V module in place (see spv::spirvbin_t::remap).
+     *
+     * THREAD-SAFETY: This function is thread-safe (provided initializeSpirvRemapper() has been called), as long as
+     *                each thread works on its own module.
+     *
+     * @param spirv The SPIR-V module; on success, replaced with the remapped module.
+     * @param options A combination of spv::spirvbin_t::Options flags.
+     * @param outErrorMessage Out-parameter that receives the error message, if remapping fails.
+     * @return true if the module was remapped; otherwise, false (outErrorMessage will be set, and the contents of
+     *              spirv are unspecified).
+     */
+    bool remapSpirv( std::vector<std::uint32_t>& spirv, std::uint32_t options, std::string& outErrorMessage );
+
+}} // namespace
+
+#endif // header guard
@@ -0,0 +1,55 @@
+#include "TypedArrayUtils.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <nan.h>
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    static v8::Local<v8::Uint32Array> wrapWords(
+            std::uint32_t* data,
+            std::size_t length,
+            Nan::FreeCallback freeCallback,
+            void* hint ) {
+
+        Nan::EscapableHandleScope scope;
+
+        auto buffer = Nan::NewBuffer(
+            reinterpret_cast<char*>( data ),
+            length * sizeof( std::uint32_t ),
+            freeCallback,
+            hint ).ToLocalChecked();
+
+        auto arrayBuffer = buffer.As<v8::Uint8Array>()->Buffer();
+
+        return scope.Escape( v8::Uint32Array::New( arrayBuffer, 0, length ) );
+    }
+
+
+    v8::Local<v8::Uint32Array> newUint32Array( std::vector<std::uint32_t>&& words ) {
+
+        // The vector lives on the heap until V8 collects the buffer that wraps its storage
+        auto heapWords = new std::vector<std::uint32_t>( std::move( words ) );
+
+        return wrapWords(
+            heapWords->data(),
+            heapWords->size(),
+            []( char*, void* hint ) { delete static_cast<std::vector<std::uint32_t>*>( hint ); },
+            heapWords );
+    }
+
+
+    v8::Local<v8::Uint32Array> newUint32Array( std::unique_ptr<std::uint32_t[]>&& words, std::size_t length ) {
+
+        return wrapWords(
+            words.release(),
+            length,
+            []( char* data, void* ) { delete[] reinterpret_cast<std::uint32_t*>( data ); },
+            nullptr );
+    }
+
+}} // namespace
@@ -0,0 +1,35 @@
+#ifndef _NodeGLSLCompiler_src_TypedArrayUtils_h_
+#define _NodeGLSLCompiler_src_TypedArrayUtils_h_
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <nan.h>
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    /**
+     * Moves a vector of words into a new JS Uint32Array without copying them: the array is backed by an external
+     * ArrayBuffer over the vector's storage, which is released when V8 collects the buffer.
+     *
+     * Must be called on the V8 thread, inside a HandleScope.
+     *
+     * @param words The words; left empty.
+     * @return The new Uint32Array.
+     */
+    v8::Local<v8::Uint32Array> newUint32Array( std::vector<std::uint32_t>&& words );
+
+    /**
+     * Moves an array of words into a new JS Uint32Array without copying them (see above).
+     *
+     * @param words The words (must not be null); released.
+     * @param length The number of words.
+     * @return The new Uint32Array.
+     */
+    v8::Local<v8::Uint32Array> newUint32Array( std::unique_ptr<std::uint32_t[]>&& words, std::size_t length );
+
+}} // namespace
+
+#endif // header guard
@@ -0,0 +1,66 @@
+#include "VersionHintUtils.h"
+
+#include <cstdint>
+
+#include <nan.h>
+
+#include "NanUtils.h"
+
+#include "glslang/glslang/Public/ShaderLang.h"
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    v8::Local<v8::Object> newVersionHintObject( const glslang::TShader::VersionHint& hint ) {
+
+        Nan::EscapableHandleScope scope;
+
+        auto object = Nan::New<v8::Object>();
+        Nan::Set( object, _V8S("version"), Nan::New<v8::Number>( hint.version ) );
+        Nan::Set( object, _V8S("profile"), Nan::New<v8::Number>( (int) hint.profile ) );
+        Nan::Set( object, _V8S("notFirst"), Nan::New<v8::Boolean>( hint.notFirst ) );
+
+        return scope.Escape( object );
+    }
+
+
+    bool getVersionHint( v8::Local<v8::Value> value, glslang::TShader::VersionHint& outHint ) {
+
+        if ( ! value->IsObject() ) {
+            return false;
+        }
+
+        auto version = Nan::Get( value.As<v8::Object>(), _V8S("version") ).ToLocalChecked();
+        auto profile = Nan::Get( value.As<v8::Object>(), _V8S("profile") ).ToLocalChecked();
+        auto notFirst = Nan::Get( value.As<v8::Object>(), _V8S("notFirst") ).ToLocalChecked();
+
+        if ( ! version->IsUint32() ) {
+            return false;
+        }
+
+        EProfile hintProfile = ENoProfile;
+
+        if ( ! profile->IsUndefined() ) {
+            if ( ! profile->IsUint32() ) {
+                return false;
+            }
+
+            hintProfile = (EProfile) Nan::To<std::uint32_t>( profile ).FromJust();
+
+            if ( hintProfile != ENoProfile && hintProfile != ECoreProfile &&
+                 hintProfile != ECompatibilityProfile && hintProfile != EEsProfile ) {
+                return false;
+            }
+        }
+
+        if ( ! notFirst->IsUndefined() && ! notFirst->IsBoolean() ) {
+            return false;
+        }
+
+        outHint.version = (int) Nan::To<std::uint32_t>( version ).FromJust();
+        outHint.profile = hintProfile;
+        outHint.notFirst = notFirst->IsTrue();
+
+        return true;
+    }
+
+}} // namespace
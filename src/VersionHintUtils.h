@@ -0,0 +1,35 @@
+#ifndef _NodeGLSLCompiler_src_VersionHintUtils_h_
+#define _NodeGLSLCompiler_src_VersionHintUtils_h_
+
+#include <nan.h>
+
+#include "glslang/glslang/Public/ShaderLang.h"
+
+namespace NodeGLSLCompiler { namespace Utils {
+
+    /**
+     * Converts a version hint to a JS { version, profile, notFirst } object, where profile is a PROFILE value.
+     *
+     * Must be called on the V8 thread, inside a HandleScope.
+     *
+     * @param hint The version hint.
+     * @return The new object.
+     */
+    v8::Local<v8::Object> newVersionHintObject( const glslang::TShader::VersionHint& hint );
+
+    /**
+     * Reads a version hint from a JS { version, profile, notFirst } object (profile and notFirst are optional, and
+     * default to PROFILE.NONE and false).
+     *
+     * Must be called on the V8 thread.
+     *
+     * @param value The object.
+     * @param outHint Out-parameter that receives the hint, if value is a well-formed one.
+     * @return true if value is a well-formed hint (in which case outHint will be set to it); otherwise, false
+     *              (outHint will remain unchanged).
+     */
+    bool getVersionHint( v8::Local<v8::Value> value, glslang::TShader::VersionHint& outHint );
+
+}} // namespace
+
+#endif // header guard
@@ -34,6 +34,7 @@ namespace NodeGLSLCompiler {
         glslang::GetGlobalLock();
 
         if ( _work.empty() ) {
+            glslang::ReleaseGlobalLock();
             return false;
         }
 
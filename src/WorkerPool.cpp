@@ -0,0 +1,155 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace NodeGLSLCompiler {
+
+    typedef std::lock_guard<std::mutex> Guard;
+
+
+    WorkerPool::WorkerPool( int numThreads, std::function<void()>&& threadInit, std::function<void()>&& threadExit )
+            :   _numThreads( numThreads > 0 ? (std::size_t) numThreads : 0 ),
+                _threadInit( std::move( threadInit ) ),
+                _threadExit( std::move( threadExit ) ),
+                _doExit( false ) {
+    }
+
+
+    WorkerPool::WorkerPool( int numThreads )
+            :   WorkerPool( numThreads, std::function<void()>(), std::function<void()>() ) {
+    }
+
+
+    WorkerPool::~WorkerPool() {
+        shutdown();
+    }
+
+
+    void WorkerPool::threadProc() {
+
+        if ( _threadInit ) {
+            _threadInit();
+        }
+
+        std::unique_lock<std::mutex> lock( _mutex );
+
+        // Work handed out before shutdown() is still done, as its parallelFor() is waiting on it
+        while ( true ) {
+
+            while ( ! _doExit && _tasks.empty() ) {
+                _condition.wait( lock );
+            }
+
+            if ( _tasks.empty() ) {
+                break;
+            }
+
+            auto task( std::move( _tasks.front() ) );
+            _tasks.pop_front();
+
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+
+        lock.unlock();
+
+        if ( _threadExit ) {
+            _threadExit();
+        }
+    }
+
+
+    void WorkerPool::parallelFor( std::size_t count, int maxThreads, const std::function<void(std::size_t)>& task ) {
+
+        std::atomic<std::size_t> next( 0 );
+
+        auto worker = [&] {
+            try {
+                for ( auto i = next++; i < count; i = next++ ) {
+                    task( i );
+                }
+            } catch ( ... ) {
+                next = count; // don't start any more tasks
+                throw;
+            }
+        };
+
+        std::size_t numHelpers = maxThreads > 1 ? (std::size_t) maxThreads - 1 : 0;
+        numHelpers = std::min( numHelpers, count > 0 ? count - 1 : 0 );
+
+        std::vector< std::future<void> > futures;
+
+        {
+            Guard lock( _mutex );
+
+            if ( ! _doExit ) {
+                while ( _threads.size() < _numThreads ) {
+                    _threads.push_back( std::thread( &WorkerPool::threadProc, this ) ); // safe to pass 'this' because our dtor joins the threads
+                }
+
+                numHelpers = std::min( numHelpers, _numThreads );
+
+                for ( std::size_t i = 0; i < numHelpers; i++ ) {
+                    auto helper = std::make_shared< std::packaged_task<void()> >( worker );
+                    futures.push_back( helper->get_future() );
+                    _tasks.push_back( [helper] { ( *helper )(); } );
+                }
+
+                _condition.notify_all();
+            }
+        }
+
+        // The calling thread takes a share of the work instead of idling
+        std::exception_ptr error;
+
+        try {
+            worker();
+        } catch ( ... ) {
+            error = std::current_exception();
+        }
+
+        // The helpers refer to this frame, so all of them must be done before returning (or throwing)
+        for ( auto& future : futures ) {
+            try {
+                future.get();
+            } catch ( ... ) {
+                if ( ! error ) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        if ( error ) {
+            std::rethrow_exception( error );
+        }
+    }
+
+
+    void WorkerPool::shutdown() {
+
+        std::vector<std::thread> threads;
+
+        {
+            Guard lock( _mutex );
+            _doExit = true;
+            threads.swap( _threads );
+            _condition.notify_all();
+        }
+
+        for ( auto& thread : threads ) {
+            thread.join();
+        }
+    }
+
+} // namespace
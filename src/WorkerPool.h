@@ -0,0 +1,84 @@
+#ifndef _NodeGLSLCompiler_src_WorkerPool_h_
+#define _NodeGLSLCompiler_src_WorkerPool_h_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NodeGLSLCompiler {
+
+    /**
+     * A fixed set of std::threads that share out the work of parallelFor() calls, so that batches reuse the same
+     * threads instead of starting their own.
+     *
+     * The threads are started by the first parallelFor(), and run until shutdown() (or destruction). Each thread
+     * runs the threadInit function (if any) as it starts and the threadExit function (if any) as it exits, which is
+     * where per-thread library state is set up and torn down.
+     *
+     * THREAD-SAFETY: This class is thread-safe; concurrent parallelFor() calls share the pool's threads.
+     */
+    class WorkerPool final {
+    public:
+        /**
+         * Initializes a new instance of the WorkerPool class.
+         *
+         * @param numThreads The number of threads in the pool (the threads calling parallelFor() also take a share
+         *                   of the work, on top of these).
+         * @param threadInit A function to run on each pool thread as it starts; may be empty.
+         * @param threadExit A function to run on each pool thread as it exits; may be empty.
+         */
+        WorkerPool( int numThreads, std::function<void()>&& threadInit, std::function<void()>&& threadExit );
+        explicit WorkerPool( int numThreads );
+        ~WorkerPool();
+
+
+        WorkerPool( const WorkerPool& ) = delete;
+        WorkerPool& operator=( const WorkerPool& ) = delete;
+
+
+        /**
+         * Calls task( i ) for each i in [0, count), spread across the calling thread and up to maxThreads - 1 of the
+         * pool's threads, and waits for completion.
+         *
+         * If a task throws, no further tasks are started, and once the tasks already running have finished, the
+         * first exception is rethrown.
+         *
+         * @param count The number of tasks.
+         * @param maxThreads The maximum number of threads to run tasks on, including the calling thread.
+         * @param task The task.
+         * @throws The first exception thrown by a task.
+         */
+        void parallelFor( std::size_t count, int maxThreads, const std::function<void(std::size_t)>& task );
+
+        /**
+         * Stops the pool's threads, once they have finished the work already handed to them, and waits for them to
+         * exit. Afterwards, parallelFor() runs every task on the calling thread.
+         *
+         * It is safe to call this method more than once.
+         */
+        void shutdown();
+
+    private:
+        void threadProc();
+
+    private:
+        const std::size_t _numThreads;
+        const std::function<void()> _threadInit;
+        const std::function<void()> _threadExit;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+
+        // protected by _mutex:
+        bool _doExit;
+        std::vector<std::thread> _threads;
+        std::list< std::function<void()> > _tasks;
+    };
+
+} // namespace
+
+#endif // header guard